@@ -2,9 +2,15 @@
 #define _CRYPTL_AES_HPP_
 
 #include <array>
+#include <cstdint>
+#include <type_traits>
 
 #include <cryptl/AES_Cipher.hpp>
+#include <cryptl/AES_Cipher32.hpp>
 #include <cryptl/AES_InvCipher.hpp>
+#include <cryptl/AES_InvCipher32.hpp>
+#include <cryptl/AES_KeyContext.hpp>
+#include <cryptl/AES_SBoxCircuit.hpp>
 #include <cryptl/BitwiseINT.hpp>
 
 namespace cryptl {
@@ -12,8 +18,17 @@ namespace cryptl {
 ////////////////////////////////////////////////////////////////////////////////
 // AES variants
 //
+// The S-boxes default to look-up tables. Managed code should select the
+// Boolean circuits instead, e.g.
+//
+//   AES_128<VAR, T, U, BITWISE,
+//           AES_SBoxCircuit<T, U, BITWISE>,
+//           AES_InvSBoxCircuit<T, U, BITWISE>>
+//
 
-template <typename VAR, typename T, typename U, typename BITWISE>
+template <typename VAR, typename T, typename U, typename BITWISE,
+          typename SBOX = AES_SBox<T, U, BITWISE>,
+          typename INVSBOX = AES_InvSBox<T, U, BITWISE>>
 class AES_All
 {
 public:
@@ -23,8 +38,9 @@ public:
     static bool isDecryption() { return false; }
 
     typedef VAR VarType;
-    typedef AES_Cipher<VAR, T, U, BITWISE> Encrypt;
-    typedef AES_InvCipher<VAR, T, U, BITWISE> Decrypt;
+    typedef AES_Cipher<VAR, T, U, BITWISE, SBOX> Encrypt;
+    typedef AES_InvCipher<VAR, T, U, BITWISE, INVSBOX, SBOX> Decrypt;
+    typedef AES_EqInvCipher<VAR, T, U, BITWISE, INVSBOX, SBOX> EqDecrypt;
     typedef Encrypt Algo;
     typedef Decrypt InvAlgo;
 
@@ -32,7 +48,9 @@ public:
     typedef typename Encrypt::KeyExpansion KeyExpansion;
 };
 
-template <typename VAR, typename T, typename U, typename BITWISE>
+template <typename VAR, typename T, typename U, typename BITWISE,
+          typename SBOX = AES_SBox<T, U, BITWISE>,
+          typename INVSBOX = AES_InvSBox<T, U, BITWISE>>
 class UNAES_All
 {
 public:
@@ -42,8 +60,9 @@ public:
     static bool isDecryption() { return true; }
 
     typedef VAR VarType;
-    typedef AES_Cipher<VAR, T, U, BITWISE> Encrypt;
-    typedef AES_InvCipher<VAR, T, U, BITWISE> Decrypt;
+    typedef AES_Cipher<VAR, T, U, BITWISE, SBOX> Encrypt;
+    typedef AES_InvCipher<VAR, T, U, BITWISE, INVSBOX, SBOX> Decrypt;
+    typedef AES_EqInvCipher<VAR, T, U, BITWISE, INVSBOX, SBOX> EqDecrypt;
     typedef Decrypt Algo;
     typedef Encrypt InvAlgo;
 
@@ -51,7 +70,9 @@ public:
     typedef typename Decrypt::KeyExpansion KeyExpansion;
 };
 
-template <typename VAR, typename T, typename U, typename BITWISE>
+template <typename VAR, typename T, typename U, typename BITWISE,
+          typename SBOX = AES_SBox<T, U, BITWISE>,
+          typename INVSBOX = AES_InvSBox<T, U, BITWISE>>
 class AES_128
 {
 public:
@@ -61,8 +82,9 @@ public:
     static bool isDecryption() { return false; }
 
     typedef VAR VarType;
-    typedef AES_Cipher<VAR, T, U, BITWISE> Encrypt;
-    typedef AES_InvCipher<VAR, T, U, BITWISE> Decrypt;
+    typedef AES_Cipher<VAR, T, U, BITWISE, SBOX> Encrypt;
+    typedef AES_InvCipher<VAR, T, U, BITWISE, INVSBOX, SBOX> Decrypt;
+    typedef AES_EqInvCipher<VAR, T, U, BITWISE, INVSBOX, SBOX> EqDecrypt;
     typedef Encrypt Algo;
     typedef Decrypt InvAlgo;
 
@@ -70,9 +92,13 @@ public:
     typedef typename Encrypt::KeyExpansion KeyExpansion;
     typedef typename KeyExpansion::Key128Type KeyType;
     typedef typename KeyExpansion::Schedule128Type ScheduleType;
+    typedef AES_KeyContext<AES_128<VAR, T, U, BITWISE, SBOX, INVSBOX>>
+        KeyContext;
 };
 
-template <typename VAR, typename T, typename U, typename BITWISE>
+template <typename VAR, typename T, typename U, typename BITWISE,
+          typename SBOX = AES_SBox<T, U, BITWISE>,
+          typename INVSBOX = AES_InvSBox<T, U, BITWISE>>
 class UNAES_128
 {
 public:
@@ -82,8 +108,9 @@ public:
     static bool isDecryption() { return true; }
 
     typedef VAR VarType;
-    typedef AES_Cipher<VAR, T, U, BITWISE> Encrypt;
-    typedef AES_InvCipher<VAR, T, U, BITWISE> Decrypt;
+    typedef AES_Cipher<VAR, T, U, BITWISE, SBOX> Encrypt;
+    typedef AES_InvCipher<VAR, T, U, BITWISE, INVSBOX, SBOX> Decrypt;
+    typedef AES_EqInvCipher<VAR, T, U, BITWISE, INVSBOX, SBOX> EqDecrypt;
     typedef Decrypt Algo;
     typedef Encrypt InvAlgo;
 
@@ -91,9 +118,13 @@ public:
     typedef typename Decrypt::KeyExpansion KeyExpansion;
     typedef typename KeyExpansion::Key128Type KeyType;
     typedef typename KeyExpansion::Schedule128Type ScheduleType;
+    typedef AES_KeyContext<AES_128<VAR, T, U, BITWISE, SBOX, INVSBOX>>
+        KeyContext;
 };
 
-template <typename VAR, typename T, typename U, typename BITWISE>
+template <typename VAR, typename T, typename U, typename BITWISE,
+          typename SBOX = AES_SBox<T, U, BITWISE>,
+          typename INVSBOX = AES_InvSBox<T, U, BITWISE>>
 class AES_192
 {
 public:
@@ -103,8 +134,9 @@ public:
     static bool isDecryption() { return false; }
 
     typedef VAR VarType;
-    typedef AES_Cipher<VAR, T, U, BITWISE> Encrypt;
-    typedef AES_InvCipher<VAR, T, U, BITWISE> Decrypt;
+    typedef AES_Cipher<VAR, T, U, BITWISE, SBOX> Encrypt;
+    typedef AES_InvCipher<VAR, T, U, BITWISE, INVSBOX, SBOX> Decrypt;
+    typedef AES_EqInvCipher<VAR, T, U, BITWISE, INVSBOX, SBOX> EqDecrypt;
     typedef Encrypt Algo;
     typedef Decrypt InvAlgo;
 
@@ -112,9 +144,13 @@ public:
     typedef typename Encrypt::KeyExpansion KeyExpansion;
     typedef typename KeyExpansion::Key192Type KeyType;
     typedef typename KeyExpansion::Schedule192Type ScheduleType;
+    typedef AES_KeyContext<AES_192<VAR, T, U, BITWISE, SBOX, INVSBOX>>
+        KeyContext;
 };
 
-template <typename VAR, typename T, typename U, typename BITWISE>
+template <typename VAR, typename T, typename U, typename BITWISE,
+          typename SBOX = AES_SBox<T, U, BITWISE>,
+          typename INVSBOX = AES_InvSBox<T, U, BITWISE>>
 class UNAES_192
 {
 public:
@@ -124,8 +160,9 @@ public:
     static bool isDecryption() { return true; }
 
     typedef VAR VarType;
-    typedef AES_Cipher<VAR, T, U, BITWISE> Encrypt;
-    typedef AES_InvCipher<VAR, T, U, BITWISE> Decrypt;
+    typedef AES_Cipher<VAR, T, U, BITWISE, SBOX> Encrypt;
+    typedef AES_InvCipher<VAR, T, U, BITWISE, INVSBOX, SBOX> Decrypt;
+    typedef AES_EqInvCipher<VAR, T, U, BITWISE, INVSBOX, SBOX> EqDecrypt;
     typedef Decrypt Algo;
     typedef Encrypt InvAlgo;
 
@@ -133,9 +170,13 @@ public:
     typedef typename Decrypt::KeyExpansion KeyExpansion;
     typedef typename KeyExpansion::Key192Type KeyType;
     typedef typename KeyExpansion::Schedule192Type ScheduleType;
+    typedef AES_KeyContext<AES_192<VAR, T, U, BITWISE, SBOX, INVSBOX>>
+        KeyContext;
 };
 
-template <typename VAR, typename T, typename U, typename BITWISE>
+template <typename VAR, typename T, typename U, typename BITWISE,
+          typename SBOX = AES_SBox<T, U, BITWISE>,
+          typename INVSBOX = AES_InvSBox<T, U, BITWISE>>
 class AES_256
 {
 public:
@@ -145,8 +186,9 @@ public:
     static bool isDecryption() { return false; }
 
     typedef VAR VarType;
-    typedef AES_Cipher<VAR, T, U, BITWISE> Encrypt;
-    typedef AES_InvCipher<VAR, T, U, BITWISE> Decrypt;
+    typedef AES_Cipher<VAR, T, U, BITWISE, SBOX> Encrypt;
+    typedef AES_InvCipher<VAR, T, U, BITWISE, INVSBOX, SBOX> Decrypt;
+    typedef AES_EqInvCipher<VAR, T, U, BITWISE, INVSBOX, SBOX> EqDecrypt;
     typedef Encrypt Algo;
     typedef Decrypt InvAlgo;
 
@@ -154,9 +196,13 @@ public:
     typedef typename Encrypt::KeyExpansion KeyExpansion;
     typedef typename KeyExpansion::Key256Type KeyType;
     typedef typename KeyExpansion::Schedule256Type ScheduleType;
+    typedef AES_KeyContext<AES_256<VAR, T, U, BITWISE, SBOX, INVSBOX>>
+        KeyContext;
 };
 
-template <typename VAR, typename T, typename U, typename BITWISE>
+template <typename VAR, typename T, typename U, typename BITWISE,
+          typename SBOX = AES_SBox<T, U, BITWISE>,
+          typename INVSBOX = AES_InvSBox<T, U, BITWISE>>
 class UNAES_256
 {
 public:
@@ -166,8 +212,9 @@ public:
     static bool isDecryption() { return true; }
 
     typedef VAR VarType;
-    typedef AES_Cipher<VAR, T, U, BITWISE> Encrypt;
-    typedef AES_InvCipher<VAR, T, U, BITWISE> Decrypt;
+    typedef AES_Cipher<VAR, T, U, BITWISE, SBOX> Encrypt;
+    typedef AES_InvCipher<VAR, T, U, BITWISE, INVSBOX, SBOX> Decrypt;
+    typedef AES_EqInvCipher<VAR, T, U, BITWISE, INVSBOX, SBOX> EqDecrypt;
     typedef Decrypt Algo;
     typedef Encrypt InvAlgo;
 
@@ -175,6 +222,8 @@ public:
     typedef typename Decrypt::KeyExpansion KeyExpansion;
     typedef typename KeyExpansion::Key256Type KeyType;
     typedef typename KeyExpansion::Schedule256Type ScheduleType;
+    typedef AES_KeyContext<AES_256<VAR, T, U, BITWISE, SBOX, INVSBOX>>
+        KeyContext;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -213,6 +262,55 @@ typedef UNAES_256<
     std::uint8_t, std::uint8_t, std::uint8_t, BitwiseINT<std::uint8_t>>
     UNAES256;
 
+////////////////////////////////////////////////////////////////////////////////
+// 32-bit column variants (see AES_Column.hpp)
+//
+// Drop-in replacements for AES128, UNAES128,... (same octet blocks, keys,
+// key contexts and modes). The state is four 32-bit columns. AddRoundKey
+// and MixColumns work on whole words, SubBytes still does four S-box
+// look-ups per word. NK is the key length in 32-bit words.
+//
+
+template <std::size_t NK, bool ENCRYPT,
+          typename SBOX = AES_SBox<std::uint8_t, std::uint8_t,
+                                   BitwiseINT<std::uint8_t>>,
+          typename INVSBOX = AES_InvSBox<std::uint8_t, std::uint8_t,
+                                         BitwiseINT<std::uint8_t>>>
+class AES_Columns
+{
+    typedef BitwiseINT<std::uint32_t> W;
+    typedef BitwiseINT<std::uint8_t> B;
+
+public:
+    AES_Columns() = default;
+
+    static bool isEncryption() { return ENCRYPT; }
+    static bool isDecryption() { return ! ENCRYPT; }
+
+    typedef std::uint8_t VarType;
+    typedef AES_Cipher32<std::uint32_t, std::uint8_t, std::uint8_t, W, B,
+                         SBOX> Encrypt;
+    typedef AES_InvCipher32<std::uint32_t, std::uint8_t, std::uint8_t, W, B,
+                            INVSBOX, SBOX> Decrypt;
+    typedef AES_EqInvCipher32<std::uint32_t, std::uint8_t, std::uint8_t, W, B,
+                              INVSBOX, SBOX> EqDecrypt;
+    typedef typename std::conditional<ENCRYPT, Encrypt, Decrypt>::type Algo;
+    typedef typename std::conditional<ENCRYPT, Decrypt, Encrypt>::type InvAlgo;
+
+    typedef std::array<std::uint8_t, 16> BlockType;
+    typedef typename Encrypt::KeyExpansion KeyExpansion;
+    typedef std::array<std::uint8_t, 4 * NK> KeyType;
+    typedef std::array<std::uint32_t, 4 * (NK + 7)> ScheduleType;
+    typedef AES_KeyContext<AES_Columns<NK, true, SBOX, INVSBOX>> KeyContext;
+};
+
+typedef AES_Columns<4, true> AES128_Columns;
+typedef AES_Columns<4, false> UNAES128_Columns;
+typedef AES_Columns<6, true> AES192_Columns;
+typedef AES_Columns<6, false> UNAES192_Columns;
+typedef AES_Columns<8, true> AES256_Columns;
+typedef AES_Columns<8, false> UNAES256_Columns;
+
 } // namespace cryptl
 
 #endif
@@ -157,54 +157,28 @@ bool readLoop(const size_t aesBits, const string& blockMode)
                 }
 
             } else if (decryptMode) {
-                if ("ECB" == blockMode || "CBC" == blockMode) {
-                    switch (aesBits) {
-                    case (128) :
-                        result = runCipher<UNAES128>(blockMode,
-                                                     key,
-                                                     IV,
-                                                     ciphertext,
-                                                     plaintext);
-                        break;
-                    case (192) :
-                        result = runCipher<UNAES192>(blockMode,
-                                                     key,
-                                                     IV,
-                                                     ciphertext,
-                                                     plaintext);
-                        break;
-                    case (256) :
-                        result = runCipher<UNAES256>(blockMode,
-                                                     key,
-                                                     IV,
-                                                     ciphertext,
-                                                     plaintext);
-                        break;
-                    }
-                } else if ("OFB" == blockMode || "CFB" == blockMode) {
-                    switch (aesBits) {
-                    case (128) :
-                        result = runCipher<AES128>(blockMode,
-                                                   key,
-                                                   IV,
-                                                   ciphertext,
-                                                   plaintext);
-                        break;
-                    case (192) :
-                        result = runCipher<AES192>(blockMode,
-                                                   key,
-                                                   IV,
-                                                   ciphertext,
-                                                   plaintext);
-                        break;
-                    case (256) :
-                        result = runCipher<AES256>(blockMode,
-                                                   key,
-                                                   IV,
-                                                   ciphertext,
-                                                   plaintext);
-                        break;
-                    }
+                switch (aesBits) {
+                case (128) :
+                    result = runCipher<UNAES128>(blockMode,
+                                                 key,
+                                                 IV,
+                                                 ciphertext,
+                                                 plaintext);
+                    break;
+                case (192) :
+                    result = runCipher<UNAES192>(blockMode,
+                                                 key,
+                                                 IV,
+                                                 ciphertext,
+                                                 plaintext);
+                    break;
+                case (256) :
+                    result = runCipher<UNAES256>(blockMode,
+                                                 key,
+                                                 IV,
+                                                 ciphertext,
+                                                 plaintext);
+                    break;
                 }
 
             } else {
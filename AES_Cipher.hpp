@@ -25,13 +25,15 @@ namespace cryptl {
 // 5.1 Cipher
 //
 
-template <typename VAR, typename T, typename U, typename BITWISE>
+// SBOX is AES_SBox (look-up table) or AES_SBoxCircuit (Boolean circuit)
+template <typename VAR, typename T, typename U, typename BITWISE,
+          typename SBOX = AES_SBox<T, U, BITWISE>>
 class AES_Cipher
 {
 public:
     typedef VAR VarType;
     typedef std::array<VAR, 16> BlockType;
-    typedef AES_KeyExpansion<VAR, T, U, BITWISE> KeyExpansion;
+    typedef AES_KeyExpansion<VAR, T, U, BITWISE, SBOX> KeyExpansion;
 
     AES_Cipher() = default;
 
@@ -56,6 +58,40 @@ public:
         encrypt(in, out, w);
     }
 
+    // L independent blocks with their own key schedules, the rounds are
+    // interleaved so the latencies of the blocks overlap (only the first n
+    // lanes are used)
+    template <std::size_t L, std::size_t WSZ>
+    void lanes(const std::array<std::array<VAR, 16>, L>& in,
+               std::array<std::array<VAR, 16>, L>& out,
+               const std::array<const std::array<VAR, WSZ>*, L>& w,
+               const std::size_t n = L) const
+    {
+        const auto Nr = WSZ / 16 - 1;
+
+        auto state = in;
+
+        for (std::size_t k = 0; k < n; ++k)
+            AddRoundKey(state[k], *w[k], 0);
+
+        for (std::size_t round = 1; round < Nr; ++round) {
+            for (std::size_t k = 0; k < n; ++k) {
+                SubBytes(state[k]);
+                ShiftRows(state[k]);
+                MixColumns(state[k]);
+                AddRoundKey(state[k], *w[k], 16*round);
+            }
+        }
+
+        for (std::size_t k = 0; k < n; ++k) {
+            SubBytes(state[k]);
+            ShiftRows(state[k]);
+            AddRoundKey(state[k], *w[k], 16*Nr);
+        }
+
+        out = state;
+    }
+
 private:
     // AES-128 key schedule size 176 (Nr = 10)
     // AES-192 key schedule size 208 (Nr = 12)
@@ -87,8 +123,9 @@ private:
 
     // 5.1.1 SubBytes() Transformation
     void SubBytes(std::array<VAR, 16>& state) const {
+        const SBOX sbox;
         for (auto& a : state)
-            a = m_sbox(a);
+            a = sbox(a);
     }
 
     // 5.1.2 ShiftRows() Transformation
@@ -168,8 +205,6 @@ private:
         for (std::size_t i = 0; i < 16; ++i)
             state[i] = BITWISE::XOR(state[i], w[i + offset]);
     }
-
-    const AES_SBox<T, U, BITWISE> m_sbox;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,158 @@
+#ifndef _CRYPTL_AES_CIPHER32_HPP_
+#define _CRYPTL_AES_CIPHER32_HPP_
+
+#include <array>
+#include <cstdint>
+
+#include <cryptl/AES_Column.hpp>
+#include <cryptl/AES_KeyExpansion32.hpp>
+#include <cryptl/AES_SBox.hpp>
+#include <cryptl/BitwiseINT.hpp>
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// FIPS PUB 197, NIST November 2001
+//
+// Algorithm     Key Length    Block Size   Number of Rounds
+//               (Nk words)    (Nb words)   (Nr)
+//
+// AES-128       4             4            10
+// AES-192       6             4            12
+// AES-256       8             4            14
+//
+
+////////////////////////////////////////////////////////////////////////////////
+// 5.1 Cipher (32-bit columns, see AES_Column.hpp)
+//
+
+template <typename VAR, typename T, typename U,
+          typename BITWISE, typename BYTEWISE,
+          typename SBOX = AES_SBox<T, U, BYTEWISE>>
+class AES_Cipher32
+{
+public:
+    typedef VAR VarType;
+    typedef std::array<VAR, 4> BlockType;
+    typedef AES_KeyExpansion32<VAR, T, U, BITWISE, BYTEWISE, SBOX>
+        KeyExpansion;
+
+    AES_Cipher32() = default;
+
+    // AES-128
+    void operator() (const std::array<VAR, 4>& in,
+                     std::array<VAR, 4>& out,
+                     const std::array<VAR, 44>& w) const {
+        encrypt(in, out, w);
+    }
+
+    // AES-192
+    void operator() (const std::array<VAR, 4>& in,
+                     std::array<VAR, 4>& out,
+                     const std::array<VAR, 52>& w) const {
+        encrypt(in, out, w);
+    }
+
+    // AES-256
+    void operator() (const std::array<VAR, 4>& in,
+                     std::array<VAR, 4>& out,
+                     const std::array<VAR, 60>& w) const {
+        encrypt(in, out, w);
+    }
+
+    // octet blocks (unmanaged), used by the key context and modes
+    template <std::size_t WSZ>
+    void operator() (const std::array<std::uint8_t, 16>& in,
+                     std::array<std::uint8_t, 16>& out,
+                     const std::array<VAR, WSZ>& w) const {
+        std::array<VAR, 4> state;
+        aesOctetsToColumns(in, state);
+        encrypt(state, state, w);
+        aesColumnsToOctets(state, out);
+    }
+
+    // L independent octet blocks with their own key schedules, the rounds
+    // are interleaved so the latencies of the blocks overlap (only the
+    // first n lanes are used)
+    template <std::size_t L, std::size_t WSZ>
+    void lanes(const std::array<std::array<std::uint8_t, 16>, L>& in,
+               std::array<std::array<std::uint8_t, 16>, L>& out,
+               const std::array<const std::array<VAR, WSZ>*, L>& w,
+               const std::size_t n = L) const
+    {
+        const auto Nr = WSZ / 4 - 1;
+
+        const SBOX sbox;
+
+        std::array<std::array<VAR, 4>, L> state;
+
+        for (std::size_t k = 0; k < n; ++k) {
+            aesOctetsToColumns(in[k], state[k]);
+            Column::addRoundKey(state[k], *w[k], 0);
+        }
+
+        for (std::size_t round = 1; round < Nr; ++round) {
+            for (std::size_t k = 0; k < n; ++k) {
+                for (auto& a : state[k]) a = Column::subWord(sbox, a);
+                Column::shiftRows(state[k]);
+                for (auto& a : state[k]) a = Column::mixColumn(a);
+                Column::addRoundKey(state[k], *w[k], 4*round);
+            }
+        }
+
+        for (std::size_t k = 0; k < n; ++k) {
+            for (auto& a : state[k]) a = Column::subWord(sbox, a);
+            Column::shiftRows(state[k]);
+            Column::addRoundKey(state[k], *w[k], 4*Nr);
+            aesColumnsToOctets(state[k], out[k]);
+        }
+    }
+
+private:
+    typedef AES_Column<VAR, T, U, BITWISE, BYTEWISE> Column;
+
+    // AES-128 key schedule size 44 (Nr = 10)
+    // AES-192 key schedule size 52 (Nr = 12)
+    // AES-256 key schedule size 60 (Nr = 14)
+    template <std::size_t WSZ>
+    void encrypt(const std::array<VAR, 4>& in,
+                 std::array<VAR, 4>& out,
+                 const std::array<VAR, WSZ>& w) const // 4 * (Nr + 1) words
+    {
+        const auto Nr = w.size() / 4 - 1;
+
+        const SBOX sbox;
+
+        auto state = in;
+
+        Column::addRoundKey(state, w, 0);
+
+        for (std::size_t round = 1; round < Nr; ++round) {
+            for (auto& a : state) a = Column::subWord(sbox, a);
+            Column::shiftRows(state);
+            for (auto& a : state) a = Column::mixColumn(a);
+            Column::addRoundKey(state, w, 4*round);
+        }
+
+        for (auto& a : state) a = Column::subWord(sbox, a);
+        Column::shiftRows(state);
+        Column::addRoundKey(state, w, 4*Nr);
+
+        out = state;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// typedef
+//
+
+typedef AES_Cipher32<std::uint32_t,
+                     std::uint8_t,
+                     std::uint8_t,
+                     BitwiseINT<std::uint32_t>,
+                     BitwiseINT<std::uint8_t>>
+    AES_Encrypt32;
+
+} // namespace cryptl
+
+#endif
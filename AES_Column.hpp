@@ -0,0 +1,160 @@
+#ifndef _CRYPTL_AES_COLUMN_HPP_
+#define _CRYPTL_AES_COLUMN_HPP_
+
+#include <array>
+#include <cstdint>
+
+#include <cryptl/AES_InvSBox.hpp>
+#include <cryptl/AES_SBox.hpp>
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// AES on 32-bit columns
+//
+// The state is four column words. Row r of a column is byte r of the word
+// (little-endian): s[r, c] = (column[c] >> 8r) & 0xff.
+//
+// VAR is the column word type with operations BITWISE. The S-box works on
+// bytes: T and U are the S-box input and output types, BYTEWISE the byte
+// operations (for converting back to a word).
+//
+
+template <typename VAR, typename T, typename U,
+          typename BITWISE, typename BYTEWISE>
+class AES_Column
+{
+public:
+    // SubWord() or InvSubWord() with S-box object sbox
+    template <typename SBOX>
+    static VAR subWord(const SBOX& sbox, const VAR& a) {
+        VAR b = BITWISE::constant(0);
+
+        for (unsigned int r = 0; r < 4; ++r) {
+            const T x = BITWISE::xword(
+                BITWISE::AND(BITWISE::SHR(a, 8*r), BITWISE::constant(0xff)),
+                T());
+
+            b = BITWISE::OR(b, BITWISE::SHL(BYTEWISE::xword(sbox(x), VAR()),
+                                            8*r));
+        }
+
+        return b;
+    }
+
+    // multiply all four bytes by {02}
+    static VAR xtime4(const VAR& a) {
+        // high bit of each byte reduces with {1b} = x^4 + x^3 + x + 1
+        const VAR m = BITWISE::AND(BITWISE::SHR(a, 7),
+                                   BITWISE::constant(0x01010101));
+
+        const VAR r =
+            BITWISE::XOR(
+                BITWISE::XOR(BITWISE::SHL(m, 4), BITWISE::SHL(m, 3)),
+                BITWISE::XOR(BITWISE::SHL(m, 1), m));
+
+        return BITWISE::XOR(
+            BITWISE::SHL(BITWISE::AND(a, BITWISE::constant(0x7f7f7f7f)), 1),
+            r);
+    }
+
+    // 5.1.3 MixColumns() on one column
+    // b = {02}(a XOR (a >>> 8)) XOR (a >>> 8) XOR (a >>> 16) XOR (a >>> 24)
+    static VAR mixColumn(const VAR& a) {
+        const VAR
+            a8 = BITWISE::ROTR(a, 8),
+            a16 = BITWISE::ROTR(a, 16),
+            a24 = BITWISE::ROTR(a, 24);
+
+        return BITWISE::XOR(
+            BITWISE::XOR(xtime4(BITWISE::XOR(a, a8)), a8),
+            BITWISE::XOR(a16, a24));
+    }
+
+    // 5.3.3 InvMixColumns() on one column
+    // {0b}x^3 + {0d}x^2 + {09}x + {0e} = ({04}x^2 + {05}) times the
+    // MixColumns() polynomial {03}x^3 + {01}x^2 + {01}x + {02}
+    static VAR invMixColumn(const VAR& a) {
+        const VAR u = xtime4(xtime4(BITWISE::XOR(a, BITWISE::ROTR(a, 16))));
+        return mixColumn(BITWISE::XOR(a, u));
+    }
+
+    // 5.1.2 ShiftRows(), row r of column c comes from column c + r
+    static void shiftRows(std::array<VAR, 4>& state) {
+        const VAR
+            m0 = BITWISE::constant(0x000000ff),
+            m1 = BITWISE::constant(0x0000ff00),
+            m2 = BITWISE::constant(0x00ff0000),
+            m3 = BITWISE::constant(0xff000000);
+
+        const auto s = state;
+        for (std::size_t c = 0; c < 4; ++c) {
+            state[c] =
+                BITWISE::OR(
+                    BITWISE::OR(BITWISE::AND(s[c], m0),
+                                BITWISE::AND(s[(c + 1) % 4], m1)),
+                    BITWISE::OR(BITWISE::AND(s[(c + 2) % 4], m2),
+                                BITWISE::AND(s[(c + 3) % 4], m3)));
+        }
+    }
+
+    // 5.3.1 InvShiftRows(), row r of column c comes from column c - r
+    static void invShiftRows(std::array<VAR, 4>& state) {
+        const VAR
+            m0 = BITWISE::constant(0x000000ff),
+            m1 = BITWISE::constant(0x0000ff00),
+            m2 = BITWISE::constant(0x00ff0000),
+            m3 = BITWISE::constant(0xff000000);
+
+        const auto s = state;
+        for (std::size_t c = 0; c < 4; ++c) {
+            state[c] =
+                BITWISE::OR(
+                    BITWISE::OR(BITWISE::AND(s[c], m0),
+                                BITWISE::AND(s[(c + 3) % 4], m1)),
+                    BITWISE::OR(BITWISE::AND(s[(c + 2) % 4], m2),
+                                BITWISE::AND(s[(c + 1) % 4], m3)));
+        }
+    }
+
+    // 5.1.4 AddRoundKey() is one XOR per column
+    template <std::size_t N>
+    static void addRoundKey(std::array<VAR, 4>& state,
+                            const std::array<VAR, N>& w,
+                            const std::size_t offset) {
+        for (std::size_t c = 0; c < 4; ++c)
+            state[c] = BITWISE::XOR(state[c], w[c + offset]);
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// conversion between octets and columns (unmanaged)
+//
+
+template <typename VAR, std::size_t N>
+void aesOctetsToColumns(const std::array<std::uint8_t, 4 * N>& a,
+                        std::array<VAR, N>& b)
+{
+    for (std::size_t c = 0; c < N; ++c) {
+        b[c] = VAR(a[4*c])
+            | (VAR(a[4*c + 1]) << 8)
+            | (VAR(a[4*c + 2]) << 16)
+            | (VAR(a[4*c + 3]) << 24);
+    }
+}
+
+template <typename VAR, std::size_t N>
+void aesColumnsToOctets(const std::array<VAR, N>& a,
+                        std::array<std::uint8_t, 4 * N>& b)
+{
+    for (std::size_t c = 0; c < N; ++c) {
+        b[4*c] = a[c] & 0xff;
+        b[4*c + 1] = (a[c] >> 8) & 0xff;
+        b[4*c + 2] = (a[c] >> 16) & 0xff;
+        b[4*c + 3] = (a[c] >> 24) & 0xff;
+    }
+}
+
+} // namespace cryptl
+
+#endif
@@ -25,13 +25,17 @@ namespace cryptl {
 // 5.3 Inverse Cipher
 //
 
-template <typename VAR, typename T, typename U, typename BITWISE>
+// INVSBOX is AES_InvSBox (look-up table) or AES_InvSBoxCircuit
+// SBOX is the S-box for key expansion
+template <typename VAR, typename T, typename U, typename BITWISE,
+          typename INVSBOX = AES_InvSBox<T, U, BITWISE>,
+          typename SBOX = AES_SBox<T, U, BITWISE>>
 class AES_InvCipher
 {
 public:
     typedef VAR VarType;
     typedef std::array<VAR, 16> BlockType;
-    typedef AES_KeyExpansion<VAR, T, U, BITWISE> KeyExpansion;
+    typedef AES_KeyExpansion<VAR, T, U, BITWISE, SBOX> KeyExpansion;
 
     AES_InvCipher() = default;
 
@@ -56,7 +60,7 @@ public:
         decrypt(in, out, w);
     }
 
-private:
+protected:
     // AES-128 key schedule size 176 (Nr = 10)
     // AES-192 key schedule size 208 (Nr = 12)
     // AES-256 key schedule size 240 (Nr = 14)
@@ -114,8 +118,9 @@ private:
 
     // 5.3.2 InvSubBytes() Transformation
     void InvSubBytes(std::array<VAR, 16>& state) const {
+        const INVSBOX inv_sbox;
         for (auto& a : state)
-            a = m_inv_sbox(a);
+            a = inv_sbox(a);
     }
 
     // 5.3.3 InvMixColumns() Transformation
@@ -199,8 +204,127 @@ private:
         for (std::size_t i = 0; i < 16; ++i)
             state[i] = BITWISE::XOR(state[i], w[i + offset]);
     }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// 5.3.5 Equivalent Inverse Cipher
+//
+// Same sequence of transformations as the cipher. The decryption key
+// schedule dw is derived once from the expanded key w with schedule().
+//
+
+template <typename VAR, typename T, typename U, typename BITWISE,
+          typename INVSBOX = AES_InvSBox<T, U, BITWISE>,
+          typename SBOX = AES_SBox<T, U, BITWISE>>
+class AES_EqInvCipher
+    : public AES_InvCipher<VAR, T, U, BITWISE, INVSBOX, SBOX>
+{
+    typedef AES_InvCipher<VAR, T, U, BITWISE, INVSBOX, SBOX> Base;
+
+public:
+    AES_EqInvCipher() = default;
+
+    // AES-128
+    void operator() (const std::array<VAR, 16>& in,
+                     std::array<VAR, 16>& out,
+                     const std::array<VAR, 176>& dw) const {
+        decrypt(in, out, dw);
+    }
+
+    // AES-192
+    void operator() (const std::array<VAR, 16>& in,
+                     std::array<VAR, 16>& out,
+                     const std::array<VAR, 208>& dw) const {
+        decrypt(in, out, dw);
+    }
+
+    // AES-256
+    void operator() (const std::array<VAR, 16>& in,
+                     std::array<VAR, 16>& out,
+                     const std::array<VAR, 240>& dw) const {
+        decrypt(in, out, dw);
+    }
+
+    // apply InvMixColumns() to round keys 1 through Nr - 1
+    template <std::size_t WSZ>
+    void schedule(const std::array<VAR, WSZ>& w,
+                  std::array<VAR, WSZ>& dw) const
+    {
+        const auto Nr = w.size() / 16 - 1;
+
+        dw = w;
+
+        std::array<VAR, 16> roundKey;
+        for (std::size_t round = 1; round < Nr; ++round) {
+            for (std::size_t i = 0; i < 16; ++i)
+                roundKey[i] = w[i + 16*round];
+
+            Base::InvMixColumns(roundKey);
 
-    const AES_InvSBox<T, U, BITWISE> m_inv_sbox;
+            for (std::size_t i = 0; i < 16; ++i)
+                dw[i + 16*round] = roundKey[i];
+        }
+    }
+
+    // L independent blocks with their own decryption key schedules, the
+    // rounds are interleaved so the latencies of the blocks overlap (only
+    // the first n lanes are used)
+    template <std::size_t L, std::size_t WSZ>
+    void lanes(const std::array<std::array<VAR, 16>, L>& in,
+               std::array<std::array<VAR, 16>, L>& out,
+               const std::array<const std::array<VAR, WSZ>*, L>& dw,
+               const std::size_t n = L) const
+    {
+        const auto Nr = WSZ / 16 - 1;
+
+        auto state = in;
+
+        for (std::size_t k = 0; k < n; ++k)
+            Base::AddRoundKey(state[k], *dw[k], 16*Nr);
+
+        for (std::size_t round = Nr - 1; round > 0; --round) {
+            for (std::size_t k = 0; k < n; ++k) {
+                Base::InvSubBytes(state[k]);
+                Base::InvShiftRows(state[k]);
+                Base::InvMixColumns(state[k]);
+                Base::AddRoundKey(state[k], *dw[k], 16*round);
+            }
+        }
+
+        for (std::size_t k = 0; k < n; ++k) {
+            Base::InvSubBytes(state[k]);
+            Base::InvShiftRows(state[k]);
+            Base::AddRoundKey(state[k], *dw[k], 0);
+        }
+
+        out = state;
+    }
+
+private:
+    template <std::size_t WSZ>
+    void decrypt(const std::array<VAR, 16>& in,
+                 std::array<VAR, 16>& out,
+                 const std::array<VAR, WSZ>& dw) const // 16 * (Nr + 1) octets
+    {
+        const auto Nr = dw.size() / 16 - 1;
+
+        auto state = in;
+
+        Base::AddRoundKey(state, dw, 16*Nr);
+
+        for (std::size_t round = Nr - 1; round > 0; --round) {
+            Base::InvSubBytes(state);
+            Base::InvShiftRows(state);
+            Base::InvMixColumns(state);
+            Base::AddRoundKey(state, dw, 16*round);
+        }
+
+        Base::InvSubBytes(state);
+        Base::InvShiftRows(state);
+        Base::AddRoundKey(state, dw, 0);
+
+        out = state;
+    }
 };
 
 ////////////////////////////////////////////////////////////////////////////////
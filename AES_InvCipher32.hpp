@@ -0,0 +1,255 @@
+#ifndef _CRYPTL_AES_INV_CIPHER32_HPP_
+#define _CRYPTL_AES_INV_CIPHER32_HPP_
+
+#include <array>
+#include <cstdint>
+
+#include <cryptl/AES_Column.hpp>
+#include <cryptl/AES_InvSBox.hpp>
+#include <cryptl/AES_KeyExpansion32.hpp>
+#include <cryptl/AES_SBox.hpp>
+#include <cryptl/BitwiseINT.hpp>
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// FIPS PUB 197, NIST November 2001
+//
+// Algorithm     Key Length    Block Size   Number of Rounds
+//               (Nk words)    (Nb words)   (Nr)
+//
+// AES-128       4             4            10
+// AES-192       6             4            12
+// AES-256       8             4            14
+//
+
+////////////////////////////////////////////////////////////////////////////////
+// 5.3 Inverse Cipher (32-bit columns, see AES_Column.hpp)
+//
+
+template <typename VAR, typename T, typename U,
+          typename BITWISE, typename BYTEWISE,
+          typename INVSBOX = AES_InvSBox<T, U, BYTEWISE>,
+          typename SBOX = AES_SBox<T, U, BYTEWISE>>
+class AES_InvCipher32
+{
+public:
+    typedef VAR VarType;
+    typedef std::array<VAR, 4> BlockType;
+    typedef AES_KeyExpansion32<VAR, T, U, BITWISE, BYTEWISE, SBOX>
+        KeyExpansion;
+
+    AES_InvCipher32() = default;
+
+    // AES-128
+    void operator() (const std::array<VAR, 4>& in,
+                     std::array<VAR, 4>& out,
+                     const std::array<VAR, 44>& w) const {
+        decrypt(in, out, w);
+    }
+
+    // AES-192
+    void operator() (const std::array<VAR, 4>& in,
+                     std::array<VAR, 4>& out,
+                     const std::array<VAR, 52>& w) const {
+        decrypt(in, out, w);
+    }
+
+    // AES-256
+    void operator() (const std::array<VAR, 4>& in,
+                     std::array<VAR, 4>& out,
+                     const std::array<VAR, 60>& w) const {
+        decrypt(in, out, w);
+    }
+
+    // octet blocks (unmanaged)
+    template <std::size_t WSZ>
+    void operator() (const std::array<std::uint8_t, 16>& in,
+                     std::array<std::uint8_t, 16>& out,
+                     const std::array<VAR, WSZ>& w) const {
+        std::array<VAR, 4> state;
+        aesOctetsToColumns(in, state);
+        decrypt(state, state, w);
+        aesColumnsToOctets(state, out);
+    }
+
+protected:
+    typedef AES_Column<VAR, T, U, BITWISE, BYTEWISE> Column;
+
+private:
+
+    // AES-128 key schedule size 44 (Nr = 10)
+    // AES-192 key schedule size 52 (Nr = 12)
+    // AES-256 key schedule size 60 (Nr = 14)
+    template <std::size_t WSZ>
+    void decrypt(const std::array<VAR, 4>& in,
+                 std::array<VAR, 4>& out,
+                 const std::array<VAR, WSZ>& w) const // 4 * (Nr + 1) words
+    {
+        const auto Nr = w.size() / 4 - 1;
+
+        const INVSBOX inv_sbox;
+
+        auto state = in;
+
+        Column::addRoundKey(state, w, 4*Nr);
+
+        for (std::size_t round = Nr - 1; round > 0; --round) {
+            Column::invShiftRows(state);
+            for (auto& a : state) a = Column::subWord(inv_sbox, a);
+            Column::addRoundKey(state, w, 4*round);
+            for (auto& a : state) a = Column::invMixColumn(a);
+        }
+
+        Column::invShiftRows(state);
+        for (auto& a : state) a = Column::subWord(inv_sbox, a);
+        Column::addRoundKey(state, w, 0);
+
+        out = state;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// 5.3.5 Equivalent Inverse Cipher (32-bit columns)
+//
+// Same sequence of transformations as the cipher. The decryption key
+// schedule dw is derived once from the expanded key w with schedule().
+//
+
+template <typename VAR, typename T, typename U,
+          typename BITWISE, typename BYTEWISE,
+          typename INVSBOX = AES_InvSBox<T, U, BYTEWISE>,
+          typename SBOX = AES_SBox<T, U, BYTEWISE>>
+class AES_EqInvCipher32
+    : public AES_InvCipher32<VAR, T, U, BITWISE, BYTEWISE, INVSBOX, SBOX>
+{
+    typedef AES_InvCipher32<VAR, T, U, BITWISE, BYTEWISE, INVSBOX, SBOX> Base;
+    typedef typename Base::Column Column;
+
+public:
+    AES_EqInvCipher32() = default;
+
+    // AES-128
+    void operator() (const std::array<VAR, 4>& in,
+                     std::array<VAR, 4>& out,
+                     const std::array<VAR, 44>& dw) const {
+        decrypt(in, out, dw);
+    }
+
+    // AES-192
+    void operator() (const std::array<VAR, 4>& in,
+                     std::array<VAR, 4>& out,
+                     const std::array<VAR, 52>& dw) const {
+        decrypt(in, out, dw);
+    }
+
+    // AES-256
+    void operator() (const std::array<VAR, 4>& in,
+                     std::array<VAR, 4>& out,
+                     const std::array<VAR, 60>& dw) const {
+        decrypt(in, out, dw);
+    }
+
+    // octet blocks (unmanaged), used by the key context and modes
+    template <std::size_t WSZ>
+    void operator() (const std::array<std::uint8_t, 16>& in,
+                     std::array<std::uint8_t, 16>& out,
+                     const std::array<VAR, WSZ>& dw) const {
+        std::array<VAR, 4> state;
+        aesOctetsToColumns(in, state);
+        decrypt(state, state, dw);
+        aesColumnsToOctets(state, out);
+    }
+
+    // apply InvMixColumns() to round keys 1 through Nr - 1
+    template <std::size_t WSZ>
+    void schedule(const std::array<VAR, WSZ>& w,
+                  std::array<VAR, WSZ>& dw) const
+    {
+        const auto Nr = w.size() / 4 - 1;
+
+        dw = w;
+
+        for (std::size_t i = 4; i < 4*Nr; ++i)
+            dw[i] = Column::invMixColumn(w[i]);
+    }
+
+    // L independent octet blocks with their own decryption key schedules
+    // (only the first n lanes are used)
+    template <std::size_t L, std::size_t WSZ>
+    void lanes(const std::array<std::array<std::uint8_t, 16>, L>& in,
+               std::array<std::array<std::uint8_t, 16>, L>& out,
+               const std::array<const std::array<VAR, WSZ>*, L>& dw,
+               const std::size_t n = L) const
+    {
+        const auto Nr = WSZ / 4 - 1;
+
+        const INVSBOX inv_sbox;
+
+        std::array<std::array<VAR, 4>, L> state;
+
+        for (std::size_t k = 0; k < n; ++k) {
+            aesOctetsToColumns(in[k], state[k]);
+            Column::addRoundKey(state[k], *dw[k], 4*Nr);
+        }
+
+        for (std::size_t round = Nr - 1; round > 0; --round) {
+            for (std::size_t k = 0; k < n; ++k) {
+                for (auto& a : state[k]) a = Column::subWord(inv_sbox, a);
+                Column::invShiftRows(state[k]);
+                for (auto& a : state[k]) a = Column::invMixColumn(a);
+                Column::addRoundKey(state[k], *dw[k], 4*round);
+            }
+        }
+
+        for (std::size_t k = 0; k < n; ++k) {
+            for (auto& a : state[k]) a = Column::subWord(inv_sbox, a);
+            Column::invShiftRows(state[k]);
+            Column::addRoundKey(state[k], *dw[k], 0);
+            aesColumnsToOctets(state[k], out[k]);
+        }
+    }
+
+private:
+    template <std::size_t WSZ>
+    void decrypt(const std::array<VAR, 4>& in,
+                 std::array<VAR, 4>& out,
+                 const std::array<VAR, WSZ>& dw) const // 4 * (Nr + 1) words
+    {
+        const auto Nr = dw.size() / 4 - 1;
+
+        const INVSBOX inv_sbox;
+
+        auto state = in;
+
+        Column::addRoundKey(state, dw, 4*Nr);
+
+        for (std::size_t round = Nr - 1; round > 0; --round) {
+            for (auto& a : state) a = Column::subWord(inv_sbox, a);
+            Column::invShiftRows(state);
+            for (auto& a : state) a = Column::invMixColumn(a);
+            Column::addRoundKey(state, dw, 4*round);
+        }
+
+        for (auto& a : state) a = Column::subWord(inv_sbox, a);
+        Column::invShiftRows(state);
+        Column::addRoundKey(state, dw, 0);
+
+        out = state;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// typedef
+//
+
+typedef AES_InvCipher32<std::uint32_t,
+                        std::uint8_t,
+                        std::uint8_t,
+                        BitwiseINT<std::uint32_t>,
+                        BitwiseINT<std::uint8_t>>
+    AES_Decrypt32;
+
+} // namespace cryptl
+
+#endif
@@ -0,0 +1,154 @@
+#ifndef _CRYPTL_AES_KEY_CONTEXT_HPP_
+#define _CRYPTL_AES_KEY_CONTEXT_HPP_
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// AES key context
+//
+// Expands the key schedule once for reuse with many messages. Both the
+// encryption schedule and the equivalent inverse cipher (FIPS 197 5.3.5)
+// decryption schedule are kept, so the same context serves both directions.
+// Changing the key with rekey() is the only time the schedules are computed.
+// Stream modes only use the forward cipher and may skip the decryption
+// schedule. A context without it must not decrypt (asserted with USE_ASSERT).
+//
+// T is one of the sized AES variants (AES_128, AES_192, AES_256) or a
+// drop-in replacement (AES_VPerm, AES_Columns).
+//
+// The static lane functions work on several contexts at once with the
+// rounds of the different keys interleaved (see MultiStream.hpp). Another
+// cipher implementation only has to provide the same functions.
+//
+
+template <typename T>
+class AES_KeyContext
+{
+public:
+    typedef typename T::VarType VarType;
+    typedef typename T::BlockType BlockType;
+    typedef typename T::KeyType KeyType;
+    typedef typename T::ScheduleType ScheduleType;
+
+    AES_KeyContext() = default;
+
+    explicit AES_KeyContext(const KeyType& key,
+                            const bool withDecrypt = true) {
+        rekey(key, withDecrypt);
+    }
+
+    void rekey(const KeyType& key, const bool withDecrypt = true) {
+        m_keyExpand(key, m_encSchedule);
+
+        if (withDecrypt)
+            m_decrypt.schedule(m_encSchedule, m_decSchedule);
+
+        m_hasDecrypt = withDecrypt;
+    }
+
+    // true if the decryption schedule is expanded
+    bool hasDecrypt() const { return m_hasDecrypt; }
+
+    // zeroes both schedules, rekey() before using the context again
+    void clear() {
+        for (ScheduleType* w : { &m_encSchedule, &m_decSchedule }) {
+            // volatile, not removed as dead stores
+            volatile unsigned char* a =
+                reinterpret_cast<volatile unsigned char*>(w);
+
+            for (std::size_t i = 0; i < sizeof(ScheduleType); ++i)
+                a[i] = 0;
+        }
+
+        m_hasDecrypt = false;
+    }
+
+    void encrypt(const BlockType& in, BlockType& out) const {
+        m_encrypt(in, out, m_encSchedule);
+    }
+
+    void decrypt(const BlockType& in, BlockType& out) const {
+#ifdef USE_ASSERT
+        assert(m_hasDecrypt);
+#endif
+        m_decrypt(in, out, m_decSchedule);
+    }
+
+    // key expansion for the first n of L contexts
+    template <std::size_t L>
+    static void rekeyLanes(const std::array<const KeyType*, L>& key,
+                           const std::array<AES_KeyContext*, L>& ctx,
+                           const bool withDecrypt = true,
+                           const std::size_t n = L) {
+        std::array<ScheduleType*, L> w;
+        w.fill(nullptr);
+        for (std::size_t k = 0; k < n; ++k)
+            w[k] = &ctx[k]->m_encSchedule;
+
+        typename T::KeyExpansion().lanes(key, w, n);
+
+        for (std::size_t k = 0; k < n; ++k) {
+            if (withDecrypt)
+                ctx[k]->m_decrypt.schedule(ctx[k]->m_encSchedule,
+                                           ctx[k]->m_decSchedule);
+
+            ctx[k]->m_hasDecrypt = withDecrypt;
+        }
+    }
+
+    // forward cipher for the first n of L contexts
+    template <std::size_t L>
+    static void encryptLanes(const std::array<const AES_KeyContext*, L>& ctx,
+                             const std::array<BlockType, L>& in,
+                             std::array<BlockType, L>& out,
+                             const std::size_t n = L) {
+        std::array<const ScheduleType*, L> w;
+        w.fill(nullptr);
+        for (std::size_t k = 0; k < n; ++k)
+            w[k] = &ctx[k]->m_encSchedule;
+
+        typename T::Encrypt().lanes(in, out, w, n);
+    }
+
+    // equivalent inverse cipher for the first n of L contexts
+    template <std::size_t L>
+    static void decryptLanes(const std::array<const AES_KeyContext*, L>& ctx,
+                             const std::array<BlockType, L>& in,
+                             std::array<BlockType, L>& out,
+                             const std::size_t n = L) {
+        std::array<const ScheduleType*, L> w;
+        w.fill(nullptr);
+        for (std::size_t k = 0; k < n; ++k) {
+#ifdef USE_ASSERT
+            assert(ctx[k]->m_hasDecrypt);
+#endif
+            w[k] = &ctx[k]->m_decSchedule;
+        }
+
+        typename T::EqDecrypt().lanes(in, out, w, n);
+    }
+
+    const ScheduleType& encSchedule() const { return m_encSchedule; }
+    const ScheduleType& decSchedule() const {
+#ifdef USE_ASSERT
+        assert(m_hasDecrypt);
+#endif
+        return m_decSchedule;
+    }
+
+private:
+    typename T::KeyExpansion m_keyExpand;
+    typename T::Encrypt m_encrypt;
+    typename T::EqDecrypt m_decrypt;
+    ScheduleType m_encSchedule, m_decSchedule;
+    bool m_hasDecrypt = false;
+};
+
+} // namespace cryptl
+
+#endif
@@ -23,7 +23,8 @@ namespace cryptl {
 // 5.2 Key Expansion
 //
 
-template <typename VAR, typename T, typename U, typename BITWISE>
+template <typename VAR, typename T, typename U, typename BITWISE,
+          typename SBOX = AES_SBox<T, U, BITWISE>>
 class AES_KeyExpansion
 {
 public:
@@ -57,6 +58,26 @@ public:
         expand(key, w);
     }
 
+    // L independent keys, word by word so the latencies overlap (only the
+    // first n lanes are used)
+    template <std::size_t L, std::size_t KSZ, std::size_t WSZ>
+    void lanes(const std::array<const std::array<VAR, KSZ>*, L>& key,
+               const std::array<std::array<VAR, WSZ>*, L>& w,
+               const std::size_t n = L) const
+    {
+        const SBOX sbox;
+
+        for (std::size_t k = 0; k < n; ++k) {
+            for (std::size_t i = 0; i < KSZ; ++i)
+                (*w[k])[i] = (*key[k])[i];
+        }
+
+        for (std::size_t i = KSZ / 4; i < WSZ / 4; ++i) {
+            for (std::size_t k = 0; k < n; ++k)
+                expandWord(sbox, i, KSZ / 4, *w[k]);
+        }
+    }
+
 private:
     // AES-128 max (4(Nr + 1) - 1)/Nk - 1 is 10 - 1 = 9
     // AES-192 max (4(Nr + 1) - 1)/Nk - 1 is 8 - 1 = 7
@@ -90,45 +111,46 @@ private:
     void expand(const std::array<VAR, KSZ>& key, // 4 * Nk octets
                 std::array<VAR, WSZ>& w) const   // 16 * (Nr + 1) octets
     {
-        const std::size_t
-            Nk = key.size() / 4,
-            Nr = w.size() / 16 - 1;
-
-        for (std::size_t i = 0; i < Nk; ++i) {
-            w[4*i] = key[4*i];
-            w[4*i + 1] = key[4*i + 1];
-            w[4*i + 2] = key[4*i + 2];
-            w[4*i + 3] = key[4*i + 3];
-        }
+        const SBOX sbox;
 
-        for (std::size_t i = Nk; i < 4 * (Nr + 1); ++i) {
-            std::array<VAR, 4> temp = { w[4*(i - 1)],
-                                        w[4*(i - 1) + 1],
-                                        w[4*(i - 1) + 2],
-                                        w[4*(i - 1) + 3] };
-
-            if (0 == i % Nk) {
-                const VAR tmp = temp[0];
-                temp[0] = BITWISE::XOR(m_sbox(temp[1]), BITWISE::constant(rcon(i/Nk - 1)));
-                temp[1] = m_sbox(temp[2]);
-                temp[2] = m_sbox(temp[3]);
-                temp[3] = m_sbox(tmp);
-
-            } else if (Nk > 6 && 4 == i % Nk) {
-                temp[0] = m_sbox(temp[0]);
-                temp[1] = m_sbox(temp[1]);
-                temp[2] = m_sbox(temp[2]);
-                temp[3] = m_sbox(temp[3]);
-            }
-
-            w[4*i] = BITWISE::XOR(w[4*(i - Nk)], temp[0]);
-            w[4*i + 1] = BITWISE::XOR(w[4*(i - Nk) + 1], temp[1]);
-            w[4*i + 2] = BITWISE::XOR(w[4*(i - Nk) + 2], temp[2]);
-            w[4*i + 3] = BITWISE::XOR(w[4*(i - Nk) + 3], temp[3]);
-        }
+        for (std::size_t i = 0; i < KSZ; ++i)
+            w[i] = key[i];
+
+        for (std::size_t i = KSZ / 4; i < WSZ / 4; ++i)
+            expandWord(sbox, i, KSZ / 4, w);
     }
 
-    const AES_SBox<T, U, BITWISE> m_sbox;
+    // word i of the key schedule from the preceding words
+    template <std::size_t WSZ>
+    void expandWord(const SBOX& sbox,
+                    const std::size_t i,
+                    const std::size_t Nk,
+                    std::array<VAR, WSZ>& w) const
+    {
+        std::array<VAR, 4> temp = { w[4*(i - 1)],
+                                    w[4*(i - 1) + 1],
+                                    w[4*(i - 1) + 2],
+                                    w[4*(i - 1) + 3] };
+
+        if (0 == i % Nk) {
+            const VAR tmp = temp[0];
+            temp[0] = BITWISE::XOR(sbox(temp[1]), BITWISE::constant(rcon(i/Nk - 1)));
+            temp[1] = sbox(temp[2]);
+            temp[2] = sbox(temp[3]);
+            temp[3] = sbox(tmp);
+
+        } else if (Nk > 6 && 4 == i % Nk) {
+            temp[0] = sbox(temp[0]);
+            temp[1] = sbox(temp[1]);
+            temp[2] = sbox(temp[2]);
+            temp[3] = sbox(temp[3]);
+        }
+
+        w[4*i] = BITWISE::XOR(w[4*(i - Nk)], temp[0]);
+        w[4*i + 1] = BITWISE::XOR(w[4*(i - Nk) + 1], temp[1]);
+        w[4*i + 2] = BITWISE::XOR(w[4*(i - Nk) + 2], temp[2]);
+        w[4*i + 3] = BITWISE::XOR(w[4*(i - Nk) + 3], temp[3]);
+    }
 };
 
 } // namespace cryptl
@@ -0,0 +1,145 @@
+#ifndef _CRYPTL_AES_KEY_EXPANSION32_HPP_
+#define _CRYPTL_AES_KEY_EXPANSION32_HPP_
+
+#include <array>
+#include <cstdint>
+
+#include <cryptl/AES_Column.hpp>
+#include <cryptl/AES_SBox.hpp>
+#include <cryptl/GF256.hpp>
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// FIPS PUB 197, NIST November 2001
+//
+// Algorithm     Key Length    Block Size   Number of Rounds
+//               (Nk words)    (Nb words)   (Nr)
+//
+// AES-128       4             4            10
+// AES-192       6             4            12
+// AES-256       8             4            14
+//
+
+////////////////////////////////////////////////////////////////////////////////
+// 5.2 Key Expansion (32-bit words, see AES_Column.hpp)
+//
+
+template <typename VAR, typename T, typename U,
+          typename BITWISE, typename BYTEWISE,
+          typename SBOX = AES_SBox<T, U, BYTEWISE>>
+class AES_KeyExpansion32
+{
+public:
+    typedef VAR VarType;
+
+    typedef std::array<VAR, 4> Key128Type;
+    typedef std::array<VAR, 6> Key192Type;
+    typedef std::array<VAR, 8> Key256Type;
+
+    typedef std::array<VAR, 44> Schedule128Type;
+    typedef std::array<VAR, 52> Schedule192Type;
+    typedef std::array<VAR, 60> Schedule256Type;
+
+    AES_KeyExpansion32() = default;
+
+    // AES-128
+    void operator() (const std::array<VAR, 4>& key,
+                     std::array<VAR, 44>& w) const {
+        expand(key, w);
+    }
+
+    // AES-192
+    void operator() (const std::array<VAR, 6>& key,
+                     std::array<VAR, 52>& w) const {
+        expand(key, w);
+    }
+
+    // AES-256
+    void operator() (const std::array<VAR, 8>& key,
+                     std::array<VAR, 60>& w) const {
+        expand(key, w);
+    }
+
+    // octet keys (unmanaged), used by the key context
+    void operator() (const std::array<std::uint8_t, 16>& key,
+                     std::array<VAR, 44>& w) const {
+        expandOctets<4>(key, w);
+    }
+
+    void operator() (const std::array<std::uint8_t, 24>& key,
+                     std::array<VAR, 52>& w) const {
+        expandOctets<6>(key, w);
+    }
+
+    void operator() (const std::array<std::uint8_t, 32>& key,
+                     std::array<VAR, 60>& w) const {
+        expandOctets<8>(key, w);
+    }
+
+    // octet keys for the first n of L key schedules
+    template <std::size_t L, std::size_t KSZ, std::size_t WSZ>
+    void lanes(const std::array<const std::array<std::uint8_t, KSZ>*, L>& key,
+               const std::array<std::array<VAR, WSZ>*, L>& w,
+               const std::size_t n = L) const
+    {
+        for (std::size_t k = 0; k < n; ++k)
+            (*this)(*key[k], *w[k]);
+    }
+
+private:
+    typedef AES_Column<VAR, T, U, BITWISE, BYTEWISE> Column;
+
+    // x^(i - 1) in GF(2^8) for i = 1, 2,..., 10
+    static std::uint8_t rcon(const std::size_t i) {
+        std::uint8_t a = 1;
+        for (std::size_t j = 1; j < i; ++j)
+            a = gf256::xtime(a);
+
+        return a;
+    }
+
+    // AES-128 key size 4 (Nk = 4) with key schedule size 44 (Nr = 10)
+    // AES-192 key size 6 (Nk = 6) with key schedule size 52 (Nr = 12)
+    // AES-256 key size 8 (Nk = 8) with key schedule size 60 (Nr = 14)
+    template <std::size_t KSZ, std::size_t WSZ>
+    void expand(const std::array<VAR, KSZ>& key, // Nk words
+                std::array<VAR, WSZ>& w) const   // 4 * (Nr + 1) words
+    {
+        const std::size_t Nk = key.size();
+
+        const SBOX sbox;
+
+        for (std::size_t i = 0; i < Nk; ++i)
+            w[i] = key[i];
+
+        for (std::size_t i = Nk; i < w.size(); ++i) {
+            VAR temp = w[i - 1];
+
+            if (0 == i % Nk) {
+                // RotWord() moves row 1 to row 0, Rcon is in row 0
+                temp = BITWISE::XOR(
+                    Column::subWord(sbox, BITWISE::ROTR(temp, 8)),
+                    BITWISE::constant(rcon(i/Nk)));
+
+            } else if (Nk > 6 && 4 == i % Nk) {
+                temp = Column::subWord(sbox, temp);
+            }
+
+            w[i] = BITWISE::XOR(w[i - Nk], temp);
+        }
+    }
+
+    template <std::size_t KSZ, std::size_t WSZ>
+    void expandOctets(const std::array<std::uint8_t, 4 * KSZ>& key,
+                      std::array<VAR, WSZ>& w) const
+    {
+        std::array<VAR, KSZ> k;
+        aesOctetsToColumns(key, k);
+        expand(k, w);
+    }
+};
+
+} // namespace cryptl
+
+#endif
@@ -0,0 +1,231 @@
+#ifndef _CRYPTL_AES_SBOX_CIRCUIT_HPP_
+#define _CRYPTL_AES_SBOX_CIRCUIT_HPP_
+
+#include <array>
+#include <cstdint>
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// S-Box as a Boolean circuit
+//
+// Boyar and Peralta, "A depth-16 circuit for the AES S-box" (2011).
+// The byte is decomposed into bits and evaluated with 113 XOR/AND/XNOR
+// gates and no table look-up. In managed code this is far smaller than a
+// 256-entry look-up table. It is also constant time in unmanaged code.
+//
+// Selected by the SBOX/INVSBOX template parameters of AES_Cipher,
+// AES_InvCipher and AES_KeyExpansion (and the variants in AES.hpp).
+//
+
+template <typename T, typename U, typename BITWISE>
+class AES_SBoxCircuit
+{
+public:
+    AES_SBoxCircuit() = default;
+
+    U operator() (const T& idx) const {
+        std::array<T, 8> x;
+        toBits(idx, x);
+        forward(x);
+        return fromBits(x);
+    }
+
+    // x[0] is the most significant bit
+    static void toBits(const T& a, std::array<T, 8>& x) {
+        for (std::size_t i = 0; i < 8; ++i)
+            x[i] = BITWISE::AND(BITWISE::SHR(a, 7 - i), BITWISE::constant(1));
+    }
+
+    static U fromBits(const std::array<T, 8>& s) {
+        T a = s[7];
+        for (std::size_t i = 1; i < 8; ++i)
+            a = BITWISE::OR(a, BITWISE::SHL(s[7 - i], i));
+
+        return a;
+    }
+
+    // S-box in place on bits
+    static void forward(std::array<T, 8>& x) {
+        const T one = BITWISE::constant(1);
+
+        // top linear transformation
+        const T
+            y14 = BITWISE::XOR(x[3], x[5]),
+            y13 = BITWISE::XOR(x[0], x[6]),
+            y9 = BITWISE::XOR(x[0], x[3]),
+            y8 = BITWISE::XOR(x[0], x[5]),
+            t0 = BITWISE::XOR(x[1], x[2]),
+            y1 = BITWISE::XOR(t0, x[7]),
+            y4 = BITWISE::XOR(y1, x[3]),
+            y12 = BITWISE::XOR(y13, y14),
+            y2 = BITWISE::XOR(y1, x[0]),
+            y5 = BITWISE::XOR(y1, x[6]),
+            y3 = BITWISE::XOR(y5, y8),
+            t1 = BITWISE::XOR(x[4], y12),
+            y15 = BITWISE::XOR(t1, x[5]),
+            y20 = BITWISE::XOR(t1, x[1]),
+            y6 = BITWISE::XOR(y15, x[7]),
+            y10 = BITWISE::XOR(y15, t0),
+            y11 = BITWISE::XOR(y20, y9),
+            y7 = BITWISE::XOR(x[7], y11),
+            y17 = BITWISE::XOR(y10, y11),
+            y19 = BITWISE::XOR(y10, y8),
+            y16 = BITWISE::XOR(t0, y11),
+            y21 = BITWISE::XOR(y13, y16),
+            y18 = BITWISE::XOR(x[0], y16);
+
+        // shared non-linear section (GF(2^4) inversion)
+        const T
+            t2 = BITWISE::AND(y12, y15),
+            t3 = BITWISE::AND(y3, y6),
+            t4 = BITWISE::XOR(t3, t2),
+            t5 = BITWISE::AND(y4, x[7]),
+            t6 = BITWISE::XOR(t5, t2),
+            t7 = BITWISE::AND(y13, y16),
+            t8 = BITWISE::AND(y5, y1),
+            t9 = BITWISE::XOR(t8, t7),
+            t10 = BITWISE::AND(y2, y7),
+            t11 = BITWISE::XOR(t10, t7),
+            t12 = BITWISE::AND(y9, y11),
+            t13 = BITWISE::AND(y14, y17),
+            t14 = BITWISE::XOR(t13, t12),
+            t15 = BITWISE::AND(y8, y10),
+            t16 = BITWISE::XOR(t15, t12),
+            t17 = BITWISE::XOR(t4, t14),
+            t18 = BITWISE::XOR(t6, t16),
+            t19 = BITWISE::XOR(t9, t14),
+            t20 = BITWISE::XOR(t11, t16),
+            t21 = BITWISE::XOR(t17, y20),
+            t22 = BITWISE::XOR(t18, y19),
+            t23 = BITWISE::XOR(t19, y21),
+            t24 = BITWISE::XOR(t20, y18);
+
+        const T
+            t25 = BITWISE::XOR(t21, t22),
+            t26 = BITWISE::AND(t21, t23),
+            t27 = BITWISE::XOR(t24, t26),
+            t28 = BITWISE::AND(t25, t27),
+            t29 = BITWISE::XOR(t28, t22),
+            t30 = BITWISE::XOR(t23, t24),
+            t31 = BITWISE::XOR(t22, t26),
+            t32 = BITWISE::AND(t31, t30),
+            t33 = BITWISE::XOR(t32, t24),
+            t34 = BITWISE::XOR(t23, t33),
+            t35 = BITWISE::XOR(t27, t33),
+            t36 = BITWISE::AND(t24, t35),
+            t37 = BITWISE::XOR(t36, t34),
+            t38 = BITWISE::XOR(t27, t36),
+            t39 = BITWISE::AND(t29, t38),
+            t40 = BITWISE::XOR(t25, t39);
+
+        const T
+            t41 = BITWISE::XOR(t40, t37),
+            t42 = BITWISE::XOR(t29, t33),
+            t43 = BITWISE::XOR(t29, t40),
+            t44 = BITWISE::XOR(t33, t37),
+            t45 = BITWISE::XOR(t42, t41),
+            z0 = BITWISE::AND(t44, y15),
+            z1 = BITWISE::AND(t37, y6),
+            z2 = BITWISE::AND(t33, x[7]),
+            z3 = BITWISE::AND(t43, y16),
+            z4 = BITWISE::AND(t40, y1),
+            z5 = BITWISE::AND(t29, y7),
+            z6 = BITWISE::AND(t42, y11),
+            z7 = BITWISE::AND(t45, y17),
+            z8 = BITWISE::AND(t41, y10),
+            z9 = BITWISE::AND(t44, y12),
+            z10 = BITWISE::AND(t37, y3),
+            z11 = BITWISE::AND(t33, y4),
+            z12 = BITWISE::AND(t43, y13),
+            z13 = BITWISE::AND(t40, y5),
+            z14 = BITWISE::AND(t29, y2),
+            z15 = BITWISE::AND(t42, y9),
+            z16 = BITWISE::AND(t45, y14),
+            z17 = BITWISE::AND(t41, y8);
+
+        // bottom linear transformation
+        const T
+            t46 = BITWISE::XOR(z15, z16),
+            t47 = BITWISE::XOR(z10, z11),
+            t48 = BITWISE::XOR(z5, z13),
+            t49 = BITWISE::XOR(z9, z10),
+            t50 = BITWISE::XOR(z2, z12),
+            t51 = BITWISE::XOR(z2, z5),
+            t52 = BITWISE::XOR(z7, z8),
+            t53 = BITWISE::XOR(z0, z3),
+            t54 = BITWISE::XOR(z6, z7),
+            t55 = BITWISE::XOR(z16, z17),
+            t56 = BITWISE::XOR(z12, t48),
+            t57 = BITWISE::XOR(t50, t53),
+            t58 = BITWISE::XOR(z4, t46),
+            t59 = BITWISE::XOR(z3, t54),
+            t60 = BITWISE::XOR(t46, t57),
+            t61 = BITWISE::XOR(z14, t57),
+            t62 = BITWISE::XOR(t52, t58),
+            t63 = BITWISE::XOR(t49, t58),
+            t64 = BITWISE::XOR(z4, t59),
+            t65 = BITWISE::XOR(t61, t62),
+            t66 = BITWISE::XOR(z1, t63),
+            t67 = BITWISE::XOR(t64, t65);
+
+        // XNOR gates complement with XOR 1
+        x[0] = BITWISE::XOR(t59, t63);
+        x[6] = BITWISE::XOR(BITWISE::XOR(t56, t62), one);
+        x[7] = BITWISE::XOR(BITWISE::XOR(t48, t60), one);
+        x[3] = BITWISE::XOR(t53, t66);
+        x[4] = BITWISE::XOR(t51, t66);
+        x[5] = BITWISE::XOR(t47, t65);
+        x[1] = BITWISE::XOR(BITWISE::XOR(t64, x[3]), one);
+        x[2] = BITWISE::XOR(BITWISE::XOR(t55, t67), one);
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Inverse S-Box as a Boolean circuit
+//
+// With S(x) = A(x^-1) for the affine map A, the inverse is
+// A^-1(S(A^-1(y))). Only the non-linear core is shared with the S-box.
+//
+
+template <typename T, typename U, typename BITWISE>
+class AES_InvSBoxCircuit
+{
+    typedef AES_SBoxCircuit<T, U, BITWISE> SBox;
+
+public:
+    AES_InvSBoxCircuit() = default;
+
+    U operator() (const T& idx) const {
+        std::array<T, 8> x;
+        SBox::toBits(idx, x);
+        invAffine(x);
+        SBox::forward(x);
+        invAffine(x);
+        return SBox::fromBits(x);
+    }
+
+private:
+    // A^-1(b) = (b <<< 1) XOR (b <<< 3) XOR (b <<< 6) XOR {05}
+    static void invAffine(std::array<T, 8>& x) {
+        const T one = BITWISE::constant(1);
+
+        // x[i] is bit 7 - i
+        std::array<T, 8> b;
+        for (std::size_t i = 0; i < 8; ++i) {
+            b[i] = BITWISE::XOR(
+                x[(i + 1) % 8],
+                BITWISE::XOR(x[(i + 3) % 8], x[(i + 6) % 8]));
+        }
+
+        // {05} is bits 0 and 2
+        b[7] = BITWISE::XOR(b[7], one);
+        b[5] = BITWISE::XOR(b[5], one);
+
+        x = b;
+    }
+};
+
+} // namespace cryptl
+
+#endif
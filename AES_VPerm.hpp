@@ -0,0 +1,625 @@
+#ifndef _CRYPTL_AES_VPERM_HPP_
+#define _CRYPTL_AES_VPERM_HPP_
+
+#ifdef __SSSE3__
+
+#include <array>
+#include <cstdint>
+#include <tmmintrin.h>
+#include <type_traits>
+
+#include <cryptl/AES_KeyContext.hpp>
+#include <cryptl/AES_KeyExpansion.hpp>
+#include <cryptl/BitwiseINT.hpp>
+#include <cryptl/GF256.hpp>
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// AES with vector permute (SSSE3)
+//
+// Hamburg, "Accelerating AES with Vector Permute Instructions" (CHES 2009).
+// GF(2^8) is a quadratic extension of its subfield GF(2^4). An element is
+// x = i t + j t' with nibbles i, j in GF(2^4), t and t' = t + 1 the roots
+// of t^2 + t + mu. With k = i + j the norm is N = mu k^2 + i j and
+//
+//   io = j + 1/(1/i + k^-1/mu) = N/(mu k + i)
+//   jo = i + 1/(1/j + k^-1/mu) = N/(mu k + j)
+//
+// from which x^-1 = (j t + i t')/N is a GF(2)-linear function of 1/io
+// plus a GF(2)-linear function of 1/jo. Every step is a 16-entry nibble
+// table look-up (pshufb) or an XOR. 1/0 is the point at infinity, encoded
+// with the high bit set so that the next pshufb returns zero.
+//
+// The input basis change and the output affine map fold into the tables.
+// All tables are generated at compile time from GF256.hpp. There are no
+// data-dependent memory accesses or branches. Single blocks are fast, no
+// batching is needed.
+//
+// Only compiled with SSSE3 enabled (e.g. -mssse3 or -march=native).
+//
+
+namespace aes_vperm {
+
+// generator of the subfield GF(2^4) = {x : x^16 = x}, {03}^17 has order 15
+constexpr std::uint8_t G1 = gf256::pow(0x03, 17);
+constexpr std::uint8_t G2 = gf256::mul(G1, G1);
+constexpr std::uint8_t G3 = gf256::mul(G2, G1);
+
+// nibble n to subfield element in the basis 1, g, g^2, g^3
+constexpr std::uint8_t elem(const unsigned int n) {
+    return ((n & 1) ? 0x01 : 0)
+        ^ ((n & 2) ? G1 : 0)
+        ^ ((n & 4) ? G2 : 0)
+        ^ ((n & 8) ? G3 : 0);
+}
+
+// subfield element to nibble
+constexpr std::uint8_t nibble(const std::uint8_t e, const unsigned int n = 0) {
+    return (n >= 16 || elem(n) == e) ? n : nibble(e, n + 1);
+}
+
+// absolute trace of a subfield element
+constexpr std::uint8_t trace(const std::uint8_t m) {
+    return m ^ gf256::pow(m, 2) ^ gf256::pow(m, 4) ^ gf256::pow(m, 8);
+}
+
+// t^2 + t + mu is irreducible over GF(2^4) when mu has trace one
+constexpr std::uint8_t findMu(const unsigned int n = 1) {
+    return (n >= 15 || 1 == trace(elem(n))) ? elem(n) : findMu(n + 1);
+}
+
+constexpr std::uint8_t MU = findMu();
+constexpr std::uint8_t MU_INV = gf256::inv(MU);
+
+// t is a root of t^2 + t + mu, the other root is t + 1
+constexpr std::uint8_t findRoot(const unsigned int x = 0) {
+    return (x >= 255 || 0 == (gf256::mul(x, x) ^ x ^ MU))
+        ? x
+        : findRoot(x + 1);
+}
+
+constexpr std::uint8_t ROOT = findRoot();
+
+// x = i t + j t' for the nibbles of p (j high)
+constexpr std::uint8_t fromPair(const unsigned int p) {
+    return gf256::mul(elem(p & 0x0f), ROOT)
+        ^ gf256::mul(elem(p >> 4), ROOT ^ 1);
+}
+
+// coordinates (i, j) of x as nibbles, the map is GF(2)-linear so only the
+// eight basis vectors are searched
+constexpr std::uint8_t searchPair(const std::uint8_t x,
+                                  const unsigned int p = 0) {
+    return (p >= 255 || x == fromPair(p)) ? p : searchPair(x, p + 1);
+}
+
+constexpr std::uint8_t toPair(const std::uint8_t x, const unsigned int b = 0) {
+    return b >= 8
+        ? 0
+        : (((x >> b) & 1) ? searchPair(1 << b) : 0) ^ toPair(x, b + 1);
+}
+
+// 1/io and 1/jo output coefficients
+constexpr std::uint8_t COEF1 =
+    gf256::mul(1 ^ MU, ROOT ^ 1) ^ gf256::mul(MU, ROOT);
+constexpr std::uint8_t COEF2 =
+    gf256::mul(MU, ROOT ^ 1) ^ gf256::mul(1 ^ MU, ROOT);
+
+// linear part of the FIPS 197 5.1.1 affine transformation
+constexpr std::uint8_t linear(const std::uint8_t b) {
+    return gf256::affine(b) ^ 0x63;
+}
+
+// table generators, index is a nibble
+struct InputGen {
+    static constexpr std::uint8_t value(const std::uint8_t n) {
+        return toPair(n);
+    }
+};
+
+struct InputHiGen {
+    static constexpr std::uint8_t value(const std::uint8_t n) {
+        return toPair(n << 4);
+    }
+};
+
+struct InvInputGen {
+    static constexpr std::uint8_t value(const std::uint8_t n) {
+        return toPair(gf256::invAffine(n));
+    }
+};
+
+struct InvInputHiGen {
+    static constexpr std::uint8_t value(const std::uint8_t n) {
+        return toPair(gf256::invAffine(n << 4) ^ 0x05);
+    }
+};
+
+struct RecipGen {
+    static constexpr std::uint8_t value(const std::uint8_t n) {
+        return 0 == n ? 0x80 : nibble(gf256::inv(elem(n)));
+    }
+};
+
+struct RecipMuGen {
+    static constexpr std::uint8_t value(const std::uint8_t n) {
+        return 0 == n
+            ? 0x80
+            : nibble(gf256::mul(MU_INV, gf256::inv(elem(n))));
+    }
+};
+
+template <std::uint8_t COEF, bool AFFINE>
+struct OutputGen {
+    static constexpr std::uint8_t value(const std::uint8_t n) {
+        return 0 == n
+            ? 0
+            : (AFFINE ? linear(gf256::mul(gf256::inv(elem(n)), COEF))
+                      : gf256::mul(gf256::inv(elem(n)), COEF));
+    }
+};
+
+static_assert(0x0f == nibble(elem(0x0f)), "subfield basis");
+static_assert(0 == (gf256::mul(ROOT, ROOT) ^ ROOT ^ MU), "root");
+static_assert(0x8f == toPair(fromPair(0x8f)), "basis change");
+
+} // namespace aes_vperm
+
+template <typename T = std::uint8_t>
+class AES_VPermTables
+{
+public:
+    typedef std::array<std::uint8_t, 16> TableType;
+
+    static constexpr TableType input =
+        gf256::table<aes_vperm::InputGen>(gf256::MakeIndexSeq<16>());
+    static constexpr TableType inputHi =
+        gf256::table<aes_vperm::InputHiGen>(gf256::MakeIndexSeq<16>());
+
+    static constexpr TableType invInput =
+        gf256::table<aes_vperm::InvInputGen>(gf256::MakeIndexSeq<16>());
+    static constexpr TableType invInputHi =
+        gf256::table<aes_vperm::InvInputHiGen>(gf256::MakeIndexSeq<16>());
+
+    static constexpr TableType recip =
+        gf256::table<aes_vperm::RecipGen>(gf256::MakeIndexSeq<16>());
+    static constexpr TableType recipMu =
+        gf256::table<aes_vperm::RecipMuGen>(gf256::MakeIndexSeq<16>());
+
+    static constexpr TableType output1 =
+        gf256::table<aes_vperm::OutputGen<aes_vperm::COEF1, true>>(
+            gf256::MakeIndexSeq<16>());
+    static constexpr TableType output2 =
+        gf256::table<aes_vperm::OutputGen<aes_vperm::COEF2, true>>(
+            gf256::MakeIndexSeq<16>());
+
+    static constexpr TableType invOutput1 =
+        gf256::table<aes_vperm::OutputGen<aes_vperm::COEF1, false>>(
+            gf256::MakeIndexSeq<16>());
+    static constexpr TableType invOutput2 =
+        gf256::table<aes_vperm::OutputGen<aes_vperm::COEF2, false>>(
+            gf256::MakeIndexSeq<16>());
+};
+
+template <typename T> constexpr typename AES_VPermTables<T>::TableType
+    AES_VPermTables<T>::input;
+template <typename T> constexpr typename AES_VPermTables<T>::TableType
+    AES_VPermTables<T>::inputHi;
+template <typename T> constexpr typename AES_VPermTables<T>::TableType
+    AES_VPermTables<T>::invInput;
+template <typename T> constexpr typename AES_VPermTables<T>::TableType
+    AES_VPermTables<T>::invInputHi;
+template <typename T> constexpr typename AES_VPermTables<T>::TableType
+    AES_VPermTables<T>::recip;
+template <typename T> constexpr typename AES_VPermTables<T>::TableType
+    AES_VPermTables<T>::recipMu;
+template <typename T> constexpr typename AES_VPermTables<T>::TableType
+    AES_VPermTables<T>::output1;
+template <typename T> constexpr typename AES_VPermTables<T>::TableType
+    AES_VPermTables<T>::output2;
+template <typename T> constexpr typename AES_VPermTables<T>::TableType
+    AES_VPermTables<T>::invOutput1;
+template <typename T> constexpr typename AES_VPermTables<T>::TableType
+    AES_VPermTables<T>::invOutput2;
+
+////////////////////////////////////////////////////////////////////////////////
+// round transformations on a 128-bit register
+//
+// The state is in FIPS 197 order, byte r + 4c is row r of column c.
+//
+
+class AES_VPermRound
+{
+    typedef AES_VPermTables<> Tables;
+
+public:
+    static __m128i load(const std::uint8_t* a) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+    }
+
+    static void store(const __m128i& a, std::uint8_t* b) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(b), a);
+    }
+
+    // 5.1.1 SubBytes()
+    static __m128i subBytes(const __m128i& s) {
+        return sbox(s,
+                    Tables::input, Tables::inputHi,
+                    Tables::output1, Tables::output2,
+                    0x63);
+    }
+
+    // 5.3.2 InvSubBytes()
+    static __m128i invSubBytes(const __m128i& s) {
+        return sbox(s,
+                    Tables::invInput, Tables::invInputHi,
+                    Tables::invOutput1, Tables::invOutput2,
+                    0x00);
+    }
+
+    // 5.1.2 ShiftRows()
+    static __m128i shiftRows(const __m128i& s) {
+        return _mm_shuffle_epi8(
+            s,
+            _mm_setr_epi8(0, 5, 10, 15, 4, 9, 14, 3,
+                          8, 13, 2, 7, 12, 1, 6, 11));
+    }
+
+    // 5.3.1 InvShiftRows()
+    static __m128i invShiftRows(const __m128i& s) {
+        return _mm_shuffle_epi8(
+            s,
+            _mm_setr_epi8(0, 13, 10, 7, 4, 1, 14, 11,
+                          8, 5, 2, 15, 12, 9, 6, 3));
+    }
+
+    // 5.1.3 MixColumns()
+    // s'r = {02}(sr XOR sr+1) XOR sr+1 XOR sr+2 XOR sr+3
+    static __m128i mixColumns(const __m128i& s) {
+        const __m128i
+            s1 = rotateRows(s, 1),
+            s2 = rotateRows(s, 2),
+            s3 = rotateRows(s, 3);
+
+        return _mm_xor_si128(
+            _mm_xor_si128(xtime(_mm_xor_si128(s, s1)), s1),
+            _mm_xor_si128(s2, s3));
+    }
+
+    // 5.3.3 InvMixColumns()
+    // ({04}x^2 + {05}) times the MixColumns() polynomial
+    static __m128i invMixColumns(const __m128i& s) {
+        const __m128i u = xtime(xtime(_mm_xor_si128(s, rotateRows(s, 2))));
+        return mixColumns(_mm_xor_si128(s, u));
+    }
+
+private:
+    static __m128i table(const std::array<std::uint8_t, 16>& a) {
+        return load(a.data());
+    }
+
+    // multiply all bytes by {02}
+    static __m128i xtime(const __m128i& a) {
+        const __m128i hi = _mm_cmplt_epi8(a, _mm_setzero_si128());
+        return _mm_xor_si128(_mm_add_epi8(a, a),
+                             _mm_and_si128(hi, _mm_set1_epi8(0x1b)));
+    }
+
+    // row r + n of each column moves to row r
+    static __m128i rotateRows(const __m128i& s, const int n) {
+        return 1 == n
+            ? _mm_shuffle_epi8(s, _mm_setr_epi8(1, 2, 3, 0, 5, 6, 7, 4,
+                                                9, 10, 11, 8, 13, 14, 15, 12))
+            : 2 == n
+            ? _mm_shuffle_epi8(s, _mm_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5,
+                                                10, 11, 8, 9, 14, 15, 12, 13))
+            : _mm_shuffle_epi8(s, _mm_setr_epi8(3, 0, 1, 2, 7, 4, 5, 6,
+                                                11, 8, 9, 10, 15, 12, 13, 14));
+    }
+
+    // inversion in the tower field between input and output basis changes
+    static __m128i sbox(const __m128i& s,
+                        const std::array<std::uint8_t, 16>& inLo,
+                        const std::array<std::uint8_t, 16>& inHi,
+                        const std::array<std::uint8_t, 16>& out1,
+                        const std::array<std::uint8_t, 16>& out2,
+                        const char c) {
+        const __m128i mask = _mm_set1_epi8(0x0f);
+
+        const __m128i recip = table(Tables::recip);
+
+        // (i, j) coordinates of the input
+        const __m128i x =
+            _mm_xor_si128(
+                _mm_shuffle_epi8(table(inLo), _mm_and_si128(s, mask)),
+                _mm_shuffle_epi8(table(inHi),
+                                 _mm_and_si128(_mm_srli_epi16(s, 4), mask)));
+
+        const __m128i
+            i = _mm_and_si128(x, mask),
+            j = _mm_and_si128(_mm_srli_epi16(x, 4), mask),
+            k = _mm_xor_si128(i, j);
+
+        const __m128i ak = _mm_shuffle_epi8(table(Tables::recipMu), k);
+
+        const __m128i
+            iak = _mm_xor_si128(_mm_shuffle_epi8(recip, i), ak),
+            jak = _mm_xor_si128(_mm_shuffle_epi8(recip, j), ak);
+
+        const __m128i
+            io = _mm_xor_si128(_mm_shuffle_epi8(recip, iak), j),
+            jo = _mm_xor_si128(_mm_shuffle_epi8(recip, jak), i);
+
+        return _mm_xor_si128(
+            _mm_xor_si128(_mm_shuffle_epi8(table(out1), io),
+                          _mm_shuffle_epi8(table(out2), jo)),
+            _mm_set1_epi8(c));
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// S-boxes on one byte
+//
+// Constant time replacements for AES_SBox and AES_InvSBox, e.g. for the
+// key expansion. Unmanaged only.
+//
+
+template <typename T, typename U, typename BITWISE>
+class AES_VPermSBox
+{
+public:
+    AES_VPermSBox() = default;
+
+    U operator() (const T& idx) const {
+        return _mm_cvtsi128_si32(
+            AES_VPermRound::subBytes(_mm_cvtsi32_si128(idx))) & 0xff;
+    }
+};
+
+template <typename T, typename U, typename BITWISE>
+class AES_VPermInvSBox
+{
+public:
+    AES_VPermInvSBox() = default;
+
+    U operator() (const T& idx) const {
+        return _mm_cvtsi128_si32(
+            AES_VPermRound::invSubBytes(_mm_cvtsi32_si128(idx))) & 0xff;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// 5.1 Cipher
+//
+
+class AES_VPermCipher
+{
+    typedef AES_VPermRound R;
+
+public:
+    typedef std::uint8_t VarType;
+    typedef std::array<std::uint8_t, 16> BlockType;
+    typedef AES_KeyExpansion<std::uint8_t,
+                             std::uint8_t,
+                             std::uint8_t,
+                             BitwiseINT<std::uint8_t>,
+                             AES_VPermSBox<std::uint8_t,
+                                           std::uint8_t,
+                                           BitwiseINT<std::uint8_t>>>
+        KeyExpansion;
+
+    AES_VPermCipher() = default;
+
+    // AES-128 (176), AES-192 (208), AES-256 (240)
+    template <std::size_t WSZ>
+    void operator() (const BlockType& in,
+                     BlockType& out,
+                     const std::array<std::uint8_t, WSZ>& w) const {
+        const std::size_t Nr = WSZ / 16 - 1;
+
+        __m128i s = _mm_xor_si128(R::load(in.data()), R::load(w.data()));
+
+        for (std::size_t round = 1; round < Nr; ++round) {
+            s = R::mixColumns(R::shiftRows(R::subBytes(s)));
+            s = _mm_xor_si128(s, R::load(w.data() + 16*round));
+        }
+
+        s = R::shiftRows(R::subBytes(s));
+        s = _mm_xor_si128(s, R::load(w.data() + 16*Nr));
+
+        R::store(s, out.data());
+    }
+
+    // L independent blocks with their own key schedules (only the first
+    // n lanes are used)
+    template <std::size_t L, std::size_t WSZ>
+    void lanes(const std::array<BlockType, L>& in,
+               std::array<BlockType, L>& out,
+               const std::array<const std::array<std::uint8_t, WSZ>*, L>& w,
+               const std::size_t n = L) const
+    {
+        const std::size_t Nr = WSZ / 16 - 1;
+
+        __m128i s[L];
+
+        for (std::size_t k = 0; k < n; ++k)
+            s[k] = _mm_xor_si128(R::load(in[k].data()), R::load(w[k]->data()));
+
+        for (std::size_t round = 1; round < Nr; ++round) {
+            for (std::size_t k = 0; k < n; ++k) {
+                s[k] = R::mixColumns(R::shiftRows(R::subBytes(s[k])));
+                s[k] = _mm_xor_si128(s[k],
+                                     R::load(w[k]->data() + 16*round));
+            }
+        }
+
+        for (std::size_t k = 0; k < n; ++k) {
+            s[k] = R::shiftRows(R::subBytes(s[k]));
+            s[k] = _mm_xor_si128(s[k], R::load(w[k]->data() + 16*Nr));
+            R::store(s[k], out[k].data());
+        }
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// 5.3 Inverse Cipher
+//
+
+class AES_VPermInvCipher
+{
+    typedef AES_VPermRound R;
+
+public:
+    typedef std::uint8_t VarType;
+    typedef std::array<std::uint8_t, 16> BlockType;
+    typedef AES_VPermCipher::KeyExpansion KeyExpansion;
+
+    AES_VPermInvCipher() = default;
+
+    template <std::size_t WSZ>
+    void operator() (const BlockType& in,
+                     BlockType& out,
+                     const std::array<std::uint8_t, WSZ>& w) const {
+        const std::size_t Nr = WSZ / 16 - 1;
+
+        __m128i s = _mm_xor_si128(R::load(in.data()),
+                                  R::load(w.data() + 16*Nr));
+
+        for (std::size_t round = Nr - 1; round > 0; --round) {
+            s = R::invSubBytes(R::invShiftRows(s));
+            s = _mm_xor_si128(s, R::load(w.data() + 16*round));
+            s = R::invMixColumns(s);
+        }
+
+        s = R::invSubBytes(R::invShiftRows(s));
+        s = _mm_xor_si128(s, R::load(w.data()));
+
+        R::store(s, out.data());
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// 5.3.5 Equivalent Inverse Cipher
+//
+
+class AES_VPermEqInvCipher
+{
+    typedef AES_VPermRound R;
+
+public:
+    typedef std::uint8_t VarType;
+    typedef std::array<std::uint8_t, 16> BlockType;
+    typedef AES_VPermCipher::KeyExpansion KeyExpansion;
+
+    AES_VPermEqInvCipher() = default;
+
+    template <std::size_t WSZ>
+    void operator() (const BlockType& in,
+                     BlockType& out,
+                     const std::array<std::uint8_t, WSZ>& dw) const {
+        const std::size_t Nr = WSZ / 16 - 1;
+
+        __m128i s = _mm_xor_si128(R::load(in.data()),
+                                  R::load(dw.data() + 16*Nr));
+
+        for (std::size_t round = Nr - 1; round > 0; --round) {
+            s = R::invMixColumns(R::invShiftRows(R::invSubBytes(s)));
+            s = _mm_xor_si128(s, R::load(dw.data() + 16*round));
+        }
+
+        s = R::invShiftRows(R::invSubBytes(s));
+        s = _mm_xor_si128(s, R::load(dw.data()));
+
+        R::store(s, out.data());
+    }
+
+    // decryption key schedule dw from the expanded key w
+    template <std::size_t WSZ>
+    void schedule(const std::array<std::uint8_t, WSZ>& w,
+                  std::array<std::uint8_t, WSZ>& dw) const {
+        const std::size_t Nr = WSZ / 16 - 1;
+
+        dw = w;
+
+        for (std::size_t round = 1; round < Nr; ++round) {
+            R::store(R::invMixColumns(R::load(w.data() + 16*round)),
+                     dw.data() + 16*round);
+        }
+    }
+
+    // L independent blocks with their own decryption key schedules (only
+    // the first n lanes are used)
+    template <std::size_t L, std::size_t WSZ>
+    void lanes(const std::array<BlockType, L>& in,
+               std::array<BlockType, L>& out,
+               const std::array<const std::array<std::uint8_t, WSZ>*, L>& dw,
+               const std::size_t n = L) const
+    {
+        const std::size_t Nr = WSZ / 16 - 1;
+
+        __m128i s[L];
+
+        for (std::size_t k = 0; k < n; ++k) {
+            s[k] = _mm_xor_si128(R::load(in[k].data()),
+                                 R::load(dw[k]->data() + 16*Nr));
+        }
+
+        for (std::size_t round = Nr - 1; round > 0; --round) {
+            for (std::size_t k = 0; k < n; ++k) {
+                s[k] = R::invMixColumns(R::invShiftRows(R::invSubBytes(s[k])));
+                s[k] = _mm_xor_si128(s[k],
+                                     R::load(dw[k]->data() + 16*round));
+            }
+        }
+
+        for (std::size_t k = 0; k < n; ++k) {
+            s[k] = R::invShiftRows(R::invSubBytes(s[k]));
+            s[k] = _mm_xor_si128(s[k], R::load(dw[k]->data()));
+            R::store(s[k], out[k].data());
+        }
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// AES variants
+//
+// Drop-in replacements for AES128, UNAES128,... (same key contexts, modes
+// and interfaces). NK is the key length in 32-bit words.
+//
+
+template <std::size_t NK, bool ENCRYPT>
+class AES_VPerm
+{
+public:
+    AES_VPerm() = default;
+
+    static bool isEncryption() { return ENCRYPT; }
+    static bool isDecryption() { return ! ENCRYPT; }
+
+    typedef std::uint8_t VarType;
+    typedef AES_VPermCipher Encrypt;
+    typedef AES_VPermInvCipher Decrypt;
+    typedef AES_VPermEqInvCipher EqDecrypt;
+    typedef typename std::conditional<ENCRYPT, Encrypt, Decrypt>::type Algo;
+    typedef typename std::conditional<ENCRYPT, Decrypt, Encrypt>::type InvAlgo;
+
+    typedef typename Encrypt::BlockType BlockType;
+    typedef typename Encrypt::KeyExpansion KeyExpansion;
+    typedef std::array<std::uint8_t, 4 * NK> KeyType;
+    typedef std::array<std::uint8_t, 16 * (NK + 7)> ScheduleType;
+    typedef AES_KeyContext<AES_VPerm<NK, true>> KeyContext;
+};
+
+typedef AES_VPerm<4, true> AES128_VPerm;
+typedef AES_VPerm<4, false> UNAES128_VPerm;
+typedef AES_VPerm<6, true> AES192_VPerm;
+typedef AES_VPerm<6, false> UNAES192_VPerm;
+typedef AES_VPerm<8, true> AES256_VPerm;
+typedef AES_VPerm<8, false> UNAES256_VPerm;
+
+} // namespace cryptl
+
+#endif // __SSSE3__
+
+#endif
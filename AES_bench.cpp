@@ -0,0 +1,189 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "cryptl/AES.hpp"
+#include "cryptl/AES_VPerm.hpp"
+#include "cryptl/ChaCha20_Poly1305.hpp"
+#include "cryptl/CipherModes.hpp"
+
+using namespace cryptl;
+using namespace std;
+
+void printUsage(const char* exeName) {
+    cout << "usage: " << exeName << " -b 128|192|256 [-n iterations] [-v|-w]"
+         << endl
+         << "       " << exeName << " -c [-n iterations]"
+         << endl
+         << "  -v  vector permute AES (needs SSSE3 at compile time)"
+         << endl
+         << "  -w  AES on 32-bit column words"
+         << endl
+         << "  -c  ChaCha20-Poly1305 (AVX2 if enabled at compile time)"
+         << endl;
+
+    exit(EXIT_FAILURE);
+}
+
+// prints average nanoseconds for one call of func
+template <typename FUNC>
+void timeLoop(const string& label, const size_t N, const FUNC& func)
+{
+    const auto start = chrono::steady_clock::now();
+
+    for (size_t i = 0; i < N; ++i) func(i);
+
+    const auto stop = chrono::steady_clock::now();
+    const double ns = chrono::duration<double, nano>(stop - start).count();
+
+    cout << label << " " << (ns / N) << " ns" << endl;
+}
+
+template <typename T>
+void runBench(const size_t N)
+{
+    typename T::KeyType key;
+    for (size_t i = 0; i < key.size(); ++i) key[i] = i;
+
+    typename T::BlockType IV;
+    for (size_t i = 0; i < IV.size(); ++i) IV[i] = 0xff - i;
+
+    typename T::KeyContext keyContext(key);
+
+    // result is folded into sink so loops are not optimized away
+    uint8_t sink = 0;
+
+    typename T::ScheduleType w;
+    typename T::KeyExpansion keyExpand;
+    timeLoop("key expansion", N, [&] (const size_t i) {
+            key[0] = i;
+            keyExpand(key, w);
+            sink ^= w[w.size() - 1];
+        });
+
+    timeLoop("rekey", N, [&] (const size_t i) {
+            key[0] = i;
+            keyContext.rekey(key);
+            sink ^= keyContext.decSchedule()[16];
+        });
+
+    vector<uint8_t> msg(IV.size());
+    timeLoop("one-shot CBC block", N, [&] (const size_t i) {
+            msg[0] = i;
+            sink ^= CBC(T(), key, IV, msg)[0];
+        });
+
+    timeLoop("key context CBC block", N, [&] (const size_t i) {
+            msg[0] = i;
+            sink ^= CBC(T(), keyContext, IV, msg)[0];
+        });
+
+    cout << "(" << int(sink) << ")" << endl;
+}
+
+void runChaChaBench(const size_t N)
+{
+    CHACHA20_POLY1305::KeyType key;
+    for (size_t i = 0; i < key.size(); ++i) key[i] = i;
+
+    CHACHA20_POLY1305::NonceType nonce;
+    for (size_t i = 0; i < nonce.size(); ++i) nonce[i] = 0xff - i;
+
+    // result is folded into sink so loops are not optimized away
+    uint8_t sink = 0;
+
+    CHACHA20_POLY1305::TagType tag;
+    vector<uint8_t> msg(16), aad;
+    timeLoop("ChaCha20-Poly1305 block", N, [&] (const size_t i) {
+            msg[0] = i;
+            sink ^= ChaChaPoly_Seal(key, nonce, aad, msg, tag)[0] ^ tag[0];
+        });
+
+    vector<uint8_t> buf(1024), out(buf.size());
+    timeLoop("ChaCha20-Poly1305 1 KB", N, [&] (const size_t i) {
+            buf[0] = i;
+            ChaChaPoly_Context<CHACHA20_POLY1305> ctx(key, nonce);
+            ctx.update(buf.data(), buf.size(), out.data());
+            ctx.finalize(tag);
+            sink ^= out[0] ^ tag[0];
+        });
+
+    cout << "(" << int(sink) << ")" << endl;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t aesBits = -1, N = 100000;
+    bool vperm = false, columns = false, chacha = false;
+    int opt;
+    while (-1 != (opt = getopt(argc, argv, "b:n:vwc"))) {
+        stringstream ss(optarg ? optarg : "");
+        switch (opt) {
+        case ('b') :
+            if (!(ss >> aesBits)) {
+                cerr << "error: number of bits " << optarg << endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case ('n') :
+            if (!(ss >> N) || 0 == N) {
+                cerr << "error: iterations " << optarg << endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case ('v') :
+            vperm = true;
+            break;
+        case ('w') :
+            columns = true;
+            break;
+        case ('c') :
+            chacha = true;
+            break;
+        }
+    }
+
+    if (chacha) {
+        runChaChaBench(N);
+        return EXIT_SUCCESS;
+    }
+
+    if (vperm) {
+#ifdef __SSSE3__
+        switch (aesBits) {
+        case (128) : runBench<AES128_VPerm>(N); break;
+        case (192) : runBench<AES192_VPerm>(N); break;
+        case (256) : runBench<AES256_VPerm>(N); break;
+        default : printUsage(argv[0]);
+        }
+#else
+        cerr << "error: built without SSSE3" << endl;
+        exit(EXIT_FAILURE);
+#endif
+        return EXIT_SUCCESS;
+    }
+
+    if (columns) {
+        switch (aesBits) {
+        case (128) : runBench<AES128_Columns>(N); break;
+        case (192) : runBench<AES192_Columns>(N); break;
+        case (256) : runBench<AES256_Columns>(N); break;
+        default : printUsage(argv[0]);
+        }
+        return EXIT_SUCCESS;
+    }
+
+    switch (aesBits) {
+    case (128) : runBench<AES128>(N); break;
+    case (192) : runBench<AES192>(N); break;
+    case (256) : runBench<AES256>(N); break;
+    default : printUsage(argv[0]);
+    }
+
+    return EXIT_SUCCESS;
+}
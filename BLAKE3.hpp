@@ -0,0 +1,759 @@
+#ifndef _CRYPTL_BLAKE3_HPP_
+#define _CRYPTL_BLAKE3_HPP_
+
+#include <array>
+#include <cstdint>
+#include <istream>
+#include <vector>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include <cryptl/BitwiseINT.hpp>
+#include <cryptl/ThreadPool.hpp>
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// BLAKE3 (O'Connor, Aumasson, Neves, Wilcox-O'Hearn 2020)
+//
+// Tree hash for integrity checks where FIPS compliance is not required.
+// Input is split into 1 KB chunks, each hashed on its own, and the chunk
+// chaining values are merged pairwise up a binary tree.
+//
+// The compression function is written with the BITWISE policy operations
+// (ADDMOD, XOR, ROTR on 32-bit words) like the SHA templates. The native
+// hasher compresses eight chunks (or parent nodes) at a time with AVX2,
+// one state word of eight inputs per register. Large subtrees are split
+// over a thread pool when one is given.
+//
+
+// domain separation flags
+enum BLAKE3_Flag : std::uint32_t {
+    BLAKE3_CHUNK_START = 1,
+    BLAKE3_CHUNK_END = 2,
+    BLAKE3_PARENT = 4,
+    BLAKE3_ROOT = 8,
+    BLAKE3_KEYED_HASH = 16
+};
+
+// initial chaining value (same as SHA-256)
+const std::array<std::uint32_t, 8> BLAKE3_IV {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+
+template <typename T, typename F>
+class BLAKE3_Compress
+{
+public:
+    typedef std::array<T, 8> CVType;
+    typedef std::array<T, 16> MsgType;
+    typedef std::array<T, 16> OutType;
+
+    // counter, block length and flags are words already
+    void operator() (const CVType& cv,
+                     const MsgType& m,
+                     const T& counterLo,
+                     const T& counterHi,
+                     const T& blockLength,
+                     const T& flags,
+                     OutType& out) const {
+        OutType& v = out;
+
+        for (std::size_t i = 0; i < 8; ++i) {
+            v[i] = cv[i];
+        }
+
+        for (std::size_t i = 0; i < 4; ++i) {
+            v[8 + i] = F::constant(BLAKE3_IV[i]);
+        }
+
+        v[12] = counterLo;
+        v[13] = counterHi;
+        v[14] = blockLength;
+        v[15] = flags;
+
+        for (std::size_t r = 0; r < 7; ++r) {
+            const unsigned char* s = schedule(r);
+
+            G(v, 0, 4, 8, 12, m[s[0]], m[s[1]]);
+            G(v, 1, 5, 9, 13, m[s[2]], m[s[3]]);
+            G(v, 2, 6, 10, 14, m[s[4]], m[s[5]]);
+            G(v, 3, 7, 11, 15, m[s[6]], m[s[7]]);
+
+            G(v, 0, 5, 10, 15, m[s[8]], m[s[9]]);
+            G(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+            G(v, 2, 7, 8, 13, m[s[12]], m[s[13]]);
+            G(v, 3, 4, 9, 14, m[s[14]], m[s[15]]);
+        }
+
+        // first half is the chaining value, all of it is extended output
+        for (std::size_t i = 0; i < 8; ++i) {
+            v[i] = F::XOR(v[i], v[i + 8]);
+            v[i + 8] = F::XOR(v[i + 8], cv[i]);
+        }
+    }
+
+    // message word permutation of each round
+    static const unsigned char* schedule(const std::size_t r) {
+        static const unsigned char S[7][16] = {
+            { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+            { 2, 6, 3, 10, 7, 0, 4, 13, 1, 11, 12, 5, 9, 14, 15, 8 },
+            { 3, 4, 10, 12, 13, 2, 7, 14, 6, 5, 9, 0, 11, 15, 8, 1 },
+            { 10, 7, 12, 9, 14, 3, 13, 15, 4, 0, 11, 2, 5, 8, 1, 6 },
+            { 12, 13, 9, 11, 15, 10, 14, 8, 7, 2, 5, 3, 0, 1, 6, 4 },
+            { 9, 14, 11, 5, 8, 12, 15, 1, 13, 3, 0, 10, 2, 6, 4, 7 },
+            { 11, 15, 5, 0, 1, 9, 8, 6, 14, 10, 2, 12, 3, 4, 7, 13 } };
+
+        return S[r];
+    }
+
+private:
+    static void G(OutType& v,
+                  const std::size_t a,
+                  const std::size_t b,
+                  const std::size_t c,
+                  const std::size_t d,
+                  const T& x,
+                  const T& y) {
+        v[a] = F::ADDMOD(F::ADDMOD(v[a], v[b]), x);
+        v[d] = F::ROTR(F::XOR(v[d], v[a]), 16);
+        v[c] = F::ADDMOD(v[c], v[d]);
+        v[b] = F::ROTR(F::XOR(v[b], v[c]), 12);
+        v[a] = F::ADDMOD(F::ADDMOD(v[a], v[b]), y);
+        v[d] = F::ROTR(F::XOR(v[d], v[a]), 8);
+        v[c] = F::ADDMOD(v[c], v[d]);
+        v[b] = F::ROTR(F::XOR(v[b], v[c]), 7);
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// native compression of many inputs
+//
+
+typedef BLAKE3_Compress<std::uint32_t, BitwiseINT<std::uint32_t>>
+    BLAKE3_NativeCompress;
+
+const std::size_t BLAKE3_BLOCK_OCTETS = 64;
+const std::size_t BLAKE3_CHUNK_OCTETS = 1024;
+const std::size_t BLAKE3_LANES = 8;
+
+// chaining values of chunks and parent nodes as octets
+typedef std::array<std::uint8_t, 32> BLAKE3_CV;
+
+inline void blake3Load(const std::uint8_t* a, std::uint32_t* w, const std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i) {
+        w[i] = std::uint32_t(a[4*i])
+            | (std::uint32_t(a[4*i + 1]) << 8)
+            | (std::uint32_t(a[4*i + 2]) << 16)
+            | (std::uint32_t(a[4*i + 3]) << 24);
+    }
+}
+
+inline void blake3Store(const std::uint32_t* w, std::uint8_t* a, const std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < 4; ++j)
+            a[4*i + j] = (w[i] >> (8 * j)) & 0xff;
+    }
+}
+
+// one input of whole blocks, chaining value out
+inline void blake3HashOne(const std::uint8_t* input,
+                          const std::size_t blocks,
+                          const std::array<std::uint32_t, 8>& key,
+                          const std::uint64_t counter,
+                          const std::uint32_t flags,
+                          const std::uint32_t flagsStart,
+                          const std::uint32_t flagsEnd,
+                          std::uint8_t* out)
+{
+    const BLAKE3_NativeCompress compress;
+
+    BLAKE3_NativeCompress::CVType cv = key;
+    BLAKE3_NativeCompress::MsgType m;
+    BLAKE3_NativeCompress::OutType v;
+
+    std::uint32_t blockFlags = flags | flagsStart;
+
+    for (std::size_t b = 0; b < blocks; ++b) {
+        if (b + 1 == blocks) blockFlags |= flagsEnd;
+
+        blake3Load(input + b * BLAKE3_BLOCK_OCTETS, m.data(), 16);
+        compress(cv, m, counter, counter >> 32, BLAKE3_BLOCK_OCTETS, blockFlags, v);
+
+        for (std::size_t i = 0; i < 8; ++i) cv[i] = v[i];
+        blockFlags = flags;
+    }
+
+    blake3Store(cv.data(), out, 8);
+}
+
+#ifdef __AVX2__
+// 8x8 transpose of 32-bit words
+inline void blake3Transpose(__m256i* r)
+{
+    const __m256i
+        t0 = _mm256_unpacklo_epi32(r[0], r[1]),
+        t1 = _mm256_unpackhi_epi32(r[0], r[1]),
+        t2 = _mm256_unpacklo_epi32(r[2], r[3]),
+        t3 = _mm256_unpackhi_epi32(r[2], r[3]),
+        t4 = _mm256_unpacklo_epi32(r[4], r[5]),
+        t5 = _mm256_unpackhi_epi32(r[4], r[5]),
+        t6 = _mm256_unpacklo_epi32(r[6], r[7]),
+        t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+
+    const __m256i
+        u0 = _mm256_unpacklo_epi64(t0, t2),
+        u1 = _mm256_unpackhi_epi64(t0, t2),
+        u2 = _mm256_unpacklo_epi64(t1, t3),
+        u3 = _mm256_unpackhi_epi64(t1, t3),
+        u4 = _mm256_unpacklo_epi64(t4, t6),
+        u5 = _mm256_unpackhi_epi64(t4, t6),
+        u6 = _mm256_unpacklo_epi64(t5, t7),
+        u7 = _mm256_unpackhi_epi64(t5, t7);
+
+    r[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+    r[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+    r[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+    r[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+    r[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+    r[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+    r[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+    r[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+}
+
+// eight inputs of whole blocks, counters advance by lane if increment
+inline void blake3Lanes(const std::uint8_t* const* inputs,
+                        const std::size_t blocks,
+                        const std::array<std::uint32_t, 8>& key,
+                        const std::uint64_t counter,
+                        const bool increment,
+                        const std::uint32_t flags,
+                        const std::uint32_t flagsStart,
+                        const std::uint32_t flagsEnd,
+                        std::uint8_t* out)
+{
+    const __m256i rot16 = _mm256_set_epi8(
+        13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2,
+        13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2);
+
+    const __m256i rot8 = _mm256_set_epi8(
+        12, 15, 14, 13, 8, 11, 10, 9, 4, 7, 6, 5, 0, 3, 2, 1,
+        12, 15, 14, 13, 8, 11, 10, 9, 4, 7, 6, 5, 0, 3, 2, 1);
+
+    __m256i h[8], m[16], v[16];
+
+    for (std::size_t i = 0; i < 8; ++i)
+        h[i] = _mm256_set1_epi32(key[i]);
+
+    // 64-bit counters split into low and high words
+    const __m256i
+        inc = increment
+            ? _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)
+            : _mm256_setzero_si256(),
+        sign = _mm256_set1_epi32(0x80000000),
+        lo = _mm256_add_epi32(_mm256_set1_epi32(std::uint32_t(counter)), inc),
+        carry = _mm256_cmpgt_epi32(_mm256_xor_si256(inc, sign),
+                                   _mm256_xor_si256(lo, sign)),
+        hi = _mm256_sub_epi32(_mm256_set1_epi32(std::uint32_t(counter >> 32)),
+                              carry);
+
+    std::uint32_t blockFlags = flags | flagsStart;
+
+    for (std::size_t b = 0; b < blocks; ++b) {
+        if (b + 1 == blocks) blockFlags |= flagsEnd;
+
+        // message words of the eight inputs
+        const std::size_t offset = b * BLAKE3_BLOCK_OCTETS;
+        for (std::size_t k = 0; k < 8; ++k) {
+            m[k] = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(inputs[k] + offset));
+            m[8 + k] = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(inputs[k] + offset + 32));
+        }
+
+        blake3Transpose(m);
+        blake3Transpose(m + 8);
+
+        for (std::size_t i = 0; i < 8; ++i)
+            v[i] = h[i];
+
+        for (std::size_t i = 0; i < 4; ++i)
+            v[8 + i] = _mm256_set1_epi32(BLAKE3_IV[i]);
+
+        v[12] = lo;
+        v[13] = hi;
+        v[14] = _mm256_set1_epi32(BLAKE3_BLOCK_OCTETS);
+        v[15] = _mm256_set1_epi32(blockFlags);
+
+#define CRYPTL_BLAKE3_G(a, b, c, d, x, y)                                    \
+    v[a] = _mm256_add_epi32(_mm256_add_epi32(v[a], v[b]), x);                \
+    v[d] = _mm256_shuffle_epi8(_mm256_xor_si256(v[d], v[a]), rot16);         \
+    v[c] = _mm256_add_epi32(v[c], v[d]);                                     \
+    v[b] = _mm256_xor_si256(v[b], v[c]);                                     \
+    v[b] = _mm256_or_si256(_mm256_srli_epi32(v[b], 12),                      \
+                           _mm256_slli_epi32(v[b], 20));                     \
+    v[a] = _mm256_add_epi32(_mm256_add_epi32(v[a], v[b]), y);                \
+    v[d] = _mm256_shuffle_epi8(_mm256_xor_si256(v[d], v[a]), rot8);          \
+    v[c] = _mm256_add_epi32(v[c], v[d]);                                     \
+    v[b] = _mm256_xor_si256(v[b], v[c]);                                     \
+    v[b] = _mm256_or_si256(_mm256_srli_epi32(v[b], 7),                       \
+                           _mm256_slli_epi32(v[b], 25));
+
+        for (std::size_t r = 0; r < 7; ++r) {
+            const unsigned char* s = BLAKE3_NativeCompress::schedule(r);
+
+            CRYPTL_BLAKE3_G(0, 4, 8, 12, m[s[0]], m[s[1]])
+            CRYPTL_BLAKE3_G(1, 5, 9, 13, m[s[2]], m[s[3]])
+            CRYPTL_BLAKE3_G(2, 6, 10, 14, m[s[4]], m[s[5]])
+            CRYPTL_BLAKE3_G(3, 7, 11, 15, m[s[6]], m[s[7]])
+
+            CRYPTL_BLAKE3_G(0, 5, 10, 15, m[s[8]], m[s[9]])
+            CRYPTL_BLAKE3_G(1, 6, 11, 12, m[s[10]], m[s[11]])
+            CRYPTL_BLAKE3_G(2, 7, 8, 13, m[s[12]], m[s[13]])
+            CRYPTL_BLAKE3_G(3, 4, 9, 14, m[s[14]], m[s[15]])
+        }
+
+#undef CRYPTL_BLAKE3_G
+
+        for (std::size_t i = 0; i < 8; ++i)
+            h[i] = _mm256_xor_si256(v[i], v[i + 8]);
+
+        blockFlags = flags;
+    }
+
+    // back to one chaining value per input
+    blake3Transpose(h);
+
+    for (std::size_t k = 0; k < 8; ++k)
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 32*k), h[k]);
+}
+#endif
+
+// n inputs of whole blocks, n chaining values out
+inline void blake3HashMany(const std::uint8_t* const* inputs,
+                           std::size_t n,
+                           const std::size_t blocks,
+                           const std::array<std::uint32_t, 8>& key,
+                           std::uint64_t counter,
+                           const bool increment,
+                           const std::uint32_t flags,
+                           const std::uint32_t flagsStart,
+                           const std::uint32_t flagsEnd,
+                           std::uint8_t* out)
+{
+#ifdef __AVX2__
+    for (; n >= BLAKE3_LANES; n -= BLAKE3_LANES) {
+        blake3Lanes(inputs, blocks, key, counter, increment,
+                    flags, flagsStart, flagsEnd, out);
+
+        inputs += BLAKE3_LANES;
+        out += 32 * BLAKE3_LANES;
+        if (increment) counter += BLAKE3_LANES;
+    }
+#endif
+
+    for (; n > 0; --n) {
+        blake3HashOne(*inputs++, blocks, key, counter,
+                      flags, flagsStart, flagsEnd, out);
+
+        out += 32;
+        if (increment) ++counter;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// subtrees of whole chunks
+//
+
+// chunks per thread pool task (64 KB)
+const std::size_t BLAKE3_TASK_CHUNKS = 64;
+
+// n chaining values to n / 2 parents (n even)
+inline void blake3Parents(std::vector<BLAKE3_CV>& cv,
+                          const std::array<std::uint32_t, 8>& key,
+                          const std::uint32_t flags)
+{
+    const std::size_t N = cv.size() / 2;
+
+    std::vector<const std::uint8_t*> inputs(N);
+    for (std::size_t i = 0; i < N; ++i)
+        inputs[i] = cv[2*i].data();
+
+    std::vector<BLAKE3_CV> parent(N);
+    blake3HashMany(inputs.data(), N, 1, key, 0, false,
+                   flags | BLAKE3_PARENT, 0, 0, parent[0].data());
+
+    cv.swap(parent);
+}
+
+// root of a complete subtree of n chunks (n a power of 2)
+inline BLAKE3_CV blake3SubtreeCV(const std::uint8_t* input,
+                                 const std::size_t n,
+                                 const std::array<std::uint32_t, 8>& key,
+                                 const std::uint64_t counter,
+                                 const std::uint32_t flags)
+{
+    std::vector<const std::uint8_t*> inputs(n);
+    for (std::size_t i = 0; i < n; ++i)
+        inputs[i] = input + i * BLAKE3_CHUNK_OCTETS;
+
+    std::vector<BLAKE3_CV> cv(n);
+    blake3HashMany(inputs.data(), n, BLAKE3_CHUNK_OCTETS / BLAKE3_BLOCK_OCTETS,
+                   key, counter, true,
+                   flags, BLAKE3_CHUNK_START, BLAKE3_CHUNK_END, cv[0].data());
+
+    while (cv.size() > 1) blake3Parents(cv, key, flags);
+
+    return cv[0];
+}
+
+// left and right children of a complete subtree of n chunks (n = 2^k > 1)
+inline std::array<BLAKE3_CV, 2> blake3SubtreePair(
+    const std::uint8_t* input,
+    const std::size_t n,
+    const std::array<std::uint32_t, 8>& key,
+    const std::uint64_t counter,
+    const std::uint32_t flags,
+    ThreadPool* pool)
+{
+    // tasks are subtrees of equal size, at least two
+    std::size_t taskChunks = n / 2;
+    while (taskChunks > BLAKE3_TASK_CHUNKS) taskChunks /= 2;
+
+    std::vector<BLAKE3_CV> cv(n / taskChunks);
+
+    const auto task = [&] (const std::size_t i) {
+        cv[i] = blake3SubtreeCV(input + i * taskChunks * BLAKE3_CHUNK_OCTETS,
+                                taskChunks,
+                                key,
+                                counter + i * taskChunks,
+                                flags);
+    };
+
+    if (pool && cv.size() > 2) {
+        pool->run(cv.size(), task);
+    } else {
+        for (std::size_t i = 0; i < cv.size(); ++i) task(i);
+    }
+
+    while (cv.size() > 2) blake3Parents(cv, key, flags);
+
+    return std::array<BLAKE3_CV, 2> { cv[0], cv[1] };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// streaming hasher
+//
+// update() takes input of any chunk size. Whole subtrees of the input are
+// hashed directly, the rest goes through the chunk state. The stack holds
+// the chaining values of completed subtrees, merged lazily so the root
+// node is only compressed by computeHash().
+//
+
+class BLAKE3
+{
+public:
+    typedef std::uint32_t WordType;
+    typedef std::array<std::uint8_t, 32> KeyType;
+    typedef std::array<std::uint8_t, 32> DigType;
+
+    // hash, optionally multi-threaded
+    explicit BLAKE3(ThreadPool* pool = nullptr)
+        : m_key(BLAKE3_IV),
+          m_flags(0),
+          m_pool(pool)
+    {
+        init();
+    }
+
+    // keyed hash (MAC)
+    explicit BLAKE3(const KeyType& key, ThreadPool* pool = nullptr)
+        : m_flags(BLAKE3_KEYED_HASH),
+          m_pool(pool)
+    {
+        blake3Load(key.data(), m_key.data(), 8);
+        init();
+    }
+
+    // start a new message
+    void init() {
+        resetChunk(0);
+        m_stackLength = 0;
+    }
+
+    void update(const std::uint8_t* in, std::size_t inLength) {
+        // complete a partial chunk, it is not the root if more follows
+        if (chunkLength() > 0) {
+            const std::size_t take = BLAKE3_CHUNK_OCTETS - chunkLength();
+            const std::size_t N = take < inLength ? take : inLength;
+
+            chunkUpdate(in, N);
+            in += N;
+            inLength -= N;
+
+            if (0 == inLength) return;
+
+            pushCV(chunkCV(), m_counter);
+            resetChunk(m_counter + 1);
+        }
+
+        // largest subtrees aligned with the chunk counter
+        while (inLength > BLAKE3_CHUNK_OCTETS) {
+            std::size_t n = 1;
+            while (2 * n * BLAKE3_CHUNK_OCTETS <= inLength) n *= 2;
+            while (0 != (m_counter & (n - 1))) n /= 2;
+
+            if (1 == n) {
+                chunkUpdate(in, BLAKE3_CHUNK_OCTETS);
+                pushCV(chunkCV(), m_counter);
+
+            } else {
+                const auto pair = blake3SubtreePair(
+                    in, n, m_key, m_counter, m_flags, m_pool);
+
+                pushCV(pair[0], m_counter);
+                pushCV(pair[1], m_counter + n / 2);
+            }
+
+            resetChunk(m_counter + n);
+            in += n * BLAKE3_CHUNK_OCTETS;
+            inLength -= n * BLAKE3_CHUNK_OCTETS;
+        }
+
+        // rest of the input, merge the stack as the root is not in it
+        if (inLength > 0) {
+            chunkUpdate(in, inLength);
+            mergeStack(m_counter);
+        }
+    }
+
+    void update(const std::vector<std::uint8_t>& in) {
+        update(in.data(), in.size());
+    }
+
+    // extended output of any length (XOF), the hash is the first 32 octets
+    void finalize(std::uint8_t* out, const std::size_t outLength) const {
+        Output root = rootOutput();
+
+        BLAKE3_NativeCompress::OutType v;
+        std::array<std::uint8_t, BLAKE3_BLOCK_OCTETS> a;
+
+        std::uint64_t counter = 0;
+        for (std::size_t offset = 0; offset < outLength; offset += a.size()) {
+            root.compress(counter++, BLAKE3_ROOT, v);
+            blake3Store(v.data(), a.data(), 16);
+
+            for (std::size_t j = 0; j < a.size() && offset + j < outLength; ++j)
+                out[offset + j] = a[j];
+        }
+    }
+
+    // same as SHA: computeHash() then digest()
+    void computeHash() {
+        finalize(m_digest.data(), m_digest.size());
+    }
+
+    const DigType& digest() const {
+        return m_digest;
+    }
+
+private:
+    // compression input of a chunk or parent node not yet compressed
+    struct Output {
+        std::array<std::uint32_t, 8> cv;
+        BLAKE3_NativeCompress::MsgType block;
+        std::uint64_t counter;
+        std::uint32_t blockLength, flags;
+
+        void compress(const std::uint64_t outCounter,
+                      const std::uint32_t extraFlags,
+                      BLAKE3_NativeCompress::OutType& v) const {
+            const std::uint64_t c = extraFlags ? outCounter : counter;
+
+            BLAKE3_NativeCompress()(cv, block, c, c >> 32,
+                                    blockLength, flags | extraFlags, v);
+        }
+
+        BLAKE3_CV chainingValue() const {
+            BLAKE3_NativeCompress::OutType v;
+            compress(0, 0, v);
+
+            BLAKE3_CV a;
+            blake3Store(v.data(), a.data(), 8);
+            return a;
+        }
+    };
+
+    std::size_t chunkLength() const {
+        return m_blocksCompressed * BLAKE3_BLOCK_OCTETS + m_bufLength;
+    }
+
+    void resetChunk(const std::uint64_t counter) {
+        m_cv = m_key;
+        m_counter = counter;
+        m_bufLength = 0;
+        m_blocksCompressed = 0;
+    }
+
+    std::uint32_t startFlag() const {
+        return 0 == m_blocksCompressed ? std::uint32_t(BLAKE3_CHUNK_START) : 0;
+    }
+
+    // the last block of a chunk stays buffered for the end flag
+    void chunkUpdate(const std::uint8_t* in, std::size_t inLength) {
+        if (m_bufLength > 0) {
+            while (m_bufLength < BLAKE3_BLOCK_OCTETS && inLength > 0) {
+                m_buf[m_bufLength++] = *in++;
+                --inLength;
+            }
+
+            if (0 == inLength) return;
+
+            compressBlock(m_buf.data());
+            m_bufLength = 0;
+        }
+
+        while (inLength > BLAKE3_BLOCK_OCTETS) {
+            compressBlock(in);
+            in += BLAKE3_BLOCK_OCTETS;
+            inLength -= BLAKE3_BLOCK_OCTETS;
+        }
+
+        while (inLength > 0) {
+            m_buf[m_bufLength++] = *in++;
+            --inLength;
+        }
+    }
+
+    void compressBlock(const std::uint8_t* a) {
+        BLAKE3_NativeCompress::MsgType m;
+        BLAKE3_NativeCompress::OutType v;
+
+        blake3Load(a, m.data(), 16);
+        BLAKE3_NativeCompress()(m_cv, m, m_counter, m_counter >> 32,
+                                BLAKE3_BLOCK_OCTETS, m_flags | startFlag(), v);
+
+        for (std::size_t i = 0; i < 8; ++i) m_cv[i] = v[i];
+        ++m_blocksCompressed;
+    }
+
+    Output chunkOutput() const {
+        Output a;
+        a.cv = m_cv;
+
+        std::array<std::uint8_t, BLAKE3_BLOCK_OCTETS> b;
+        b.fill(0);
+        for (std::size_t j = 0; j < m_bufLength; ++j) b[j] = m_buf[j];
+        blake3Load(b.data(), a.block.data(), 16);
+
+        a.counter = m_counter;
+        a.blockLength = m_bufLength;
+        a.flags = m_flags | startFlag() | BLAKE3_CHUNK_END;
+        return a;
+    }
+
+    BLAKE3_CV chunkCV() const {
+        return chunkOutput().chainingValue();
+    }
+
+    Output parentOutput(const BLAKE3_CV& left, const BLAKE3_CV& right) const {
+        Output a;
+        a.cv = m_key;
+        blake3Load(left.data(), a.block.data(), 8);
+        blake3Load(right.data(), a.block.data() + 8, 8);
+        a.counter = 0;
+        a.blockLength = BLAKE3_BLOCK_OCTETS;
+        a.flags = m_flags | BLAKE3_PARENT;
+        return a;
+    }
+
+    // one stack entry per set bit of the number of chunks
+    void mergeStack(const std::uint64_t totalChunks) {
+        std::size_t bits = 0;
+        for (std::uint64_t c = totalChunks; c; c &= c - 1) ++bits;
+
+        while (m_stackLength > bits) {
+            m_stack[m_stackLength - 2] = parentOutput(
+                m_stack[m_stackLength - 2],
+                m_stack[m_stackLength - 1]).chainingValue();
+
+            --m_stackLength;
+        }
+    }
+
+    void pushCV(const BLAKE3_CV& cv, const std::uint64_t counter) {
+        mergeStack(counter);
+        m_stack[m_stackLength++] = cv;
+    }
+
+    Output rootOutput() const {
+        if (0 == m_stackLength) return chunkOutput();
+
+        // roll up the stack, starting from the chunk state if not empty
+        std::size_t remaining = m_stackLength;
+        Output a;
+
+        if (chunkLength() > 0) {
+            a = chunkOutput();
+        } else {
+            remaining -= 2;
+            a = parentOutput(m_stack[remaining], m_stack[remaining + 1]);
+        }
+
+        while (remaining > 0) {
+            --remaining;
+            a = parentOutput(m_stack[remaining], a.chainingValue());
+        }
+
+        return a;
+    }
+
+    std::array<std::uint32_t, 8> m_key;
+    const std::uint32_t m_flags;
+    ThreadPool* m_pool;
+
+    // chunk state
+    std::array<std::uint32_t, 8> m_cv;
+    std::uint64_t m_counter;
+    std::array<std::uint8_t, BLAKE3_BLOCK_OCTETS> m_buf;
+    std::size_t m_bufLength, m_blocksCompressed;
+
+    // 2^54 chunks is 2^64 octets
+    std::array<BLAKE3_CV, 54> m_stack;
+    std::size_t m_stackLength;
+
+    DigType m_digest;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// convenient message digest (as in Digest.hpp)
+//
+
+inline BLAKE3::DigType digest(BLAKE3 hashAlgo, std::istream& is)
+{
+    std::array<char, 64 * 1024> buf;
+
+    while (is) {
+        is.read(buf.data(), buf.size());
+        hashAlgo.update(reinterpret_cast<const std::uint8_t*>(buf.data()),
+                        is.gcount());
+    }
+
+    hashAlgo.computeHash();
+    return hashAlgo.digest();
+}
+
+inline BLAKE3::DigType digest(BLAKE3 hashAlgo, const std::vector<std::uint8_t>& a)
+{
+    hashAlgo.update(a);
+    hashAlgo.computeHash();
+    return hashAlgo.digest();
+}
+
+} // namespace cryptl
+
+#endif
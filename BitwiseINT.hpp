@@ -6,6 +6,8 @@
 #include <climits>
 #include <cstdint>
 
+#include <cryptl/GF256.hpp>
+
 namespace cryptl {
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -151,17 +153,22 @@ public:
 
     // multiplication by x in GF(2^n)
     static T xtime(const T a, const T modpoly) {
-        return testbit(a, sizeof(T) * CHAR_BIT - 1)
-            ? XOR(SHL(a, 1), modpoly)
-            : SHL(a, 1);
+        // reduce with modpoly if high bit is set (without a branch)
+        return XOR(SHL(a, 1),
+                   AND(modpoly, negate(SHR(a, sizeof(T) * CHAR_BIT - 1))));
     }
 
     static T _xtime(const T a, const T modpoly) {
-        return _xtime(a, modpoly);
+        return xtime(a, modpoly);
     }
 
     // multiplication in GF(2^n)
     static T multiply(const T x, const T y, const T modpoly) {
+        // AES field uses log/antilog tables, indexed by the operands so
+        // lookups are visible to cache timing (as is this bit-serial loop)
+        if (1 == sizeof(T) && 0x1b == modpoly)
+            return GF256<T>::multiply(x, y);
+
         T xtmp = x, ytmp = y, xorsum = 0;
         while (ytmp) {
             if (testbit(ytmp, 0)) xorsum = XOR(xorsum, xtmp);
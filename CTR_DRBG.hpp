@@ -0,0 +1,384 @@
+#ifndef _CRYPTL_CTR_DRBG_HPP_
+#define _CRYPTL_CTR_DRBG_HPP_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <random>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include <pthread.h>
+
+#include <cryptl/AES.hpp>
+#include <cryptl/CipherModes.hpp>
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// CTR_DRBG (NIST SP 800-90A Rev. 1, 10.2.1) without derivation function
+//
+// Deterministic random bit generator built on the AES key context. The
+// entropy source must deliver full entropy. Instantiate and reseed read
+// seedlen octets (key length + block length) from it. Personalization
+// strings and additional input are at most seedlen octets.
+//
+// Output blocks are generated through the interleaved cipher lanes, eight
+// counter blocks at a time. generate() is one SP 800-90A request. bytes()
+// serves smaller requests from a buffer refilled by whole requests.
+//
+// The entropy source is the reseeding hook. It is called on instantiation,
+// on reseed() and automatically after reseedInterval requests. Returning
+// false leaves the generator uninstantiated, and generate() fails.
+//
+// A child process reseeds before its first output after fork(), so parent
+// and child never share output (buffered bytes are discarded). The key and
+// V are wiped on uninstantiate() and by the destructor.
+//
+// T is one of the sized AES variants (unmanaged AES128, AES192, AES256 or
+// their drop-in replacements).
+//
+
+// entropy source writes n octets to out, returns false on failure
+typedef std::function<bool (std::uint8_t*, std::size_t)> DRBG_EntropySource;
+
+// operating system entropy, false if std::random_device fails
+inline bool drbgRandomDevice(std::uint8_t* out, const std::size_t n)
+{
+    try {
+        std::random_device rd;
+
+        for (std::size_t i = 0; i < n; i += 4) {
+            const std::uint32_t a = rd();
+
+            for (std::size_t j = 0; j < 4 && i + j < n; ++j)
+                out[i + j] = (a >> (8 * j)) & 0xff;
+        }
+
+    } catch (const std::exception&) {
+        return false;
+    }
+
+    return true;
+}
+
+// number of fork() calls this process descends from, counted in the child
+// from the first call on
+inline std::uint64_t drbgForkCount()
+{
+    static std::atomic<std::uint64_t> count(0);
+    static const int registered = pthread_atfork(
+        nullptr,
+        nullptr,
+        [] { ++count; });
+
+    (void) registered;
+    return count.load();
+}
+
+template <typename T>
+class CTR_DRBG
+{
+public:
+    typedef typename T::KeyType KeyType;
+    typedef typename T::BlockType BlockType;
+    typedef typename T::KeyContext KeyContext;
+
+    static const std::size_t KEY_OCTETS = std::tuple_size<KeyType>::value;
+    static const std::size_t BLOCK_OCTETS = std::tuple_size<BlockType>::value;
+    static const std::size_t SEED_OCTETS = KEY_OCTETS + BLOCK_OCTETS;
+
+    // 2^19 bits per request, 2^48 requests between reseeds
+    static const std::size_t MAX_REQUEST_OCTETS = 1 << 16;
+    static const std::uint64_t MAX_RESEED_INTERVAL = std::uint64_t(1) << 48;
+
+    explicit CTR_DRBG(const DRBG_EntropySource& source = drbgRandomDevice,
+                      const std::vector<std::uint8_t>& personalization
+                          = std::vector<std::uint8_t>(),
+                      const std::size_t bufferOctets = 4096)
+        : m_source(source),
+          m_reseedCounter(0),
+          m_reseedInterval(MAX_RESEED_INTERVAL),
+          m_instantiated(false),
+          m_forkCount(drbgForkCount()),
+          m_buf(bufferOctets < MAX_REQUEST_OCTETS
+                    ? bufferOctets
+                    : std::size_t(MAX_REQUEST_OCTETS)),
+          m_bufPos(m_buf.size())
+    {
+        instantiate(personalization);
+    }
+
+    ~CTR_DRBG() {
+        uninstantiate();
+    }
+
+    bool instantiated() const { return m_instantiated; }
+
+    // 10.2.1.3.1 instantiate, any previous state is discarded
+    bool instantiate(const std::vector<std::uint8_t>& personalization
+                         = std::vector<std::uint8_t>()) {
+        uninstantiate();
+
+        std::array<std::uint8_t, SEED_OCTETS> seed;
+        m_forkCount = drbgForkCount();
+        if (personalization.size() > SEED_OCTETS ||
+            ! m_source(seed.data(), seed.size()))
+            return false;
+
+        for (std::size_t i = 0; i < personalization.size(); ++i)
+            seed[i] ^= personalization[i];
+
+        KeyType key;
+        key.fill(0);
+        m_key.rekey(key, false);
+        m_V.fill(0);
+
+        update(seed);
+        wipe(seed.data(), seed.size());
+        m_reseedCounter = 1;
+        m_instantiated = true;
+        return true;
+    }
+
+    // 9.4 uninstantiate, zeroes the key, V and buffered output
+    void uninstantiate() {
+        m_key.clear();
+        wipe(m_V.data(), m_V.size());
+        wipe(m_buf.data(), m_buf.size());
+        m_bufPos = m_buf.size();
+        m_instantiated = false;
+    }
+
+    // 10.2.1.4.1 reseed
+    bool reseed(const std::vector<std::uint8_t>& additional
+                    = std::vector<std::uint8_t>()) {
+        if (! m_instantiated) return instantiate(additional);
+
+        std::array<std::uint8_t, SEED_OCTETS> seed;
+        m_forkCount = drbgForkCount();
+        if (additional.size() > SEED_OCTETS ||
+            ! m_source(seed.data(), seed.size())) {
+            uninstantiate();
+            return false;
+        }
+
+        for (std::size_t i = 0; i < additional.size(); ++i)
+            seed[i] ^= additional[i];
+
+        update(seed);
+        wipe(seed.data(), seed.size());
+        m_reseedCounter = 1;
+        m_bufPos = m_buf.size();
+        return true;
+    }
+
+    // 10.2.1.5.1 generate, longer output is split into several requests
+    bool generate(std::uint8_t* out,
+                  const std::size_t n,
+                  const std::vector<std::uint8_t>& additional
+                      = std::vector<std::uint8_t>()) {
+        if (additional.size() > SEED_OCTETS) return false;
+
+        std::array<std::uint8_t, SEED_OCTETS> adin;
+        adin.fill(0);
+        for (std::size_t i = 0; i < additional.size(); ++i)
+            adin[i] = additional[i];
+
+        std::array<std::uint8_t, SEED_OCTETS> zero;
+        zero.fill(0);
+
+        std::size_t offset = 0;
+        do {
+            bool withAdin = ! additional.empty();
+
+            // additional input goes to the reseed instead
+            if (m_reseedCounter > m_reseedInterval ||
+                ! m_instantiated ||
+                forked()) {
+                if (! reseed(additional)) return false;
+                withAdin = false;
+            }
+
+            const std::size_t len = n - offset < MAX_REQUEST_OCTETS
+                ? n - offset
+                : std::size_t(MAX_REQUEST_OCTETS);
+
+            if (withAdin) update(adin);
+
+            counterBlocks(out + offset, len);
+            update(withAdin ? adin : zero);
+            ++m_reseedCounter;
+
+            offset += len;
+        } while (offset < n);
+
+        return true;
+    }
+
+    bool generate(std::vector<std::uint8_t>& out,
+                  const std::vector<std::uint8_t>& additional
+                      = std::vector<std::uint8_t>()) {
+        return generate(out.data(), out.size(), additional);
+    }
+
+    // buffered output for small requests
+    bool bytes(std::uint8_t* out, const std::size_t n) {
+        const std::size_t S = m_buf.size();
+
+        // the parent process has the same buffer
+        if (forked()) m_bufPos = S;
+
+        // large requests go directly
+        if (n >= S) return generate(out, n);
+
+        std::size_t idx = 0;
+        while (idx < n) {
+            if (S == m_bufPos) {
+                if (! generate(m_buf.data(), S)) return false;
+                m_bufPos = 0;
+            }
+
+            while (idx < n && m_bufPos < S)
+                out[idx++] = m_buf[m_bufPos++];
+        }
+
+        return true;
+    }
+
+    template <std::size_t N>
+    bool bytes(std::array<std::uint8_t, N>& out) {
+        return bytes(out.data(), N);
+    }
+
+    // fills the vector
+    bool bytes(std::vector<std::uint8_t>& out) {
+        return bytes(out.data(), out.size());
+    }
+
+    void entropySource(const DRBG_EntropySource& source) {
+        m_source = source;
+    }
+
+    // requests between automatic reseeds
+    void reseedInterval(const std::uint64_t n) {
+        m_reseedInterval = n < MAX_RESEED_INTERVAL
+            ? n
+            : std::uint64_t(MAX_RESEED_INTERVAL);
+    }
+
+private:
+    // true in a child process until reseeded
+    bool forked() const {
+        return m_forkCount != drbgForkCount();
+    }
+
+    // volatile, not removed as dead stores
+    static void wipe(std::uint8_t* p, const std::size_t n) {
+        volatile std::uint8_t* a = p;
+        for (std::size_t i = 0; i < n; ++i) a[i] = 0;
+    }
+
+    // n octets of E(Key, V + 1) || E(Key, V + 2) ||...
+    void counterBlocks(std::uint8_t* out, const std::size_t n) {
+        const std::size_t L = 8;
+
+        std::array<const KeyContext*, L> ctx;
+        ctx.fill(&m_key);
+
+        std::array<BlockType, L> inBlock, outBlock;
+
+        std::size_t offset = 0;
+        while (offset < n) {
+            std::size_t k = 0;
+            for (; k < L && offset + k * BLOCK_OCTETS < n; ++k) {
+                incrementCounter(m_V, 1);
+                inBlock[k] = m_V;
+            }
+
+            KeyContext::encryptLanes(ctx, inBlock, outBlock, k);
+
+            for (std::size_t i = 0; i < k; ++i) {
+                for (std::size_t j = 0; j < BLOCK_OCTETS && offset < n; ++j)
+                    out[offset++] = outBlock[i][j];
+            }
+        }
+    }
+
+    // 10.2.1.2 CTR_DRBG_Update
+    void update(const std::array<std::uint8_t, SEED_OCTETS>& provided) {
+        std::array<std::uint8_t, SEED_OCTETS> temp;
+        counterBlocks(temp.data(), temp.size());
+
+        for (std::size_t i = 0; i < SEED_OCTETS; ++i)
+            temp[i] ^= provided[i];
+
+        KeyType key;
+        for (std::size_t i = 0; i < KEY_OCTETS; ++i)
+            key[i] = temp[i];
+
+        m_key.rekey(key, false);
+
+        for (std::size_t i = 0; i < BLOCK_OCTETS; ++i)
+            m_V[i] = temp[KEY_OCTETS + i];
+
+        wipe(temp.data(), temp.size());
+        wipe(key.data(), key.size());
+    }
+
+    DRBG_EntropySource m_source;
+    KeyContext m_key;
+    BlockType m_V;
+    std::uint64_t m_reseedCounter, m_reseedInterval;
+    bool m_instantiated;
+    std::uint64_t m_forkCount;
+
+    std::vector<std::uint8_t> m_buf;
+    std::size_t m_bufPos;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// per-thread generator
+//
+// Each thread has its own instance, so no locking. The personalization
+// string separates the threads even if the entropy source were to repeat.
+//
+
+template <typename T>
+CTR_DRBG<T>& threadDRBG()
+{
+    thread_local CTR_DRBG<T> drbg(
+        drbgRandomDevice,
+        [] {
+            const std::uint64_t
+                a = std::hash<std::thread::id>()(std::this_thread::get_id()),
+                b = std::chrono::high_resolution_clock::now()
+                        .time_since_epoch().count();
+
+            std::vector<std::uint8_t> v;
+            for (std::size_t j = 0; j < 8; ++j) {
+                v.push_back((a >> (8 * j)) & 0xff);
+                v.push_back((b >> (8 * j)) & 0xff);
+            }
+
+            return v;
+        }());
+
+    return drbg;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// typedefs
+//
+
+typedef CTR_DRBG<AES128> CTR_DRBG_AES128;
+typedef CTR_DRBG<AES192> CTR_DRBG_AES192;
+typedef CTR_DRBG<AES256> CTR_DRBG_AES256;
+
+} // namespace cryptl
+
+#endif
@@ -0,0 +1,195 @@
+#ifndef _CRYPTL_CTR_HMAC_HPP_
+#define _CRYPTL_CTR_HMAC_HPP_
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <cryptl/CipherModes.hpp>
+#include <cryptl/HMAC.hpp>
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// fused CTR encryption and HMAC (encrypt-then-MAC)
+//
+// Calling CTR() and then HMAC reads a large buffer from memory twice. Here
+// the data is processed in cache-sized chunks: each chunk is encrypted and
+// its cipher text, still in cache, is hashed straight away. Decryption
+// hashes each cipher text chunk and then decrypts it.
+//
+// The tag covers the initial counter block (IV) followed by the cipher
+// text. Decrypted output must not be used unless verify() returns true.
+// The one-shot CTR_HMAC_Open() wipes the output on failure.
+//
+// T is a sized AES variant (direction of T selects encrypt or decrypt), H
+// an unmanaged SHA for the HMAC.
+//
+
+const std::size_t CTR_HMAC_CHUNK_OCTETS = 4 * 1024;
+
+template <typename T, typename H = SHA256>
+class CTR_HMAC_Context
+{
+public:
+    typedef typename T::BlockType BlockType;
+    typedef typename HMAC<H>::TagType TagType;
+
+    // the key context and HMAC key are copied
+    CTR_HMAC_Context(const typename T::KeyContext& key,
+                     const HMAC<H>& mac,
+                     const BlockType& IV,
+                     const std::size_t chunkOctets = CTR_HMAC_CHUNK_OCTETS)
+        : m_key(key),
+          m_mac(mac),
+          m_counter(IV),
+          m_ksPos(IV.size()),
+          m_chunk(0 == chunkOctets ? IV.size() : chunkOctets)
+    {
+        m_mac.init();
+
+        std::array<std::uint8_t, 16> a;
+        for (std::size_t j = 0; j < IV.size(); ++j) a[j] = IV[j];
+        m_mac.update(a.data(), IV.size());
+    }
+
+    // encrypts or decrypts, any length
+    void update(const std::uint8_t* in,
+                const std::size_t inLength,
+                std::uint8_t* out) {
+        for (std::size_t offset = 0; offset < inLength; offset += m_chunk) {
+            const std::size_t len = inLength - offset < m_chunk
+                ? inLength - offset
+                : m_chunk;
+
+            if (T::isEncryption()) {
+                crypt(in + offset, len, out + offset);
+                m_mac.update(out + offset, len);
+            } else {
+                m_mac.update(in + offset, len);
+                crypt(in + offset, len, out + offset);
+            }
+        }
+    }
+
+    // appends to out
+    void update(const std::vector<std::uint8_t>& in,
+                std::vector<std::uint8_t>& out) {
+        const std::size_t offset = out.size();
+        out.resize(offset + in.size());
+        update(in.data(), in.size(), out.data() + offset);
+    }
+
+    // encryption tag
+    void finalize(TagType& tag) {
+        m_mac.finalize(tag);
+    }
+
+    // decryption, constant time comparison with the received tag
+    bool verify(const TagType& tag) {
+        return m_mac.verify(tag);
+    }
+
+private:
+    // counter mode with the forward cipher, eight blocks interleaved
+    void crypt(const std::uint8_t* in, const std::size_t len, std::uint8_t* out) {
+        typedef typename T::KeyContext KeyContext;
+
+        const std::size_t B = m_counter.size(), L = 8;
+
+        std::size_t idx = 0;
+
+        // rest of the previous key stream block
+        for (; m_ksPos < B && idx < len; ++idx, ++m_ksPos)
+            out[idx] = in[idx] ^ m_ks[m_ksPos];
+
+        std::array<const KeyContext*, L> ctx;
+        ctx.fill(&m_key);
+
+        std::array<BlockType, L> inBlock, outBlock;
+
+        while (idx < len) {
+            const std::size_t n = (len - idx + B - 1) / B < L
+                ? (len - idx + B - 1) / B
+                : L;
+
+            for (std::size_t k = 0; k < n; ++k) {
+                inBlock[k] = m_counter;
+                incrementCounter(m_counter, 1);
+            }
+
+            KeyContext::encryptLanes(ctx, inBlock, outBlock, n);
+
+            for (std::size_t k = 0; k < n; ++k) {
+                if (len - idx >= B) {
+                    for (std::size_t j = 0; j < B; ++j)
+                        out[idx + j] = in[idx + j] ^ outBlock[k][j];
+
+                    idx += B;
+
+                } else {
+                    // partial final block, keep the key stream
+                    m_ks = outBlock[k];
+                    m_ksPos = 0;
+
+                    for (; idx < len; ++idx, ++m_ksPos)
+                        out[idx] = in[idx] ^ m_ks[m_ksPos];
+                }
+            }
+        }
+    }
+
+    const typename T::KeyContext m_key;
+    HMAC<H> m_mac;
+    BlockType m_counter, m_ks;
+    std::size_t m_ksPos;
+    const std::size_t m_chunk;
+};
+
+// encrypt and authenticate, returns cipher text and tag
+template <typename T, typename H>
+std::vector<std::uint8_t> CTR_HMAC_Seal(
+    T dummy,
+    const typename T::KeyContext& key,
+    const HMAC<H>& mac,
+    const typename T::BlockType& IV,
+    const std::vector<std::uint8_t>& inText,
+    typename HMAC<H>::TagType& tag)
+{
+    CTR_HMAC_Context<T, H> ctx(key, mac, IV);
+
+    std::vector<std::uint8_t> outText;
+    ctx.update(inText, outText);
+    ctx.finalize(tag);
+
+    return outText;
+}
+
+// verify and decrypt, returns false (and empty output) if the tag is wrong
+template <typename T, typename H>
+bool CTR_HMAC_Open(
+    T dummy,
+    const typename T::KeyContext& key,
+    const HMAC<H>& mac,
+    const typename T::BlockType& IV,
+    const std::vector<std::uint8_t>& inText,
+    const typename HMAC<H>::TagType& tag,
+    std::vector<std::uint8_t>& outText)
+{
+    CTR_HMAC_Context<T, H> ctx(key, mac, IV);
+
+    outText.clear();
+    ctx.update(inText, outText);
+
+    if (ctx.verify(tag)) return true;
+
+    // never release unauthenticated plain text
+    for (auto& a : outText) a = 0;
+    outText.clear();
+
+    return false;
+}
+
+} // namespace cryptl
+
+#endif
@@ -0,0 +1,327 @@
+#ifndef _CRYPTL_CHACHA20_HPP_
+#define _CRYPTL_CHACHA20_HPP_
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include <cryptl/BitwiseINT.hpp>
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// ChaCha20 (RFC 8439)
+//
+// The block function is written with the BITWISE policy operations
+// (ADDMOD, XOR, ROTL on 32-bit words) like the SHA templates, so it can be
+// instantiated with native or managed words.
+//
+// The native key stream is generated eight blocks at a time. With AVX2,
+// each 256-bit register holds the same state word of eight blocks with
+// consecutive counters. Otherwise the eight blocks are computed in turn.
+//
+
+template <typename T, typename F>
+class ChaCha20_Block
+{
+public:
+    typedef std::array<T, 16> StateType;
+
+    // 20 rounds (10 column and diagonal double rounds), then add the input
+    void operator() (const StateType& in, StateType& out) const {
+        out = in;
+
+        for (std::size_t i = 0; i < 10; ++i) {
+            quarterRound(out, 0, 4, 8, 12);
+            quarterRound(out, 1, 5, 9, 13);
+            quarterRound(out, 2, 6, 10, 14);
+            quarterRound(out, 3, 7, 11, 15);
+
+            quarterRound(out, 0, 5, 10, 15);
+            quarterRound(out, 1, 6, 11, 12);
+            quarterRound(out, 2, 7, 8, 13);
+            quarterRound(out, 3, 4, 9, 14);
+        }
+
+        for (std::size_t i = 0; i < 16; ++i)
+            out[i] = F::ADDMOD(out[i], in[i]);
+    }
+
+private:
+    // RFC 8439 section 2.1
+    static void quarterRound(StateType& x,
+                             const std::size_t a,
+                             const std::size_t b,
+                             const std::size_t c,
+                             const std::size_t d) {
+        x[a] = F::ADDMOD(x[a], x[b]); x[d] = F::ROTL(F::XOR(x[d], x[a]), 16);
+        x[c] = F::ADDMOD(x[c], x[d]); x[b] = F::ROTL(F::XOR(x[b], x[c]), 12);
+        x[a] = F::ADDMOD(x[a], x[b]); x[d] = F::ROTL(F::XOR(x[d], x[a]), 8);
+        x[c] = F::ADDMOD(x[c], x[d]); x[b] = F::ROTL(F::XOR(x[b], x[c]), 7);
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// typedef
+//
+
+typedef ChaCha20_Block<std::uint32_t, BitwiseINT<std::uint32_t>> ChaCha20;
+
+////////////////////////////////////////////////////////////////////////////////
+// native key stream
+//
+
+const std::size_t CHACHA20_LANES = 8;
+
+typedef std::array<std::uint8_t, 32> ChaCha20_KeyType;
+typedef std::array<std::uint8_t, 12> ChaCha20_NonceType;
+
+// initial state (RFC 8439 section 2.3)
+inline ChaCha20::StateType chacha20State(const ChaCha20_KeyType& key,
+                                         const ChaCha20_NonceType& nonce,
+                                         const std::uint32_t counter)
+{
+    ChaCha20::StateType x;
+
+    x[0] = 0x61707865;
+    x[1] = 0x3320646e;
+    x[2] = 0x79622d32;
+    x[3] = 0x6b206574;
+
+    for (std::size_t i = 0; i < 8; ++i) {
+        x[4 + i] = std::uint32_t(key[4*i])
+            | (std::uint32_t(key[4*i + 1]) << 8)
+            | (std::uint32_t(key[4*i + 2]) << 16)
+            | (std::uint32_t(key[4*i + 3]) << 24);
+    }
+
+    x[12] = counter;
+
+    for (std::size_t i = 0; i < 3; ++i) {
+        x[13 + i] = std::uint32_t(nonce[4*i])
+            | (std::uint32_t(nonce[4*i + 1]) << 8)
+            | (std::uint32_t(nonce[4*i + 2]) << 16)
+            | (std::uint32_t(nonce[4*i + 3]) << 24);
+    }
+
+    return x;
+}
+
+#ifdef __AVX2__
+// eight blocks with counters x[12],...,x[12] + 7
+inline void chacha20Lanes(const ChaCha20::StateType& x, std::uint8_t* out)
+{
+    const __m256i rot16 = _mm256_set_epi8(
+        13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2,
+        13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2);
+
+    const __m256i rot8 = _mm256_set_epi8(
+        14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3,
+        14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3);
+
+    __m256i in[16], v[16];
+
+    for (std::size_t i = 0; i < 16; ++i)
+        in[i] = _mm256_set1_epi32(x[i]);
+
+    in[12] = _mm256_add_epi32(in[12], _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+
+    for (std::size_t i = 0; i < 16; ++i)
+        v[i] = in[i];
+
+#define CRYPTL_CHACHA20_QR(a, b, c, d)                                       \
+    v[a] = _mm256_add_epi32(v[a], v[b]);                                     \
+    v[d] = _mm256_shuffle_epi8(_mm256_xor_si256(v[d], v[a]), rot16);         \
+    v[c] = _mm256_add_epi32(v[c], v[d]);                                     \
+    v[b] = _mm256_xor_si256(v[b], v[c]);                                     \
+    v[b] = _mm256_or_si256(_mm256_slli_epi32(v[b], 12),                      \
+                           _mm256_srli_epi32(v[b], 20));                     \
+    v[a] = _mm256_add_epi32(v[a], v[b]);                                     \
+    v[d] = _mm256_shuffle_epi8(_mm256_xor_si256(v[d], v[a]), rot8);          \
+    v[c] = _mm256_add_epi32(v[c], v[d]);                                     \
+    v[b] = _mm256_xor_si256(v[b], v[c]);                                     \
+    v[b] = _mm256_or_si256(_mm256_slli_epi32(v[b], 7),                       \
+                           _mm256_srli_epi32(v[b], 25));
+
+    for (std::size_t i = 0; i < 10; ++i) {
+        CRYPTL_CHACHA20_QR(0, 4, 8, 12)
+        CRYPTL_CHACHA20_QR(1, 5, 9, 13)
+        CRYPTL_CHACHA20_QR(2, 6, 10, 14)
+        CRYPTL_CHACHA20_QR(3, 7, 11, 15)
+
+        CRYPTL_CHACHA20_QR(0, 5, 10, 15)
+        CRYPTL_CHACHA20_QR(1, 6, 11, 12)
+        CRYPTL_CHACHA20_QR(2, 7, 8, 13)
+        CRYPTL_CHACHA20_QR(3, 4, 9, 14)
+    }
+
+#undef CRYPTL_CHACHA20_QR
+
+    for (std::size_t i = 0; i < 16; ++i)
+        v[i] = _mm256_add_epi32(v[i], in[i]);
+
+    // transpose words 0-7 and 8-15 from word order to block order
+    for (std::size_t h = 0; h < 2; ++h) {
+        const __m256i* r = v + 8*h;
+
+        const __m256i
+            t0 = _mm256_unpacklo_epi32(r[0], r[1]),
+            t1 = _mm256_unpackhi_epi32(r[0], r[1]),
+            t2 = _mm256_unpacklo_epi32(r[2], r[3]),
+            t3 = _mm256_unpackhi_epi32(r[2], r[3]),
+            t4 = _mm256_unpacklo_epi32(r[4], r[5]),
+            t5 = _mm256_unpackhi_epi32(r[4], r[5]),
+            t6 = _mm256_unpacklo_epi32(r[6], r[7]),
+            t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+
+        const __m256i u[8] = {
+            _mm256_unpacklo_epi64(t0, t2),
+            _mm256_unpackhi_epi64(t0, t2),
+            _mm256_unpacklo_epi64(t1, t3),
+            _mm256_unpackhi_epi64(t1, t3),
+            _mm256_unpacklo_epi64(t4, t6),
+            _mm256_unpackhi_epi64(t4, t6),
+            _mm256_unpacklo_epi64(t5, t7),
+            _mm256_unpackhi_epi64(t5, t7) };
+
+        for (std::size_t k = 0; k < 4; ++k) {
+            _mm256_storeu_si256(
+                reinterpret_cast<__m256i*>(out + 64*k + 32*h),
+                _mm256_permute2x128_si256(u[k], u[k + 4], 0x20));
+
+            _mm256_storeu_si256(
+                reinterpret_cast<__m256i*>(out + 64*(k + 4) + 32*h),
+                _mm256_permute2x128_si256(u[k], u[k + 4], 0x31));
+        }
+    }
+}
+#endif
+
+// n blocks of key stream, the block counter x[12] is advanced by n (and
+// wraps, callers stay within the 2^32 blocks of a nonce)
+inline void chacha20Blocks(ChaCha20::StateType& x,
+                           std::uint8_t* out,
+                           std::size_t n)
+{
+#ifdef __AVX2__
+    for (; n >= CHACHA20_LANES; n -= CHACHA20_LANES) {
+        chacha20Lanes(x, out);
+        x[12] += CHACHA20_LANES;
+        out += 64 * CHACHA20_LANES;
+    }
+#endif
+
+    const ChaCha20 block;
+    ChaCha20::StateType y;
+
+    for (; n > 0; --n) {
+        block(x, y);
+        ++x[12];
+
+        for (std::size_t i = 0; i < 16; ++i) {
+            for (std::size_t j = 0; j < 4; ++j)
+                *out++ = (y[i] >> (8 * j)) & 0xff;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ChaCha20 stream context (chunked input of any size)
+//
+// The 32-bit block counter limits the key stream of a key and nonce to
+// 2^32 blocks (256 GiB) from counter 0 (RFC 8439 section 2.4). Input past
+// the end is refused rather than encrypted with a repeated key stream.
+//
+
+class ChaCha20_Context
+{
+public:
+    typedef ChaCha20_KeyType KeyType;
+    typedef ChaCha20_NonceType NonceType;
+
+    ChaCha20_Context(const KeyType& key,
+                     const NonceType& nonce,
+                     const std::uint32_t counter = 0)
+        : m_state(chacha20State(key, nonce, counter)),
+          m_ksPos(0),
+          m_ksLength(0),
+          m_remaining(64 * ((std::uint64_t(1) << 32) - counter))
+    {}
+
+    // key stream octets left before the block counter wraps
+    std::uint64_t remaining() const { return m_remaining; }
+
+    // encrypts or decrypts, returns number of octets written to out, 0
+    // (nothing written) if the input is longer than remaining()
+    std::size_t update(const std::uint8_t* in,
+                       const std::size_t inLength,
+                       std::uint8_t* out) {
+        if (inLength > m_remaining) return 0;
+        m_remaining -= inLength;
+
+        std::size_t idx = 0;
+
+        while (idx < inLength) {
+            // up to eight blocks, only as many as needed for short input
+            if (m_ksLength == m_ksPos) {
+                const std::size_t n = (inLength - idx + 63) / 64;
+                m_ksLength = 64 * (n < CHACHA20_LANES ? n : CHACHA20_LANES);
+                chacha20Blocks(m_state, m_ks.data(), m_ksLength / 64);
+                m_ksPos = 0;
+            }
+
+            const std::size_t N = m_ksLength - m_ksPos < inLength - idx
+                ? m_ksLength - m_ksPos
+                : inLength - idx;
+
+            // local pointers, out may alias the members
+            const std::uint8_t* ks = m_ks.data() + m_ksPos;
+            const std::uint8_t* a = in + idx;
+            std::uint8_t* b = out + idx;
+
+            // eight octets at a time
+            std::size_t j = 0;
+            for (; j + 8 <= N; j += 8) {
+                std::uint64_t u, v;
+                std::memcpy(&u, a + j, 8);
+                std::memcpy(&v, ks + j, 8);
+                u ^= v;
+                std::memcpy(b + j, &u, 8);
+            }
+
+            for (; j < N; ++j)
+                b[j] = a[j] ^ ks[j];
+
+            idx += N;
+            m_ksPos += N;
+        }
+
+        return inLength;
+    }
+
+    // appends to out, false if the input is longer than remaining()
+    bool update(const std::vector<std::uint8_t>& in,
+                std::vector<std::uint8_t>& out) {
+        if (in.size() > m_remaining) return false;
+
+        const std::size_t offset = out.size();
+        out.resize(offset + in.size());
+        update(in.data(), in.size(), out.data() + offset);
+        return true;
+    }
+
+private:
+    ChaCha20::StateType m_state;
+    std::array<std::uint8_t, 64 * CHACHA20_LANES> m_ks;
+    std::size_t m_ksPos, m_ksLength;
+    std::uint64_t m_remaining;
+};
+
+} // namespace cryptl
+
+#endif
@@ -0,0 +1,211 @@
+#ifndef _CRYPTL_CHACHA20_POLY1305_HPP_
+#define _CRYPTL_CHACHA20_POLY1305_HPP_
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <cryptl/ChaCha20.hpp>
+#include <cryptl/Poly1305.hpp>
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// ChaCha20-Poly1305 AEAD (RFC 8439 section 2.8)
+//
+// Software cipher for hosts without fast AES. The context streams input
+// of any chunk size like the AES mode contexts: update() encrypts or
+// decrypts, finalize() returns the tag after encryption and verify()
+// checks it after decryption. Decrypted output must not be used unless
+// verify() returns true. The one-shot ChaChaPoly_Open() wipes the output
+// on failure.
+//
+// The additional authenticated data is passed to the constructor. A
+// message is at most 2^32 - 1 blocks of 64 octets (RFC 8439 section 2.8),
+// update() refuses input past that.
+//
+
+class CHACHA20_POLY1305
+{
+public:
+    typedef ChaCha20_KeyType KeyType;
+    typedef ChaCha20_NonceType NonceType;
+    typedef Poly1305::TagType TagType;
+
+    static bool isEncryption() { return true; }
+    static bool isDecryption() { return false; }
+};
+
+class UNCHACHA20_POLY1305
+{
+public:
+    typedef ChaCha20_KeyType KeyType;
+    typedef ChaCha20_NonceType NonceType;
+    typedef Poly1305::TagType TagType;
+
+    static bool isEncryption() { return false; }
+    static bool isDecryption() { return true; }
+};
+
+template <typename T>
+class ChaChaPoly_Context
+{
+public:
+    typedef typename T::KeyType KeyType;
+    typedef typename T::NonceType NonceType;
+    typedef typename T::TagType TagType;
+
+    ChaChaPoly_Context(const KeyType& key,
+                       const NonceType& nonce,
+                       const std::uint8_t* aad,
+                       const std::size_t aadLength)
+        : m_cipher(key, nonce, 1),
+          m_mac(oneTimeKey(key, nonce)),
+          m_aadLength(aadLength),
+          m_textLength(0)
+    {
+        m_mac.update(aad, aadLength);
+        m_mac.padBlock();
+    }
+
+    ChaChaPoly_Context(const KeyType& key,
+                       const NonceType& nonce,
+                       const std::vector<std::uint8_t>& aad
+                           = std::vector<std::uint8_t>())
+        : ChaChaPoly_Context(key, nonce, aad.data(), aad.size())
+    {}
+
+    // returns number of octets written to out, 0 (nothing written or
+    // authenticated) if the message would be too long
+    std::size_t update(const std::uint8_t* in,
+                       const std::size_t inLength,
+                       std::uint8_t* out) {
+        if (inLength > m_cipher.remaining()) return 0;
+        m_textLength += inLength;
+
+        // cache-sized chunks, the cipher text is hashed while still in cache
+        const std::size_t C = 4096;
+
+        for (std::size_t offset = 0; offset < inLength; offset += C) {
+            const std::size_t len = inLength - offset < C
+                ? inLength - offset
+                : C;
+
+            if (T::isEncryption()) {
+                m_cipher.update(in + offset, len, out + offset);
+                m_mac.update(out + offset, len);
+            } else {
+                m_mac.update(in + offset, len);
+                m_cipher.update(in + offset, len, out + offset);
+            }
+        }
+
+        return inLength;
+    }
+
+    // appends to out, false if the message would be too long
+    bool update(const std::vector<std::uint8_t>& in,
+                std::vector<std::uint8_t>& out) {
+        if (in.size() > m_cipher.remaining()) return false;
+
+        const std::size_t offset = out.size();
+        out.resize(offset + in.size());
+        update(in.data(), in.size(), out.data() + offset);
+        return true;
+    }
+
+    // encryption tag
+    void finalize(TagType& tag) {
+        m_mac.padBlock();
+
+        std::array<std::uint8_t, 16> a;
+        for (std::size_t j = 0; j < 8; ++j) {
+            a[j] = (std::uint64_t(m_aadLength) >> (8 * j)) & 0xff;
+            a[8 + j] = (std::uint64_t(m_textLength) >> (8 * j)) & 0xff;
+        }
+
+        m_mac.update(a.data(), a.size());
+        m_mac.finalize(tag);
+    }
+
+    // decryption, constant time comparison with the received tag
+    bool verify(const TagType& tag) {
+        TagType a;
+        finalize(a);
+
+        std::uint8_t diff = 0;
+        for (std::size_t i = 0; i < a.size(); ++i)
+            diff |= a[i] ^ tag[i];
+
+        return 0 == diff;
+    }
+
+private:
+    // first 32 octets of block 0 (RFC 8439 section 2.6)
+    static Poly1305::KeyType oneTimeKey(const KeyType& key,
+                                        const NonceType& nonce) {
+        ChaCha20::StateType x = chacha20State(key, nonce, 0);
+
+        std::array<std::uint8_t, 64> a;
+        chacha20Blocks(x, a.data(), 1);
+
+        Poly1305::KeyType k;
+        for (std::size_t i = 0; i < k.size(); ++i)
+            k[i] = a[i];
+
+        return k;
+    }
+
+    ChaCha20_Context m_cipher;
+    Poly1305 m_mac;
+    std::size_t m_aadLength, m_textLength;
+};
+
+// encrypt and authenticate, returns cipher text and tag (empty with a zero
+// tag if the message is too long)
+inline std::vector<std::uint8_t> ChaChaPoly_Seal(
+    const CHACHA20_POLY1305::KeyType& key,
+    const CHACHA20_POLY1305::NonceType& nonce,
+    const std::vector<std::uint8_t>& aad,
+    const std::vector<std::uint8_t>& inText,
+    CHACHA20_POLY1305::TagType& tag)
+{
+    ChaChaPoly_Context<CHACHA20_POLY1305> ctx(key, nonce, aad);
+
+    std::vector<std::uint8_t> outText;
+    if (! ctx.update(inText, outText)) {
+        tag.fill(0);
+        return outText;
+    }
+
+    ctx.finalize(tag);
+
+    return outText;
+}
+
+// verify and decrypt, returns false (and empty output) if the tag is wrong
+inline bool ChaChaPoly_Open(
+    const UNCHACHA20_POLY1305::KeyType& key,
+    const UNCHACHA20_POLY1305::NonceType& nonce,
+    const std::vector<std::uint8_t>& aad,
+    const std::vector<std::uint8_t>& inText,
+    const UNCHACHA20_POLY1305::TagType& tag,
+    std::vector<std::uint8_t>& outText)
+{
+    ChaChaPoly_Context<UNCHACHA20_POLY1305> ctx(key, nonce, aad);
+
+    outText.clear();
+    if (! ctx.update(inText, outText)) return false;
+
+    if (ctx.verify(tag)) return true;
+
+    // never release unauthenticated plain text
+    for (auto& a : outText) a = 0;
+    outText.clear();
+
+    return false;
+}
+
+} // namespace cryptl
+
+#endif
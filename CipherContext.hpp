@@ -0,0 +1,359 @@
+#ifndef _CRYPTL_CIPHER_CONTEXT_HPP_
+#define _CRYPTL_CIPHER_CONTEXT_HPP_
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// block cipher mode contexts (stateful, chunked input)
+//
+// The one-shot functions in CipherModes.hpp need the entire message in
+// memory. A context holds the key context (expanded key schedules) and the
+// chaining value between calls to update(), so input may arrive in chunks
+// of any size. Partial blocks are buffered until the next call. The
+// finalize() call flushes the buffer, with optional PKCS#7 padding.
+//
+// With padding, decryption holds back the last full block until finalize()
+// as it carries the padding. Without padding, ECB and CBC require a whole
+// number of blocks while OFB and CFB truncate the final keystream block.
+//
+// update() writes at most (inLength + block size) elements to out.
+// finalize() writes at most one block. When it fails, the buffer is
+// discarded and any decrypted block in out is zeroed. The padding check
+// does not branch on the padding bytes.
+//
+
+template <typename CRTP, typename T, typename U>
+class CipherContext
+{
+public:
+    typedef typename T::BlockType BlockType;
+
+    // returns number of elements written to out
+    std::size_t update(const U* in, const std::size_t inLength, U* out) {
+        const std::size_t B = m_buf.size();
+        auto* ptr = static_cast<CRTP*>(this);
+
+        // decryption of padded text holds back the last full block
+        const std::size_t holdBack = holdBlock() ? 1 : 0;
+
+        std::size_t inIdx = 0, outIdx = 0;
+
+        // complete buffered partial block
+        if (m_bufLength > 0) {
+            while (m_bufLength < B && inIdx < inLength)
+                m_buf[m_bufLength++] = in[inIdx++];
+
+            if (B == m_bufLength && (inIdx < inLength || !holdBack)) {
+                ptr->cryptBlock(m_buf, out + outIdx);
+                outIdx += B;
+                m_bufLength = 0;
+            }
+        }
+
+        // whole blocks directly from input
+        while (0 == m_bufLength && inLength - inIdx >= B + holdBack) {
+            for (std::size_t j = 0; j < B; ++j)
+                m_block[j] = in[inIdx + j];
+
+            ptr->cryptBlock(m_block, out + outIdx);
+            inIdx += B;
+            outIdx += B;
+        }
+
+        // buffer remainder
+        while (inIdx < inLength)
+            m_buf[m_bufLength++] = in[inIdx++];
+
+        return outIdx;
+    }
+
+    // appends to out
+    void update(const std::vector<U>& in, std::vector<U>& out) {
+        const std::size_t offset = out.size();
+        out.resize(offset + in.size() + m_buf.size());
+        const std::size_t N = update(in.data(), in.size(), out.data() + offset);
+        out.resize(offset + N);
+    }
+
+    // returns false if remaining input is not well formed
+    bool finalize(U* out, std::size_t& outLength) {
+        const std::size_t B = m_buf.size();
+        auto* ptr = static_cast<CRTP*>(this);
+
+        outLength = 0;
+
+        if (m_padding && T::isEncryption()) {
+            // PKCS#7 padding adds 1 to B octets
+            const std::size_t pad = B - m_bufLength;
+            while (m_bufLength < B)
+                m_buf[m_bufLength++] = pad;
+
+            ptr->cryptBlock(m_buf, out);
+            outLength = B;
+
+        } else if (m_padding) {
+            // padded cipher text must be a whole number of blocks
+            if (B != m_bufLength) {
+                m_bufLength = 0;
+                return false;
+            }
+
+            ptr->cryptBlock(m_buf, out);
+
+            // accumulate the difference as macVerify() does
+            const std::size_t pad = out[B - 1];
+            unsigned int diff = (0 == pad) | (pad > B);
+            for (std::size_t j = 0; j < B; ++j)
+                diff |= (j + pad >= B) * (pad ^ out[j]);
+
+            if (0 != diff) {
+                // never release the unpadded block
+                for (std::size_t j = 0; j < B; ++j) out[j] = 0;
+                m_bufLength = 0;
+                return false;
+            }
+
+            outLength = B - pad;
+
+        } else if (m_bufLength > 0) {
+            if (! ptr->cryptPartial(m_buf, m_bufLength, out)) {
+                m_bufLength = 0;
+                return false;
+            }
+
+            outLength = m_bufLength;
+        }
+
+        m_bufLength = 0;
+        return true;
+    }
+
+    // appends to out
+    bool finalize(std::vector<U>& out) {
+        const std::size_t offset = out.size();
+        out.resize(offset + m_buf.size());
+
+        std::size_t N;
+        const bool status = finalize(out.data() + offset, N);
+
+        out.resize(offset + N);
+        return status;
+    }
+
+protected:
+    CipherContext(const typename T::KeyContext& key, const bool padding)
+        : m_key(key),
+          m_padding(padding),
+          m_bufLength(0)
+    {}
+
+    // write cipher output element-wise
+    static void output(const BlockType& a, U* out) {
+        for (std::size_t j = 0; j < a.size(); ++j)
+            out[j] = a[j];
+    }
+
+    // stream modes can truncate the last block, block modes can not
+    bool cryptPartial(const BlockType&, const std::size_t, U*) {
+        return false;
+    }
+
+    const typename T::KeyContext m_key;
+
+private:
+    bool holdBlock() const {
+        return m_padding && T::isDecryption();
+    }
+
+    const bool m_padding;
+    BlockType m_buf, m_block;
+    std::size_t m_bufLength;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// electronic code book mode (ECB)
+//
+
+template <typename T, typename U = typename T::VarType>
+class ECB_Context : public CipherContext<ECB_Context<T, U>, T, U>
+{
+    typedef CipherContext<ECB_Context<T, U>, T, U> Base;
+
+public:
+    typedef typename T::BlockType BlockType;
+
+    ECB_Context(const typename T::KeyContext& key,
+                const bool padding = false)
+        : Base(key, padding)
+    {}
+
+    ECB_Context(const typename T::KeyType& key,
+                const bool padding = false)
+        : Base(typename T::KeyContext(key, T::isDecryption()), padding)
+    {}
+
+    void cryptBlock(const BlockType& inBlock, U* out) {
+        if (T::isEncryption())
+            this->m_key.encrypt(inBlock, m_outBlock);
+        else
+            this->m_key.decrypt(inBlock, m_outBlock);
+
+        Base::output(m_outBlock, out);
+    }
+
+private:
+    BlockType m_outBlock;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// cipher block chaining mode (CBC)
+//
+
+template <typename T, typename U = typename T::VarType>
+class CBC_Context : public CipherContext<CBC_Context<T, U>, T, U>
+{
+    typedef CipherContext<CBC_Context<T, U>, T, U> Base;
+
+public:
+    typedef typename T::BlockType BlockType;
+
+    CBC_Context(const typename T::KeyContext& key,
+                const BlockType& IV,
+                const bool padding = false)
+        : Base(key, padding),
+          m_lastBlock(IV)
+    {}
+
+    CBC_Context(const typename T::KeyType& key,
+                const BlockType& IV,
+                const bool padding = false)
+        : Base(typename T::KeyContext(key, T::isDecryption()), padding),
+          m_lastBlock(IV)
+    {}
+
+    void cryptBlock(const BlockType& inBlock, U* out) {
+        const std::size_t B = inBlock.size();
+
+        if (T::isEncryption()) {
+            for (std::size_t j = 0; j < B; ++j)
+                m_xorBlock[j] = inBlock[j] ^ m_lastBlock[j];
+
+            this->m_key.encrypt(m_xorBlock, m_lastBlock);
+            Base::output(m_lastBlock, out);
+
+        } else { // isDecryption
+            this->m_key.decrypt(inBlock, m_xorBlock);
+
+            for (std::size_t j = 0; j < B; ++j)
+                out[j] = m_xorBlock[j] ^ m_lastBlock[j];
+
+            m_lastBlock = inBlock;
+        }
+    }
+
+private:
+    BlockType m_lastBlock, m_xorBlock;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// output feedback mode (OFB)
+//
+
+template <typename T, typename U = typename T::VarType>
+class OFB_Context : public CipherContext<OFB_Context<T, U>, T, U>
+{
+    typedef CipherContext<OFB_Context<T, U>, T, U> Base;
+
+public:
+    typedef typename T::BlockType BlockType;
+
+    OFB_Context(const typename T::KeyContext& key,
+                const BlockType& IV,
+                const bool padding = false)
+        : Base(key, padding),
+          m_lastBlock(IV)
+    {}
+
+    OFB_Context(const typename T::KeyType& key,
+                const BlockType& IV,
+                const bool padding = false)
+        : Base(typename T::KeyContext(key, false), padding),
+          m_lastBlock(IV)
+    {}
+
+    void cryptBlock(const BlockType& inBlock, U* out) {
+        cryptPartial(inBlock, inBlock.size(), out);
+    }
+
+    bool cryptPartial(const BlockType& inBlock, const std::size_t N, U* out) {
+        // the forward cipher in both directions
+        this->m_key.encrypt(m_lastBlock, m_outBlock);
+        m_lastBlock = m_outBlock;
+
+        for (std::size_t j = 0; j < N; ++j)
+            out[j] = m_outBlock[j] ^ inBlock[j];
+
+        return true;
+    }
+
+private:
+    BlockType m_lastBlock, m_outBlock;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// cipher feedback mode (CFB)
+//
+
+template <typename T, typename U = typename T::VarType>
+class CFB_Context : public CipherContext<CFB_Context<T, U>, T, U>
+{
+    typedef CipherContext<CFB_Context<T, U>, T, U> Base;
+
+public:
+    typedef typename T::BlockType BlockType;
+
+    CFB_Context(const typename T::KeyContext& key,
+                const BlockType& IV,
+                const bool padding = false)
+        : Base(key, padding),
+          m_lastBlock(IV)
+    {}
+
+    CFB_Context(const typename T::KeyType& key,
+                const BlockType& IV,
+                const bool padding = false)
+        : Base(typename T::KeyContext(key, false), padding),
+          m_lastBlock(IV)
+    {}
+
+    void cryptBlock(const BlockType& inBlock, U* out) {
+        cryptPartial(inBlock, inBlock.size(), out);
+    }
+
+    bool cryptPartial(const BlockType& inBlock, const std::size_t N, U* out) {
+        // the forward cipher in both directions
+        this->m_key.encrypt(m_lastBlock, m_outBlock);
+
+        for (std::size_t j = 0; j < N; ++j)
+            out[j] = m_outBlock[j] ^ inBlock[j];
+
+        // feedback is the cipher text (only needed after a whole block)
+        if (N == inBlock.size()) {
+            for (std::size_t j = 0; j < N; ++j)
+                m_lastBlock[j] = T::isEncryption() ? out[j] : inBlock[j];
+        }
+
+        return true;
+    }
+
+private:
+    BlockType m_lastBlock, m_outBlock;
+};
+
+} // namespace cryptl
+
+#endif
@@ -11,16 +11,42 @@ namespace cryptl {
 // block cipher modes
 //
 
+// add to counter block as big-endian integer
+template <typename BLK>
+void incrementCounter(BLK& ctr, std::uint64_t n)
+{
+    unsigned int carry = 0;
+    for (std::size_t j = ctr.size(); j > 0 && (0 != n || 0 != carry); --j) {
+        const unsigned int sum = ctr[j - 1] + (n & 0xff) + carry;
+        ctr[j - 1] = sum & 0xff;
+        carry = sum >> 8;
+        n >>= 8;
+    }
+}
+
+// forward or inverse cipher for direction of T
+template <typename T>
+void cryptBlock(T dummy,
+                const typename T::KeyContext& key,
+                const typename T::BlockType& inBlock,
+                typename T::BlockType& outBlock)
+{
+    if (T::isEncryption())
+        key.encrypt(inBlock, outBlock);
+    else
+        key.decrypt(inBlock, outBlock);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// modes with a key context (key schedule expanded once)
+//
+
 // electronic code book mode (ECB)
 template <typename T, typename U>
 std::vector<U> ECB(T dummy,
-                   const typename T::KeyType& key,
+                   const typename T::KeyContext& key,
                    const std::vector<U>& inText)
 {
-    typename T::ScheduleType scheduleBlock;
-    typename T::KeyExpansion keyExpand;
-    keyExpand(key, scheduleBlock);
-
     typename T::BlockType inBlock, outBlock;
     const std::size_t B = inBlock.size();
     const std::size_t N = inText.size() / B;
@@ -30,14 +56,13 @@ std::vector<U> ECB(T dummy,
 #endif
     std::vector<U> outText(inText.size());
 
-    typename T::Algo algo;
     for (std::size_t i = 0; i < N; ++i) {
         const std::size_t offset = i * B;
 
         for (std::size_t j = 0; j < B; ++j)
             inBlock[j] = inText[j + offset];
 
-        algo(inBlock, outBlock, scheduleBlock);
+        cryptBlock(dummy, key, inBlock, outBlock);
 
         for (std::size_t j = 0; j < B; ++j)
             outText[j + offset] = outBlock[j];
@@ -49,14 +74,10 @@ std::vector<U> ECB(T dummy,
 // cipher block chaining mode (CBC)
 template <typename T, typename U>
 std::vector<U> CBC(T dummy,
-                   const typename T::KeyType& key,
+                   const typename T::KeyContext& key,
                    const typename T::BlockType& IV,
                    const std::vector<U>& inText)
 {
-    typename T::ScheduleType scheduleBlock;
-    typename T::KeyExpansion keyExpand;
-    keyExpand(key, scheduleBlock);
-
     typename T::BlockType inBlock, outBlock, lastBlock = IV;
     const std::size_t B = inBlock.size();
     const std::size_t N = inText.size() / B;
@@ -66,7 +87,6 @@ std::vector<U> CBC(T dummy,
 #endif
     std::vector<U> outText(inText.size());
 
-    typename T::Algo algo;
     for (std::size_t i = 0; i < N; ++i) {
         const std::size_t offset = i * B;
 
@@ -74,7 +94,7 @@ std::vector<U> CBC(T dummy,
             for (std::size_t j = 0; j < B; ++j)
                 inBlock[j] = inText[j + offset] ^ lastBlock[j];
 
-            algo(inBlock, outBlock, scheduleBlock);
+            cryptBlock(dummy, key, inBlock, outBlock);
 
             for (std::size_t j = 0; j < B; ++j)
                 outText[j + offset] = outBlock[j];
@@ -85,7 +105,7 @@ std::vector<U> CBC(T dummy,
             for (std::size_t j = 0; j < B; ++j)
                 inBlock[j] = inText[j + offset];
 
-            algo(inBlock, outBlock, scheduleBlock);
+            cryptBlock(dummy, key, inBlock, outBlock);
 
             for (std::size_t j = 0; j < B; ++j)
                 outText[j + offset] = outBlock[j] ^ lastBlock[j];
@@ -100,14 +120,10 @@ std::vector<U> CBC(T dummy,
 // output feedback mode (OFB)
 template <typename T, typename U>
 std::vector<U> OFB(T dummy,
-                   const typename T::KeyType& key,
+                   const typename T::KeyContext& key,
                    const typename T::BlockType& IV,
                    const std::vector<U>& inText)
 {
-    typename T::ScheduleType scheduleBlock;
-    typename T::KeyExpansion keyExpand;
-    keyExpand(key, scheduleBlock);
-
     typename T::BlockType inBlock = IV, outBlock;
     const std::size_t B = inBlock.size();
     const std::size_t N = inText.size() / B;
@@ -117,11 +133,11 @@ std::vector<U> OFB(T dummy,
 #endif
     std::vector<U> outText(inText.size());
 
-    typename T::Algo algo;
+    // the forward cipher in both directions
     for (std::size_t i = 0; i < N; ++i) {
         const std::size_t offset = i * B;
 
-        algo(inBlock, outBlock, scheduleBlock);
+        key.encrypt(inBlock, outBlock);
         inBlock = outBlock;
 
         for (std::size_t j = 0; j < B; ++j)
@@ -134,14 +150,10 @@ std::vector<U> OFB(T dummy,
 // cipher feedback mode (CFB)
 template <typename T, typename U>
 std::vector<U> CFB(T dummy,
-                   const typename T::KeyType& key,
+                   const typename T::KeyContext& key,
                    const typename T::BlockType& IV,
                    const std::vector<U>& inText)
 {
-    typename T::ScheduleType scheduleBlock;
-    typename T::KeyExpansion keyExpand;
-    keyExpand(key, scheduleBlock);
-
     typename T::BlockType inBlock, outBlock, lastBlock = IV;
     const std::size_t B = inBlock.size();
     const std::size_t N = inText.size() / B;
@@ -151,21 +163,103 @@ std::vector<U> CFB(T dummy,
 #endif
     std::vector<U> outText(inText.size());
 
-    typename T::Algo algo;
+    // the forward cipher in both directions
     for (std::size_t i = 0; i < N; ++i) {
         const std::size_t offset = i * B;
 
         inBlock = lastBlock;
-        algo(inBlock, outBlock, scheduleBlock);
-        lastBlock = T::isEncryption() ? outBlock : inBlock;
+        key.encrypt(inBlock, outBlock);
+
+        for (std::size_t j = 0; j < B; ++j)
+            outText[j + offset] = outBlock[j] ^ inText[j + offset];
 
+        // feedback is the cipher text
         for (std::size_t j = 0; j < B; ++j)
+            lastBlock[j] = T::isEncryption()
+                ? outText[j + offset]
+                : inText[j + offset];
+    }
+
+    return outText;
+}
+
+// counter mode (CTR)
+// input may be any length, the counter block increments as a 128-bit
+// big-endian integer (SP 800-38A standard incrementing function)
+template <typename T, typename U>
+std::vector<U> CTR(T dummy,
+                   const typename T::KeyContext& key,
+                   const typename T::BlockType& IV,
+                   const std::vector<U>& inText)
+{
+    typename T::BlockType inBlock = IV, outBlock;
+    const std::size_t B = inBlock.size();
+    std::vector<U> outText(inText.size());
+
+    // the forward cipher in both directions
+    for (std::size_t offset = 0; offset < inText.size(); offset += B) {
+        key.encrypt(inBlock, outBlock);
+        incrementCounter(inBlock, 1);
+
+        for (std::size_t j = 0; j < B && j + offset < inText.size(); ++j)
             outText[j + offset] = outBlock[j] ^ inText[j + offset];
     }
 
     return outText;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// one-shot modes (key schedule expanded for each call)
+//
+
+template <typename T, typename U>
+std::vector<U> ECB(T dummy,
+                   const typename T::KeyType& key,
+                   const std::vector<U>& inText)
+{
+    return ECB(dummy,
+               typename T::KeyContext(key, T::isDecryption()),
+               inText);
+}
+
+template <typename T, typename U>
+std::vector<U> CBC(T dummy,
+                   const typename T::KeyType& key,
+                   const typename T::BlockType& IV,
+                   const std::vector<U>& inText)
+{
+    return CBC(dummy,
+               typename T::KeyContext(key, T::isDecryption()),
+               IV, inText);
+}
+
+template <typename T, typename U>
+std::vector<U> OFB(T dummy,
+                   const typename T::KeyType& key,
+                   const typename T::BlockType& IV,
+                   const std::vector<U>& inText)
+{
+    return OFB(dummy, typename T::KeyContext(key, false), IV, inText);
+}
+
+template <typename T, typename U>
+std::vector<U> CFB(T dummy,
+                   const typename T::KeyType& key,
+                   const typename T::BlockType& IV,
+                   const std::vector<U>& inText)
+{
+    return CFB(dummy, typename T::KeyContext(key, false), IV, inText);
+}
+
+template <typename T, typename U>
+std::vector<U> CTR(T dummy,
+                   const typename T::KeyType& key,
+                   const typename T::BlockType& IV,
+                   const std::vector<U>& inText)
+{
+    return CTR(dummy, typename T::KeyContext(key, false), IV, inText);
+}
+
 } // namespace cryptl
 
 #endif
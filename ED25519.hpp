@@ -7,10 +7,12 @@
 #include <vector>
 
 #include <cryptl/BitwiseINT.hpp>
+#include <cryptl/ED25519_fe10.hpp>
 #include <cryptl/ED25519_ge.hpp>
 #include <cryptl/ED25519_sc.hpp>
 #include <cryptl/NS_cryptl.hpp>
 #include <cryptl/SHA_512.hpp>
+#include <cryptl/SHA_Stream.hpp>
 
 namespace cryptl {
 
@@ -18,6 +20,9 @@ namespace cryptl {
 // direct translation of: supercop-20141124/crypto_sign/ed25519/ref/open.c
 // direct translation of: supercop-20141124/crypto_sign/ed25519/ref/sign.c
 
+// smaller batches are verified one signature at a time
+const std::size_t ED25519_BATCH_MIN = 4;
+
 ////////////////////////////////////////////////////////////////////////////////
 // public and secret key pair
 //
@@ -31,13 +36,18 @@ template <typename B,     // bool variable
           typename BIT64, // Bitwise for 64-bit
           typename MSG,   // 64-bit variable for hash pre-image
           typename FUN,   // SHA functions
-          typename NS>    // namespace type
+          typename NS,    // namespace type
+          typename FE = fe25519<U32, U8, B, BIT32, NS>> // field element
 class ED_25519
 {
     typedef sc25519<U32, U8, B, BIT32, BIT8, NS> SC;
-    typedef ge25519<U32, U8, B, BIT32, BIT8, NS> GE;
+    typedef ge25519<U32, U8, B, BIT32, BIT8, NS, FE> GE;
 
 public:
+    // fixed-base comb table for keypair and sign (native words only), see
+    // ge25519_comb::install()
+    typedef ge25519_comb<U32, U8, B, BIT32, BIT8, NS, FE> BaseTable;
+
     // public key from 32 byte secret
     static
     void keypair(std::array<U8, 32>& pk,
@@ -54,6 +64,20 @@ public:
         gepk.pack(pk);
     }
 
+    // new 32 byte secret from a random generator (e.g. CTR_DRBG) and its
+    // public key, returns false if the generator fails
+    template <typename RNG>
+    static
+    bool keypair(std::array<U8, 32>& pk,
+                 std::array<U8, 32>& sk,
+                 RNG& rng)
+    {
+        if (! rng.bytes(sk)) return false;
+
+        keypair(pk, sk);
+        return true;
+    }
+
     // sign message
     static
     void sign(std::array<U8, 32>& R,
@@ -106,6 +130,60 @@ public:
         scs.to32bytes(S);
     }
 
+    // secret key expanded once for repeated sign() (native words only)
+    class SigningKey
+    {
+    public:
+        explicit SigningKey(const std::array<U8, 32>& sk) {
+            std::array<U8, 64> az;
+            init_az(az, sk);
+            // az: 32-byte scalar a, 32-byte randomizer z
+
+            std::array<U8, 32> a;
+            for (std::size_t i = 0; i < 32; ++i) a[i] = az[i];
+            m_a.from32bytes(a);
+
+            GE gepk;
+            gepk.scalarmult_base(m_a);
+            gepk.pack(m_pk);
+
+            for (std::size_t i = 0; i < 32; ++i) m_prefix[i] = az[i + 32];
+            m_z.update(m_prefix.data(), 32);
+        }
+
+        const std::array<U8, 32>& pk() const { return m_pk; }
+
+    private:
+        friend class ED_25519;
+
+        SC m_a;                      // scalar a
+        std::array<U8, 32> m_pk;     // A = [a]B
+        std::array<U8, 32> m_prefix; // randomizer z
+        SHA_Stream<SHA512> m_z;      // SHA-512 after randomizer z
+    };
+
+    // sign message with an expanded secret key
+    static
+    void sign(std::array<U8, 32>& R,
+              std::array<U8, 32>& S,
+              const std::vector<U8>& m,
+              const SigningKey& sk)
+    {
+        sign(R, S, m.data(), m.size(), sk);
+    }
+
+    // as above with the message as pointer and length, no heap allocation
+    static
+    void sign(std::array<U8, 32>& R,
+              std::array<U8, 32>& S,
+              const U8* m,
+              const std::size_t mlen,
+              const SigningKey& sk)
+    {
+        SHA_Stream<SHA512> h(sk.m_z);
+        sign_dom(R, S, h, SHA_Stream<SHA512>(), m, mlen, sk);
+    }
+
     // verify signature
     static
     B open(const std::array<U8, 32>& R,
@@ -126,6 +204,310 @@ public:
         SC scs;
         scs.from32bytes(S);
 
+        SC schram;
+        hram(schram, R, pk, m);
+
+        GE get2;
+        get2.double_scalarmult_vartime(get1, schram, GE::base(), scs);
+
+        std::array<U8, 32> rcheck;
+        get2.pack(rcheck);
+
+        return BIT32::logicalAND(
+            BIT32::logicalNOT(badsig),
+            BIT32::logicalNOT(NS::notequal(R, rcheck)));
+    }
+
+    // public key decompressed once for repeated open() (native words only)
+    class VerifyKey
+    {
+    public:
+        VerifyKey()
+            : m_valid(false)
+        {}
+
+        explicit VerifyKey(const std::array<U8, 32>& pk)
+            : m_pk(pk)
+        {
+            GE a;
+            m_valid = a.unpackneg_vartime(pk);
+            if (m_valid) a.oddmultiples(m_a);
+        }
+
+        const std::array<U8, 32>& pk() const { return m_pk; }
+
+        // false if pk is not a point
+        bool valid() const { return m_valid; }
+
+    private:
+        friend class ED_25519;
+
+        std::array<U8, 32> m_pk;
+        bool m_valid;
+        typename GE::OddMultiples m_a; // -A, -3A,..., -15A
+    };
+
+    // verify signature with a decompressed public key, skips unpacking pk
+    // and uses signed sliding windows with precomputed odd multiples
+    static
+    B open(const std::array<U8, 32>& R,
+           const std::array<U8, 32>& S,
+           const std::vector<U8>& m,
+           const VerifyKey& vk)
+    {
+        return open(R, S, m.data(), m.size(), vk);
+    }
+
+    // as above with the message as pointer and length, no heap allocation
+    static
+    B open(const std::array<U8, 32>& R,
+           const std::array<U8, 32>& S,
+           const U8* m,
+           const std::size_t mlen,
+           const VerifyKey& vk)
+    {
+        return open_dom(R, S, SHA_Stream<SHA512>(), m, mlen, vk);
+    }
+
+    // verify signature (native words only), message as pointer and length,
+    // no heap allocation
+    static
+    B open(const std::array<U8, 32>& R,
+           const std::array<U8, 32>& S,
+           const U8* m,
+           const std::size_t mlen,
+           const std::array<U8, 32>& pk)
+    {
+        return open(R, S, m, mlen, VerifyKey(pk));
+    }
+
+    // RFC 8032 Ed25519ctx and Ed25519ph (native words only), the hashes
+    // start with dom2(phflag, context), contexts are at most 255 octets
+
+    // Ed25519ctx, false if the context is empty or too long
+    static
+    bool sign_ctx(std::array<U8, 32>& R,
+                  std::array<U8, 32>& S,
+                  const U8* m,
+                  const std::size_t mlen,
+                  const U8* ctx,
+                  const std::size_t ctxlen,
+                  const SigningKey& sk)
+    {
+        SHA_Stream<SHA512> dom;
+        if (0 == ctxlen || ! dom2(dom, 0, ctx, ctxlen)) return false;
+
+        SHA_Stream<SHA512> h(dom);
+        h.update(sk.m_prefix.data(), 32);
+        sign_dom(R, S, h, dom, m, mlen, sk);
+        return true;
+    }
+
+    static
+    B open_ctx(const std::array<U8, 32>& R,
+               const std::array<U8, 32>& S,
+               const U8* m,
+               const std::size_t mlen,
+               const U8* ctx,
+               const std::size_t ctxlen,
+               const VerifyKey& vk)
+    {
+        SHA_Stream<SHA512> dom;
+        if (0 == ctxlen || ! dom2(dom, 0, ctx, ctxlen)) return false;
+
+        return open_dom(R, S, dom, m, mlen, vk);
+    }
+
+    // Ed25519ph, the message is given by a SHA-512 stream that has absorbed
+    // it (not finalized), so a message of any size is read once in constant
+    // memory. False if the context is too long.
+    static
+    bool sign_ph(std::array<U8, 32>& R,
+                 std::array<U8, 32>& S,
+                 const SHA_Stream<SHA512>& ph,
+                 const U8* ctx,
+                 const std::size_t ctxlen,
+                 const SigningKey& sk)
+    {
+        SHA_Stream<SHA512> dom;
+        if (! dom2(dom, 1, ctx, ctxlen)) return false;
+
+        std::array<U8, 64> m;
+        SHA_Stream<SHA512>(ph).finalize(m.data());
+        // m: 64-byte PH(M) = SHA-512(M)
+
+        SHA_Stream<SHA512> h(dom);
+        h.update(sk.m_prefix.data(), 32);
+        sign_dom(R, S, h, dom, m.data(), m.size(), sk);
+        return true;
+    }
+
+    static
+    B open_ph(const std::array<U8, 32>& R,
+              const std::array<U8, 32>& S,
+              const SHA_Stream<SHA512>& ph,
+              const U8* ctx,
+              const std::size_t ctxlen,
+              const VerifyKey& vk)
+    {
+        SHA_Stream<SHA512> dom;
+        if (! dom2(dom, 1, ctx, ctxlen)) return false;
+
+        std::array<U8, 64> m;
+        SHA_Stream<SHA512>(ph).finalize(m.data());
+        // m: 64-byte PH(M) = SHA-512(M)
+
+        return open_dom(R, S, dom, m.data(), m.size(), vk);
+    }
+
+    // verify a batch of signatures (native words only), returns true if all
+    // are valid, valid[i] is the result for signature i
+    //
+    // With random 128-bit z[i] from the generator, one multi-scalar
+    // multiplication checks
+    //
+    //   [sum z[i]S[i]]B + sum [z[i]H(R[i], A[i], m[i])](-A[i]) + sum [z[i]](-R[i])
+    //
+    // is the neutral element after multiplying by the cofactor 8. If not (or
+    // the generator fails), every signature is checked on its own with the
+    // same cofactored equation to find the bad ones. Batches smaller than
+    // ED25519_BATCH_MIN always check one at a time.
+    //
+    // Both paths accept exactly the signatures with
+    //
+    //   [8][S]B = [8]R + [8][H(R, A, m)]A
+    //
+    // (RFC 8032 5.1.7), the batch up to a 2^-128 chance of missing a bad
+    // one. This is the same as open() unless R or A has a small order
+    // component, which open() rejects for some messages and the cofactored
+    // check always ignores.
+    template <typename RNG>
+    static
+    B open_batch(const std::vector<std::array<U8, 32>>& R,
+                 const std::vector<std::array<U8, 32>>& S,
+                 const std::vector<std::vector<U8>>& m,
+                 const std::vector<std::array<U8, 32>>& pk,
+                 std::vector<B>& valid,
+                 RNG& rng)
+    {
+        const std::size_t N = R.size();
+        valid.assign(N, false);
+
+        if (N >= ED25519_BATCH_MIN && batch(R, S, m, pk, rng)) {
+            valid.assign(N, true);
+            return true;
+        }
+
+        bool all = true;
+        for (std::size_t i = 0; i < N; ++i) {
+            valid[i] = open_cofactored(R[i], S[i], m[i], pk[i]);
+            all = all && valid[i];
+        }
+
+        return all;
+    }
+
+private:
+    // true if the random linear combination of all signatures holds
+    template <typename RNG>
+    static
+    bool batch(const std::vector<std::array<U8, 32>>& R,
+               const std::vector<std::array<U8, 32>>& S,
+               const std::vector<std::vector<U8>>& m,
+               const std::vector<std::array<U8, 32>>& pk,
+               RNG& rng)
+    {
+        typedef shortsc25519<U32, U8, B, BIT32> SSC;
+
+        const std::size_t N = R.size();
+
+        // points B, -A[0], ..., -A[N-1], -R[0], ..., -R[N-1]
+        std::vector<GE> p(2*N + 1);
+        std::vector<std::array<U8, 32>> s(2*N + 1);
+
+        p[0] = GE::base();
+        SC sumzs;
+        sumzs.from32bytes(std::array<U8, 32>());
+
+        for (std::size_t i = 0; i < N; ++i) {
+            // same checks as open(), R must decode canonically as it is
+            // not compared byte for byte
+            if (BIT8::testbit(S[i][31], 7) ||
+                BIT8::testbit(S[i][31], 6) ||
+                BIT8::testbit(S[i][31], 5) ||
+                ! p[1 + i].unpackneg_vartime(pk[i]) ||
+                ! p[1 + N + i].unpackneg_vartime(R[i]) ||
+                ! p[1 + N + i].iscanonical_vartime(R[i]))
+                return false;
+
+            std::array<U8, 16> az;
+            if (! rng.bytes(az)) return false;
+
+            SSC ssz;
+            ssz.from16bytes(az);
+            SC scz;
+            scz.from_shortsc(ssz);
+
+            SC schram, scs;
+            hram(schram, R[i], pk[i], m[i]);
+            schram.mul_shortsc(schram, ssz);
+            schram.to32bytes(s[1 + i]);
+            scz.to32bytes(s[1 + N + i]);
+
+            scs.from32bytes(S[i]);
+            scs.mul_shortsc(scs, ssz);
+            sumzs.add(sumzs, scs);
+        }
+
+        sumzs.to32bytes(s[0]);
+
+        GE q;
+        q.multi_scalarmult_vartime(p, s);
+
+        // clear small order components
+        q.mul8(q);
+
+        return q.isneutral_vartime();
+    }
+
+    // one signature with the equation of batch()
+    static
+    bool open_cofactored(const std::array<U8, 32>& R,
+                         const std::array<U8, 32>& S,
+                         const std::vector<U8>& m,
+                         const std::array<U8, 32>& pk)
+    {
+        GE a, r;
+        if (BIT8::testbit(S[31], 7) ||
+            BIT8::testbit(S[31], 6) ||
+            BIT8::testbit(S[31], 5) ||
+            ! a.unpackneg_vartime(pk) ||
+            ! r.unpackneg_vartime(R) ||
+            ! r.iscanonical_vartime(R))
+            return false;
+
+        SC scs;
+        scs.from32bytes(S);
+
+        SC schram;
+        hram(schram, R, pk, m);
+
+        // [S]B - [H(R, A, m)]A - R
+        GE q;
+        q.double_scalarmult_vartime(a, schram, GE::base(), scs);
+        q.add(q, r);
+        q.mul8(q);
+
+        return q.isneutral_vartime();
+    }
+
+    // H(R, A, m) as a scalar
+    static
+    void hram(SC& r,
+              const std::array<U8, 32>& R,
+              const std::array<U8, 32>& pk,
+              const std::vector<U8>& m)
+    {
         std::vector<U8> vhram(64), vm(64 + m.size());
         for (std::size_t i = 0; i < 32; ++i) vm[i] = R[i];
         for (std::size_t i = 0; i < 32; ++i) vm[i + 32] = pk[i];
@@ -133,25 +515,112 @@ public:
         // vm: 32-byte R, 32-byte A, message m
 
         sha512(vhram, vm);
-        std::array<U8, 64> hram;
-        for (std::size_t i = 0; i < 64; ++i) hram[i] = vhram[i];
-        // hram: 64-byte H(R, A, m)
+        std::array<U8, 64> h;
+        for (std::size_t i = 0; i < 64; ++i) h[i] = vhram[i];
+        // h: 64-byte H(R, A, m)
+
+        r.from64bytes(h);
+    }
+
+    // dom2(phflag, C) of RFC 8032 into h, false if C is too long
+    static
+    bool dom2(SHA_Stream<SHA512>& h,
+              const std::uint8_t phflag,
+              const U8* ctx,
+              const std::size_t ctxlen)
+    {
+        if (ctxlen > 255) return false;
+
+        static const char prefix[] = "SigEd25519 no Ed25519 collisions";
+        h.update(reinterpret_cast<const std::uint8_t*>(prefix), 32);
+
+        const std::array<std::uint8_t, 2> a = {{ phflag, std::uint8_t(ctxlen) }};
+        h.update(a.data(), a.size());
+        h.update(ctx, ctxlen);
+        return true;
+    }
+
+    // h has absorbed dom and z, dom is empty for pure Ed25519
+    static
+    void sign_dom(std::array<U8, 32>& R,
+                  std::array<U8, 32>& S,
+                  SHA_Stream<SHA512>& h,
+                  const SHA_Stream<SHA512>& dom,
+                  const U8* m,
+                  const std::size_t mlen,
+                  const SigningKey& sk)
+    {
+        std::array<U8, 64> nonce;
+        h.update(m, mlen);
+        h.finalize(nonce.data());
+        // nonce: 64-byte H(dom, z, m)
+
+        SC sck;
+        sck.from64bytes(nonce);
+
+        GE ger;
+        ger.scalarmult_base(sck);
+        ger.pack(R);
+
+        SC scs;
+        hram(scs, dom, R, sk.m_pk, m, mlen);
+        scs.mul(scs, sk.m_a);
+        scs.add(scs, sck);
+        // scs: S = nonce + H(dom, R, A, m)a
+
+        scs.to32bytes(S);
+    }
+
+    static
+    B open_dom(const std::array<U8, 32>& R,
+               const std::array<U8, 32>& S,
+               const SHA_Stream<SHA512>& dom,
+               const U8* m,
+               const std::size_t mlen,
+               const VerifyKey& vk)
+    {
+        if (! vk.m_valid ||
+            BIT8::testbit(S[31], 7) ||
+            BIT8::testbit(S[31], 6) ||
+            BIT8::testbit(S[31], 5))
+            return false;
 
         SC schram;
-        schram.from64bytes(hram);
+        hram(schram, dom, R, vk.m_pk, m, mlen);
+
+        std::array<U8, 32> s1;
+        schram.to32bytes(s1);
 
         GE get2;
-        get2.double_scalarmult_vartime(get1, schram, GE::base(), scs);
+        get2.double_scalarmult_base_vartime(vk.m_a, s1, S);
 
         std::array<U8, 32> rcheck;
         get2.pack(rcheck);
 
-        return BIT32::logicalAND(
-            BIT32::logicalNOT(badsig),
-            BIT32::logicalNOT(NS::notequal(R, rcheck)));
+        return ! NS::notequal(R, rcheck);
+    }
+
+    // H(dom, R, A, m) as a scalar (native words only)
+    static
+    void hram(SC& r,
+              const SHA_Stream<SHA512>& dom,
+              const std::array<U8, 32>& R,
+              const std::array<U8, 32>& pk,
+              const U8* m,
+              const std::size_t mlen)
+    {
+        SHA_Stream<SHA512> h(dom);
+        h.update(R.data(), 32);
+        h.update(pk.data(), 32);
+        h.update(m, mlen);
+
+        std::array<U8, 64> d;
+        h.finalize(d.data());
+        // d: 64-byte H(dom, R, A, m)
+
+        r.from64bytes(d);
     }
 
-private:
     static
     void sha512(std::vector<U8>& out, const std::vector<U8>& msg) {
         const std::size_t
@@ -290,6 +759,23 @@ private:
 // typedef
 //
 
+// radix 2^51 with 128-bit products, otherwise ten limbs of radix 2^25.5
+#ifdef __SIZEOF_INT128__
+typedef fe25519<std::uint32_t,
+                std::uint8_t,
+                bool,
+                BitwiseINT<std::uint32_t>,
+                NS>
+    ED25519_FE;
+#else
+typedef fe25519_10<std::uint64_t,
+                   std::uint8_t,
+                   bool,
+                   BitwiseINT<std::uint64_t>,
+                   NS>
+    ED25519_FE;
+#endif
+
 typedef ED_25519<bool,
                  std::uint8_t,
                  std::uint32_t,
@@ -301,7 +787,8 @@ typedef ED_25519<bool,
                  SHA_Functions<std::uint64_t,
                                std::uint64_t,
                                BitwiseINT<std::uint64_t>>,
-                 NS>
+                 NS,
+                 ED25519_FE>
     ED25519;
 
 } // namespace cryptl
@@ -0,0 +1,123 @@
+#ifndef _CRYPTL_ED25519_CACHE_HPP_
+#define _CRYPTL_ED25519_CACHE_HPP_
+
+#include <array>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <cryptl/ED25519.hpp>
+
+namespace cryptl {
+
+// default number of public keys kept
+const std::size_t ED25519_VERIFYKEY_CACHE = 4096;
+
+////////////////////////////////////////////////////////////////////////////////
+// least recently used cache of verification keys (native words only)
+//
+// Keys are looked up by the 32 byte public key. A miss decompresses the key
+// outside the lock, so concurrent misses for the same key may both do the
+// work and the first one inserted is kept. Entries are shared pointers and
+// stay valid after eviction for as long as a caller holds them.
+//
+
+template <typename ED> // ED_25519
+class ED25519_VerifyKeyCache
+{
+public:
+    typedef typename ED::VerifyKey VerifyKey;
+    typedef std::array<std::uint8_t, 32> Key;
+
+    explicit ED25519_VerifyKeyCache(const std::size_t capacity = ED25519_VERIFYKEY_CACHE)
+        : m_capacity(capacity ? capacity : 1)
+    {}
+
+    ED25519_VerifyKeyCache(const ED25519_VerifyKeyCache&) = delete;
+    ED25519_VerifyKeyCache& operator= (const ED25519_VerifyKeyCache&) = delete;
+
+    std::shared_ptr<const VerifyKey> get(const Key& pk) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            const auto it = m_index.find(pk);
+            if (m_index.end() != it) {
+                // move to front
+                m_order.splice(m_order.begin(), m_order, it->second);
+                return it->second->second;
+            }
+        }
+
+        const std::shared_ptr<const VerifyKey> vk(new VerifyKey(pk));
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        const auto it = m_index.find(pk);
+        if (m_index.end() != it) {
+            m_order.splice(m_order.begin(), m_order, it->second);
+            return it->second->second;
+        }
+
+        m_order.emplace_front(pk, vk);
+        m_index[pk] = m_order.begin();
+
+        if (m_order.size() > m_capacity) {
+            m_index.erase(m_order.back().first);
+            m_order.pop_back();
+        }
+
+        return vk;
+    }
+
+    // ED::open() with the cached verification key
+    bool open(const std::array<std::uint8_t, 32>& R,
+              const std::array<std::uint8_t, 32>& S,
+              const std::vector<std::uint8_t>& m,
+              const Key& pk)
+    {
+        return ED::open(R, S, m, *get(pk));
+    }
+
+    bool open(const std::array<std::uint8_t, 32>& R,
+              const std::array<std::uint8_t, 32>& S,
+              const std::uint8_t* m,
+              const std::size_t mlen,
+              const Key& pk)
+    {
+        return ED::open(R, S, m, mlen, *get(pk));
+    }
+
+    std::size_t size() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_order.size();
+    }
+
+    std::size_t capacity() const {
+        return m_capacity;
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_index.clear();
+        m_order.clear();
+    }
+
+private:
+    typedef std::list<std::pair<Key, std::shared_ptr<const VerifyKey>>> Order;
+
+    const std::size_t m_capacity;
+
+    // most recently used first
+    Order m_order;
+    std::map<Key, typename Order::iterator> m_index;
+
+    mutable std::mutex m_mutex;
+};
+
+} // namespace cryptl
+
+#endif
@@ -0,0 +1,433 @@
+#ifndef _CRYPTL_ED25519_COMB_HPP_
+#define _CRYPTL_ED25519_COMB_HPP_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cryptl/ED25519_ge.hpp>
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// fixed-base comb table (native words only)
+//
+// Scalars are written with signed digits e[i] of w bits, |e[i]| <= 2^(w-1)
+// (as in ref10 ge_scalarmult_base for w = 4). Position j of the table holds
+// 1, 2,..., 2^(w-1) times 2^(w*s*j) B as affine (y + x, y - x, 2dxy), so
+// digit i = s*j + k is added from position j after k rounds of w doublings.
+// The default w = 4, s = 2 is the ref10 layout: 32 positions of 8 entries,
+// 64 mixed additions and 4 doublings.
+//
+// A table is generated (one batched inversion) or loaded from a file
+// written by save(). Files hold the packed coordinates, so they do not
+// depend on the field element type. Loading maps the file read-only,
+// unpacks the table and checks every entry against the one before it, so
+// a corrupt or modified file is rejected rather than giving wrong
+// signatures (and with deterministic nonces, the secret key). The check
+// costs about as much as generating the table without the inversion.
+//
+// Install a table to have ge25519::scalarmult_base() (keypair, sign) use it.
+//
+
+template <typename T, typename U, typename B, typename FT, typename FU, typename NS, typename FE>
+class ge25519_comb
+{
+    typedef ge25519<T, U, B, FT, FU, NS, FE> GE;
+
+public:
+    // precomputed affine point
+    struct Precomp {
+        FE ypx, ymx, xy2d;
+    };
+
+    // window w of 2 to 8 bits, positions every s digits (1 to 4)
+    explicit ge25519_comb(const std::size_t w = 4,
+                          const std::size_t s = 2)
+        : m_window(std::min<std::size_t>(std::max<std::size_t>(w, 2), 8)),
+          m_stride(std::min<std::size_t>(std::max<std::size_t>(s, 1), 4)),
+          m_data(positions() * entries())
+    {
+        generate(m_data.data());
+    }
+
+    ge25519_comb(const ge25519_comb&) = delete;
+    ge25519_comb& operator= (const ge25519_comb&) = delete;
+
+    // table from a file written by save(), null if the file is not a
+    // correct table
+    static std::unique_ptr<ge25519_comb> load(const std::string& filename) {
+        std::unique_ptr<ge25519_comb> a;
+
+        const int fd = ::open(filename.c_str(), O_RDONLY);
+        if (-1 == fd) return a;
+
+        struct stat st;
+        void* p = MAP_FAILED;
+        if (0 == fstat(fd, &st) && std::size_t(st.st_size) >= sizeof(Header))
+            p = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        ::close(fd);
+        if (MAP_FAILED == p) return a;
+
+        const Header& h = *static_cast<const Header*>(p);
+        a.reset(new ge25519_comb(h.window, h.stride, nullptr));
+
+        // unpacked into the table, later changes to the file are not seen
+        if (0 != std::memcmp(h.magic, magic(), sizeof(h.magic)) ||
+            h.window != a->m_window ||
+            h.stride != a->m_stride ||
+            h.entry != ENTRY_OCTETS ||
+            std::size_t(st.st_size) != sizeof(Header) + a->fileBytes() ||
+            ! a->unpack(static_cast<const std::uint8_t*>(p) + sizeof(Header)))
+            a.reset();
+
+        ::munmap(p, st.st_size);
+
+        if (a && ! a->check()) a.reset();
+
+        return a;
+    }
+
+    // false if the file can not be written
+    bool save(const std::string& filename) const {
+        Header h;
+        std::memset(&h, 0, sizeof(Header));
+        std::memcpy(h.magic, magic(), sizeof(h.magic));
+        h.window = m_window;
+        h.stride = m_stride;
+        h.entry = ENTRY_OCTETS;
+
+        std::ofstream ofs(filename, std::ios::binary | std::ios::trunc);
+        ofs.write(reinterpret_cast<const char*>(&h), sizeof(Header));
+
+        std::array<U, 32> b;
+        for (const auto& t : m_data) {
+            for (const FE* x : { &t.ypx, &t.ymx, &t.xy2d }) {
+                x->pack(b);
+                ofs.write(reinterpret_cast<const char*>(b.data()), b.size());
+            }
+        }
+
+        return ofs.good();
+    }
+
+    std::size_t window() const { return m_window; }
+    std::size_t stride() const { return m_stride; }
+
+    // number of signed digits for scalars below 2^253
+    std::size_t digits() const {
+        return 253 / m_window + 1;
+    }
+
+    std::size_t positions() const {
+        return (digits() + m_stride - 1) / m_stride;
+    }
+
+    std::size_t entries() const {
+        return std::size_t(1) << (m_window - 1);
+    }
+
+    // table in memory
+    std::size_t bytes() const {
+        return positions() * entries() * sizeof(Precomp);
+    }
+
+    // table in a file, without the header
+    std::size_t fileBytes() const {
+        return positions() * entries() * ENTRY_OCTETS;
+    }
+
+    // r = [a]B for a below 2^253 (reduced sc25519), constant time
+    void scalarmult(GE& r, const std::array<U, 32>& a) const {
+        // signed digits, the carry of digit i goes into digit i + 1
+        std::array<std::int32_t, 127> e;
+        const std::int32_t half = std::int32_t(1) << (m_window - 1);
+        std::int32_t carry = 0;
+        for (std::size_t i = 0; i < digits(); ++i) {
+            const std::size_t k = m_window * i;
+
+            std::uint32_t v = a[k / 8];
+            if (k / 8 + 1 < 32) v |= std::uint32_t(a[k / 8 + 1]) << 8;
+
+            e[i] = ((v >> (k % 8)) & (2*half - 1)) + carry;
+
+            // the top digit is at most half
+            if (i + 1 < digits()) {
+                carry = (e[i] + half) >> m_window;
+                e[i] -= carry << m_window;
+            }
+        }
+
+        r.setneutral();
+
+        GE tp1p1;
+        Precomp t;
+
+        for (std::size_t k = m_stride; k > 0; --k) {
+            if (k < m_stride) {
+                for (std::size_t i = 0; i < m_window; ++i) {
+                    tp1p1.dbl_p1p1(r);
+
+                    if (i + 1 < m_window)
+                        r.p1p1_to_p2(tp1p1);
+                    else
+                        r.p1p1_to_p3(tp1p1);
+                }
+            }
+
+            for (std::size_t j = 0; j < positions(); ++j) {
+                const std::size_t i = m_stride*j + k - 1;
+                if (i >= digits()) continue;
+
+                select(t, j, e[i]);
+                madd(r, t);
+            }
+        }
+    }
+
+    // table used by ge25519::scalarmult_base(), null for none (the table
+    // must outlive its use)
+    static void install(const ge25519_comb* a) {
+        installedptr().store(a);
+    }
+
+    static const ge25519_comb* installed() {
+        return installedptr().load();
+    }
+
+private:
+    // packed y + x, y - x, 2dxy
+    static const std::size_t ENTRY_OCTETS = 3 * 32;
+
+    struct Header {
+        char magic[8];
+        std::uint32_t window, stride, entry, reserved;
+        std::uint8_t pad[40]; // entries aligned to 64 bytes
+    };
+
+    static const char* magic() {
+        return "CRYPTLCB";
+    }
+
+    static std::atomic<const ge25519_comb*>& installedptr() {
+        static std::atomic<const ge25519_comb*> a(nullptr);
+        return a;
+    }
+
+    static const FE& ec2d() {
+        // 2*d
+        static const FE a({
+            0x59, 0xF1, 0xB2, 0x26, 0x94, 0x9B, 0xD6, 0xEB,
+            0x56, 0xB1, 0x83, 0x82, 0x9A, 0x14, 0xE0, 0x00,
+            0x30, 0xD1, 0xF3, 0xEE, 0xF2, 0x80, 0x8E, 0x19,
+            0xE7, 0xFC, 0xDF, 0x56, 0xDC, 0xD9, 0x06, 0x24 });
+
+        return a;
+    }
+
+    // entries filled in by load()
+    ge25519_comb(const std::size_t w,
+                 const std::size_t s,
+                 std::nullptr_t)
+        : m_window(std::min<std::size_t>(std::max<std::size_t>(w, 2), 8)),
+          m_stride(std::min<std::size_t>(std::max<std::size_t>(s, 1), 4)),
+          m_data(positions() * entries())
+    {}
+
+    // false unless every coordinate is packed canonically
+    bool unpack(const std::uint8_t* p) {
+        std::array<U, 32> a, b;
+        for (auto& t : m_data) {
+            for (FE* x : { &t.ypx, &t.ymx, &t.xy2d }) {
+                std::memcpy(a.data(), p, 32);
+                p += 32;
+
+                x->unpack(a);
+                x->pack(b);
+                if (a != b) return false;
+            }
+        }
+
+        return true;
+    }
+
+    static bool eq(const FE& x, const FE& y) {
+        std::array<U, 32> a, b;
+        x.pack(a);
+        y.pack(b);
+        return a == b;
+    }
+
+    // t is the affine form of p
+    static bool eq(const GE& p, const Precomp& t) {
+        FE a, b;
+
+        // y + x = (Y + X) / Z
+        a.add(p.m_y, p.m_x);
+        b.mul(t.ypx, p.m_z);
+        if (! eq(a, b)) return false;
+
+        // y - x = (Y - X) / Z
+        a.sub(p.m_y, p.m_x);
+        b.mul(t.ymx, p.m_z);
+        return eq(a, b);
+    }
+
+    // every entry from the one before it: entry 0 of position 0 is B,
+    // entry k + 1 is entry k plus entry 0, and entry 0 of position j + 1
+    // is 2^(w*s) times entry 0 of position j
+    bool check() const {
+        const std::size_t N = entries();
+
+        // 4 * 2dxy = 2d((y + x)^2 - (y - x)^2)
+        for (const auto& t : m_data) {
+            FE a, b, c;
+            a.add(t.xy2d, t.xy2d);
+            a.add(a, a);
+            b.square(t.ypx);
+            c.square(t.ymx);
+            b.sub(b, c);
+            b.mul(b, ec2d());
+            if (! eq(a, b)) return false;
+        }
+
+        GE q = GE::base(), r;
+        for (std::size_t j = 0; j < positions(); ++j) {
+            const Precomp* a = m_data.data() + j * N;
+            if (! eq(q, a[0])) return false;
+
+            r = q;
+            for (std::size_t k = 1; k < N; ++k) {
+                madd(r, a[0]);
+                if (! eq(r, a[k])) return false;
+            }
+
+            for (std::size_t i = 0; i < m_window * m_stride; ++i)
+                q.dbl(q);
+        }
+
+        return true;
+    }
+
+    void generate(Precomp* table) const {
+        const std::size_t N = entries();
+        std::vector<GE> p(positions() * N);
+
+        GE q = GE::base();
+        for (std::size_t j = 0; j < positions(); ++j) {
+            // k * 2^(w*s*j) B
+            p[j*N] = q;
+            for (std::size_t k = 1; k < N; ++k)
+                p[j*N + k].add(p[j*N + k - 1], q);
+
+            for (std::size_t i = 0; i < m_window * m_stride; ++i)
+                q.dbl(q);
+        }
+
+        toprecomp(table, p);
+    }
+
+    // affine with one inversion for all points
+    static void toprecomp(Precomp* r, const std::vector<GE>& p) {
+        std::vector<FE> z(p.size());
+        z[0] = p[0].m_z;
+        for (std::size_t i = 1; i < p.size(); ++i)
+            z[i].mul(z[i - 1], p[i].m_z);
+
+        FE zinv, t;
+        zinv.invert(z.back());
+
+        for (std::size_t i = p.size(); i > 0; --i) {
+            // zinv is 1 / (p[0].z * ... * p[i - 1].z)
+            if (i > 1) {
+                t.mul(zinv, z[i - 2]);
+                zinv.mul(zinv, p[i - 1].m_z);
+            } else {
+                t = zinv;
+            }
+
+            FE x, y;
+            x.mul(p[i - 1].m_x, t);
+            y.mul(p[i - 1].m_y, t);
+
+            r[i - 1].ypx.add(y, x);
+            r[i - 1].ymx.sub(y, x);
+            r[i - 1].xy2d.mul(x, y);
+            r[i - 1].xy2d.mul(r[i - 1].xy2d, ec2d());
+        }
+    }
+
+    // t = e * (position j), constant time in e
+    void select(Precomp& t, const std::size_t j, const std::int32_t e) const {
+        const std::int32_t
+            neg = (e >> 31) & 1,
+            abs = (e ^ -neg) + neg;
+
+        t.ypx.setone();
+        t.ymx.setone();
+        t.xy2d.setzero();
+
+        const Precomp* a = m_data.data() + j * entries();
+        for (std::size_t k = 0; k < entries(); ++k) {
+            const bool b = std::int32_t(k + 1) == abs;
+            t.ypx.cmov(a[k].ypx, b);
+            t.ymx.cmov(a[k].ymx, b);
+            t.xy2d.cmov(a[k].xy2d, b);
+        }
+
+        // -(x, y) = (-x, y) swaps y + x and y - x, negates 2dxy
+        FE ypx(t.ypx), xy2d;
+        xy2d.neg(t.xy2d);
+        t.ypx.cmov(t.ymx, 1 == neg);
+        t.ymx.cmov(ypx, 1 == neg);
+        t.xy2d.cmov(xy2d, 1 == neg);
+    }
+
+    // r = r + t
+    static void madd(GE& r, const Precomp& t) {
+        GE tp1p1;
+        FE a, b, c, d;
+
+        // A = (Y1-X1)*(y2-x2)
+        a.sub(r.m_y, r.m_x);
+        a.mul(a, t.ymx);
+
+        // B = (Y1+X1)*(y2+x2)
+        b.add(r.m_y, r.m_x);
+        b.mul(b, t.ypx);
+
+        // C = T1*2d*x2*y2
+        c.mul(r.m_t, t.xy2d);
+
+        // D = Z1*2
+        d.add(r.m_z, r.m_z);
+
+        tp1p1.m_x.sub(b, a); // E = B-A
+        tp1p1.m_t.sub(d, c); // F = D-C
+        tp1p1.m_z.add(d, c); // G = D+C
+        tp1p1.m_y.add(b, a); // H = B+A
+
+        r.p1p1_to_p3(tp1p1);
+    }
+
+    const std::size_t m_window, m_stride;
+    std::vector<Precomp> m_data;
+};
+
+} // namespace cryptl
+
+#endif
@@ -74,7 +74,7 @@ public:
 
     // Assumes input x being reduced below 2^255
     // (note: input x is *this)
-    void pack(std::array<U, 32>& r) {
+    void pack(std::array<U, 32>& r) const {
         // fe25519 y = *x;
         auto y(*this);
 
@@ -87,7 +87,7 @@ public:
         }
     }
 
-    B iszero() {
+    B iszero() const {
         // fe25519 t = *x;
         auto t(*this);
 
@@ -99,7 +99,7 @@ public:
             NS::notequal(t.m_v, F::zero(t.m_v))); // inequality test is imperative
     }
 
-    B iseq_vartime(const fe25519& y) {
+    B iseq_vartime(const fe25519& y) const {
         // fe25519 t1 = *x;
         auto t1(*this);
 
@@ -132,7 +132,25 @@ public:
         }
     }
 
-    B getparity() {
+    // r = b ? x : y
+    void ternary(const B& b, const fe25519& x, const fe25519& y) {
+        for (std::size_t i = 0; i < 32; ++i) {
+            m_v[i] = F::ternary(b, x.m_v[i], y.m_v[i]);
+        }
+    }
+
+    // r = a[idx]
+    template <std::size_t N>
+    void arraysubscript(const std::array<fe25519, N>& a, const U& idx) {
+        for (std::size_t j = 0; j < 32; ++j) {
+            std::array<T, N> v;
+            for (std::size_t i = 0; i < N; ++i) v[i] = a[i].m_v[j];
+
+            m_v[j] = F::arraysubscript(v, idx);
+        }
+    }
+
+    B getparity() const {
         // fe25519 t = *x;
         auto t(*this);
 
@@ -231,162 +249,119 @@ public:
     }
 
     void square(const fe25519& x) {
-        // fe25519_mul(r, x, x)
-        mul(x, x);
+        // fe25519_mul(r, x, x) with each cross product x[i] * x[j],
+        // i < j, computed once and doubled (528 products instead of 1024)
+        std::array<T, 63> t = F::zero(t);
+
+        for (std::size_t i = 0; i < 32; ++i) {
+            // t[i+i] += x->v[i] * x->v[i];
+            t[i + i] = F::ADDMOD(t[i + i],
+                                 F::MULMOD(x.m_v[i],
+                                           x.m_v[i]));
+
+            const T x2 = F::SHL(x.m_v[i], 1);
+
+            for (std::size_t j = i + 1; j < 32; ++j) {
+                // t[i+j] += 2 * x->v[i] * x->v[j];
+                t[i + j] = F::ADDMOD(t[i + j],
+                                     F::MULMOD(x2,
+                                               x.m_v[j]));
+            }
+        }
+
+        for (std::size_t i = 32; i < 63; ++i) {
+            // r->v[i-32] = t[i-32] + times38(t[i]);
+            m_v[i - 32] = F::ADDMOD(t[i - 32], times38(t[i]));
+        }
+
+        // r->v[31] = t[31]; /* result now in r[0]...r[31] */
+        m_v[31] = t[31];
+
+        // reduce_mul(r);
+        reduce_mul();
+    }
+
+    // k successive squarings, x^(2^k)
+    void nsquare(const fe25519& x, const std::size_t k) {
+        square(x);
+
+        for (std::size_t i = 1; i < k; ++i) {
+            square(*this);
+        }
     }
 
     void invert(const fe25519& x) {
         fe25519
             z2, z9, z11,
             z2_5_0, z2_10_0, z2_20_0, z2_50_0, z2_100_0,
-            t0, t1;
+            t;
 
 	// /* 2 */ fe25519_square(&z2,x);
         z2.square(x);
 
-	// /* 4 */ fe25519_square(&t1,&z2);
-        t1.square(z2);
-
-	// /* 8 */ fe25519_square(&t0,&t1);
-        t0.square(t1);
+        // /* 4 */ fe25519_square(&t1,&z2);
+        // /* 8 */ fe25519_square(&t0,&t1);
+        t.nsquare(z2, 2);
 
         // /* 9 */ fe25519_mul(&z9,&t0,x);
-        z9.mul(t0, x);
+        z9.mul(t, x);
 
         // /* 11 */ fe25519_mul(&z11,&z9,&z2);
         z11.mul(z9, z2);
 
         // /* 22 */ fe25519_square(&t0,&z11);
-        t0.square(z11);
+        t.square(z11);
 
         // /* 2^5 - 2^0 = 31 */ fe25519_mul(&z2_5_0,&t0,&z9);
-        z2_5_0.mul(t0, z9);
-
-        // /* 2^6 - 2^1 */ fe25519_square(&t0,&z2_5_0);
-        t0.square(z2_5_0);
-
-        // /* 2^7 - 2^2 */ fe25519_square(&t1,&t0);
-        t1.square(t0);
-
-        // /* 2^8 - 2^3 */ fe25519_square(&t0,&t1);
-        t0.square(t1);
-
-        // /* 2^9 - 2^4 */ fe25519_square(&t1,&t0);
-        t1.square(t0);
+        z2_5_0.mul(t, z9);
 
-        // /* 2^10 - 2^5 */ fe25519_square(&t0,&t1);
-        t0.square(t1);
+        // /* 2^6 - 2^1 */ ... /* 2^10 - 2^5 */
+        t.nsquare(z2_5_0, 5);
 
         // /* 2^10 - 2^0 */ fe25519_mul(&z2_10_0,&t0,&z2_5_0);
-        z2_10_0.mul(t0, z2_5_0);
-
-	// /* 2^11 - 2^1 */ fe25519_square(&t0,&z2_10_0);
-        t0.square(z2_10_0);
-
-        // /* 2^12 - 2^2 */ fe25519_square(&t1,&t0);
-        t1.square(t0);
+        z2_10_0.mul(t, z2_5_0);
 
-        // /* 2^20 - 2^10 */ for (i = 2;i < 10;i += 2) { fe25519_square(&t0,&t1); fe25519_square(&t1,&t0); }
-        for (std::size_t i = 2; i < 10; i += 2) {
-            t0.square(t1);
-            t1.square(t0);
-        }
+        // /* 2^11 - 2^1 */ ... /* 2^20 - 2^10 */
+        t.nsquare(z2_10_0, 10);
 
         // /* 2^20 - 2^0 */ fe25519_mul(&z2_20_0,&t1,&z2_10_0);
-        z2_20_0.mul(t1, z2_10_0);
-
-	// /* 2^21 - 2^1 */ fe25519_square(&t0,&z2_20_0);
-        t0.square(z2_20_0);
-
-        // /* 2^22 - 2^2 */ fe25519_square(&t1,&t0);
-        t1.square(t0);
+        z2_20_0.mul(t, z2_10_0);
 
-        // /* 2^40 - 2^20 */ for (i = 2;i < 20;i += 2) { fe25519_square(&t0,&t1); fe25519_square(&t1,&t0); }
-        for (std::size_t i = 2; i < 20; i += 2) {
-            t0.square(t1);
-            t1.square(t0);
-        }
+        // /* 2^21 - 2^1 */ ... /* 2^40 - 2^20 */
+        t.nsquare(z2_20_0, 20);
 
         // /* 2^40 - 2^0 */ fe25519_mul(&t0,&t1,&z2_20_0);
-        t0.mul(t1, z2_20_0);
-
-	// /* 2^41 - 2^1 */ fe25519_square(&t1,&t0);
-        t1.square(t0);
-
-        // /* 2^42 - 2^2 */ fe25519_square(&t0,&t1);
-        t0.square(t1);
+        t.mul(t, z2_20_0);
 
-        // /* 2^50 - 2^10 */ for (i = 2;i < 10;i += 2) { fe25519_square(&t1,&t0); fe25519_square(&t0,&t1); }
-        for (std::size_t i = 2; i < 10; i += 2) {
-            t1.square(t0);
-            t0.square(t1);
-        }
+        // /* 2^41 - 2^1 */ ... /* 2^50 - 2^10 */
+        t.nsquare(t, 10);
 
         // /* 2^50 - 2^0 */ fe25519_mul(&z2_50_0,&t0,&z2_10_0);
-        z2_50_0.mul(t0, z2_10_0);
-
-	// /* 2^51 - 2^1 */ fe25519_square(&t0,&z2_50_0);
-        t0.square(z2_50_0);
-
-        // /* 2^52 - 2^2 */ fe25519_square(&t1,&t0);
-        t1.square(t0);
+        z2_50_0.mul(t, z2_10_0);
 
-        // /* 2^100 - 2^50 */ for (i = 2;i < 50;i += 2) { fe25519_square(&t0,&t1); fe25519_square(&t1,&t0); }
-        for (std::size_t i = 2; i < 50; i += 2) {
-            t0.square(t1);
-            t1.square(t0);
-        }
+        // /* 2^51 - 2^1 */ ... /* 2^100 - 2^50 */
+        t.nsquare(z2_50_0, 50);
 
         // /* 2^100 - 2^0 */ fe25519_mul(&z2_100_0,&t1,&z2_50_0);
-        z2_100_0.mul(t1, z2_50_0);
-
-	// /* 2^101 - 2^1 */ fe25519_square(&t1,&z2_100_0);
-        t1.square(z2_100_0);
-
-        // /* 2^102 - 2^2 */ fe25519_square(&t0,&t1);
-        t0.square(t1);
+        z2_100_0.mul(t, z2_50_0);
 
-        // /* 2^200 - 2^100 */ for (i = 2;i < 100;i += 2) { fe25519_square(&t1,&t0); fe25519_square(&t0,&t1); }
-        for (std::size_t i = 2; i < 100; i += 2) {
-            t1.square(t0);
-            t0.square(t1);
-        }
+        // /* 2^101 - 2^1 */ ... /* 2^200 - 2^100 */
+        t.nsquare(z2_100_0, 100);
 
         // /* 2^200 - 2^0 */ fe25519_mul(&t1,&t0,&z2_100_0);
-        t1.mul(t0, z2_100_0);
-
-	// /* 2^201 - 2^1 */ fe25519_square(&t0,&t1);
-        t0.square(t1);
-
-        // /* 2^202 - 2^2 */ fe25519_square(&t1,&t0);
-        t1.square(t0);
+        t.mul(t, z2_100_0);
 
-        // /* 2^250 - 2^50 */ for (i = 2;i < 50;i += 2) { fe25519_square(&t0,&t1); fe25519_square(&t1,&t0); }
-        for (std::size_t i = 2; i < 50; i += 2) {
-            t0.square(t1);
-            t1.square(t0);
-        }
+        // /* 2^201 - 2^1 */ ... /* 2^250 - 2^50 */
+        t.nsquare(t, 50);
 
         // /* 2^250 - 2^0 */ fe25519_mul(&t0,&t1,&z2_50_0);
-        t0.mul(t1, z2_50_0);
-
-	// /* 2^251 - 2^1 */ fe25519_square(&t1,&t0);
-        t1.square(t0);
-
-        // /* 2^252 - 2^2 */ fe25519_square(&t0,&t1);
-        t0.square(t1);
-
-        // /* 2^253 - 2^3 */ fe25519_square(&t1,&t0);
-        t1.square(t0);
-
-	// /* 2^254 - 2^4 */ fe25519_square(&t0,&t1);
-        t0.square(t1);
+        t.mul(t, z2_50_0);
 
-	// /* 2^255 - 2^5 */ fe25519_square(&t1,&t0);
-        t1.square(t0);
+        // /* 2^251 - 2^1 */ ... /* 2^255 - 2^5 */
+        t.nsquare(t, 5);
 
 	// /* 2^255 - 21 */ fe25519_mul(r,&t1,&z11);
-        mul(t1, z11);
+        mul(t, z11);
     }
 
     void pow2523(const fe25519& x) {
@@ -399,10 +374,8 @@ public:
         z2.square(x);
 
         // /* 4 */ fe25519_square(&t,&z2);
-        t.square(z2);
-
         // /* 8 */ fe25519_square(&t,&t);
-        t.square(t);
+        t.nsquare(z2, 2);
 
         // /* 9 */ fe25519_mul(&z9,&t,x);
         z9.mul(t, x);
@@ -417,87 +390,57 @@ public:
         z2_5_0.mul(t, z9);
 
 	// /* 2^6 - 2^1 */ fe25519_square(&t,&z2_5_0);
-        t.square(z2_5_0);
-
         // /* 2^10 - 2^5 */ for (i = 1;i < 5;i++) { fe25519_square(&t,&t); }
-        for (std::size_t i = 1; i < 5; ++i) {
-            t.square(t);
-        }
+        t.nsquare(z2_5_0, 5);
 
         // /* 2^10 - 2^0 */ fe25519_mul(&z2_10_0,&t,&z2_5_0);
         z2_10_0.mul(t, z2_5_0);
 
 	// /* 2^11 - 2^1 */ fe25519_square(&t,&z2_10_0);
-        t.square(z2_10_0);
-
         // /* 2^20 - 2^10 */ for (i = 1;i < 10;i++) { fe25519_square(&t,&t); }
-        for (std::size_t i = 1; i < 10; ++i) {
-            t.square(t);
-        }
+        t.nsquare(z2_10_0, 10);
 
         // /* 2^20 - 2^0 */ fe25519_mul(&z2_20_0,&t,&z2_10_0);
         z2_20_0.mul(t, z2_10_0);
 
 	// /* 2^21 - 2^1 */ fe25519_square(&t,&z2_20_0);
-        t.square(z2_20_0);
-
         // /* 2^40 - 2^20 */ for (i = 1;i < 20;i++) { fe25519_square(&t,&t); }
-        for (std::size_t i = 1; i < 20; ++i) {
-            t.square(t);
-        }
+        t.nsquare(z2_20_0, 20);
 
         // /* 2^40 - 2^0 */ fe25519_mul(&t,&t,&z2_20_0);
         t.mul(t, z2_20_0);
 
 	// /* 2^41 - 2^1 */ fe25519_square(&t,&t);
-        t.square(t);
-
         // /* 2^50 - 2^10 */ for (i = 1;i < 10;i++) { fe25519_square(&t,&t); }
-        for (std::size_t i = 1; i < 10; ++i) {
-            t.square(t);
-        }
+        t.nsquare(t, 10);
 
         // /* 2^50 - 2^0 */ fe25519_mul(&z2_50_0,&t,&z2_10_0);
         z2_50_0.mul(t, z2_10_0);
 
 	// /* 2^51 - 2^1 */ fe25519_square(&t,&z2_50_0);
-        t.square(z2_50_0);
-
         // /* 2^100 - 2^50 */ for (i = 1;i < 50;i++) { fe25519_square(&t,&t); }
-        for (std::size_t i = 1; i < 50; ++i) {
-            t.square(t);
-        }
+        t.nsquare(z2_50_0, 50);
 
         // /* 2^100 - 2^0 */ fe25519_mul(&z2_100_0,&t,&z2_50_0);
         z2_100_0.mul(t, z2_50_0);
 
 	// /* 2^101 - 2^1 */ fe25519_square(&t,&z2_100_0);
-        t.square(z2_100_0);
-
         // /* 2^200 - 2^100 */ for (i = 1;i < 100;i++) { fe25519_square(&t,&t); }
-        for (std::size_t i = 1; i < 100; ++i) {
-            t.square(t);
-        }
+        t.nsquare(z2_100_0, 100);
 
         // /* 2^200 - 2^0 */ fe25519_mul(&t,&t,&z2_100_0);
         t.mul(t, z2_100_0);
 
 	// /* 2^201 - 2^1 */ fe25519_square(&t,&t);
-        t.square(t);
-
         // /* 2^250 - 2^50 */ for (i = 1;i < 50;i++) { fe25519_square(&t,&t); }
-        for (std::size_t i = 1; i < 50; ++i) {
-            t.square(t);
-        }
+        t.nsquare(t, 50);
 
         // /* 2^250 - 2^0 */ fe25519_mul(&t,&t,&z2_50_0);
         t.mul(t, z2_50_0);
 
 	// /* 2^251 - 2^1 */ fe25519_square(&t,&t);
-        t.square(t);
-
         // /* 2^252 - 2^2 */ fe25519_square(&t,&t);
-        t.square(t);
+        t.nsquare(t, 2);
 
 	// /* 2^252 - 3 */ fe25519_mul(r,&t,x);
         mul(t, x);
@@ -593,4 +536,9 @@ private:
 
 } // namespace cryptl
 
+// radix 2^51 specialization for native words
+#ifdef __SIZEOF_INT128__
+#include <cryptl/ED25519_fe51.hpp>
+#endif
+
 #endif
@@ -0,0 +1,383 @@
+#ifndef _CRYPTL_ED25519_FE10_HPP_
+#define _CRYPTL_ED25519_FE10_HPP_
+
+#include <array>
+#include <cstdint>
+
+namespace cryptl {
+
+// limb layout of: supercop-20141124/crypto_sign/ed25519/ref10/fe.h
+
+////////////////////////////////////////////////////////////////////////////////
+// fe25519_10
+//
+// Ten limbs of alternately 26 and 25 bits (radix 2^25.5). Products of two
+// limbs are 52 bits, so the limbs are 64-bit words and a multiplication is
+// 100 MULMOD products instead of the 1024 of the 8-bit limb fe25519.
+//
+// The limbs are unsigned: sub adds a multiple of 2^255-19 before
+// subtracting, and all shifts are logical. Each operation ends with one
+// carry pass, the value is reduced in freeze() for pack and comparisons.
+//
+// Drop-in replacement for fe25519 (ge25519 and ED_25519 field parameter)
+// for 32-bit hosts without 128-bit products and for managed words.
+//
+
+// T is 64-bit, U is 8-bit, B is bool, F is Bitwise for 64-bit, NS is namespace
+template <typename T, typename U, typename B, typename F, typename NS>
+class fe25519_10
+{
+public:
+    fe25519_10() = default;
+
+    // specifically needed for ge25519 constants and lookup tables
+    fe25519_10(const std::array<std::uint8_t, 32>& a) {
+        for (std::size_t i = 0; i < 10; ++i) {
+            std::uint64_t v = 0;
+            for (std::size_t k = 0; k < 32; ++k) {
+                if (8*k + 8 <= pos(i) || 8*k >= pos(i) + width(i)) continue;
+
+                v |= 8*k >= pos(i)
+                    ? std::uint64_t(a[k]) << (8*k - pos(i))
+                    : std::uint64_t(a[k]) >> (pos(i) - 8*k);
+            }
+
+            m_v[i] = F::constant(v & mask(i));
+        }
+    }
+
+    // reduction modulo 2^255-19
+    void freeze() {
+        carry();
+
+        // q = 1 if value >= 2^255-19
+        T q = F::SHR(F::ADDMOD(m_v[0], F::constant(19)), 26);
+        for (std::size_t i = 1; i < 10; ++i)
+            q = F::SHR(F::ADDMOD(m_v[i], q), width(i));
+
+        // subtract q(2^255-19)
+        m_v[0] = F::ADDMOD(m_v[0], times19(q));
+        for (std::size_t i = 0; i < 9; ++i) {
+            m_v[i + 1] = F::ADDMOD(m_v[i + 1], F::SHR(m_v[i], width(i)));
+            m_v[i] = F::AND(m_v[i], F::constant(mask(i)));
+        }
+        m_v[9] = F::AND(m_v[9], F::constant(mask(9)));
+    }
+
+    // initialize from byte array
+    void unpack(const std::array<U, 32>& x) {
+        for (std::size_t i = 0; i < 10; ++i) {
+            T v = F::constant(0);
+            for (std::size_t k = 0; k < 32; ++k) {
+                if (8*k + 8 <= pos(i) || 8*k >= pos(i) + width(i)) continue;
+
+                const T b = F::xword(x[k], v);
+                v = F::OR(v, 8*k >= pos(i)
+                                 ? F::SHL(b, 8*k - pos(i))
+                                 : F::SHR(b, pos(i) - 8*k));
+            }
+
+            // top bit is ignored
+            m_v[i] = F::AND(v, F::constant(mask(i)));
+        }
+    }
+
+    void pack(std::array<U, 32>& r) const {
+        auto y(*this);
+        y.freeze();
+
+        for (std::size_t k = 0; k < 32; ++k) {
+            T v = F::constant(0);
+            for (std::size_t i = 0; i < 10; ++i) {
+                if (8*k + 8 <= pos(i) || 8*k >= pos(i) + width(i)) continue;
+
+                v = F::OR(v, pos(i) >= 8*k
+                                 ? F::SHL(y.m_v[i], pos(i) - 8*k)
+                                 : F::SHR(y.m_v[i], 8*k - pos(i)));
+            }
+
+            r[k] = F::xword(F::AND(v, F::constant(0xff)), r[k]);
+        }
+    }
+
+    B iszero() const {
+        auto t(*this);
+        t.freeze();
+
+        return F::logicalNOT(
+            NS::notequal(t.m_v, F::zero(t.m_v))); // inequality test is imperative
+    }
+
+    B iseq_vartime(const fe25519_10& y) const {
+        auto t1(*this), t2(y);
+        t1.freeze();
+        t2.freeze();
+
+        return F::logicalNOT(
+            NS::notequal(t1.m_v, t2.m_v)); // inequality test is imperative
+    }
+
+    void cmov(const fe25519_10& x, const B& b) {
+        const T mask = F::negate(F::xword(b));
+
+        for (std::size_t i = 0; i < 10; ++i) {
+            m_v[i] = F::XOR(m_v[i],
+                            F::AND(mask,
+                                   F::XOR(x.m_v[i], m_v[i])));
+        }
+    }
+
+    // r = b ? x : y
+    void ternary(const B& b, const fe25519_10& x, const fe25519_10& y) {
+        for (std::size_t i = 0; i < 10; ++i) {
+            m_v[i] = F::ternary(b, x.m_v[i], y.m_v[i]);
+        }
+    }
+
+    // r = a[idx]
+    template <std::size_t N>
+    void arraysubscript(const std::array<fe25519_10, N>& a, const U& idx) {
+        for (std::size_t j = 0; j < 10; ++j) {
+            std::array<T, N> v;
+            for (std::size_t i = 0; i < N; ++i) v[i] = a[i].m_v[j];
+
+            m_v[j] = F::arraysubscript(v, idx);
+        }
+    }
+
+    B getparity() const {
+        auto t(*this);
+        t.freeze();
+
+        return F::testbit(t.m_v[0], 0);
+    }
+
+    void setone() {
+        m_v[0] = F::constant(1);
+
+        for (std::size_t i = 1; i < 10; ++i)
+            m_v[i] = F::constant(0);
+    }
+
+    void setzero() {
+        m_v = F::zero(m_v);
+    }
+
+    void neg(const fe25519_10& x) {
+        fe25519_10 z;
+        z.setzero();
+        sub(z, x);
+    }
+
+    void add(const fe25519_10& x, const fe25519_10& y) {
+        for (std::size_t i = 0; i < 10; ++i)
+            m_v[i] = F::ADDMOD(x.m_v[i], y.m_v[i]);
+
+        carry();
+    }
+
+    void sub(const fe25519_10& x, const fe25519_10& y) {
+        // add 2(2^255-19), carried limbs of y are smaller
+        for (std::size_t i = 0; i < 10; ++i) {
+            const std::uint64_t p2 = 2 * (0 == i ? mask(0) - 18 : mask(i));
+
+            m_v[i] = F::ADDMOD(F::ADDMOD(x.m_v[i], F::constant(p2)),
+                               F::negate(y.m_v[i]));
+        }
+
+        carry();
+    }
+
+    void mul(const fe25519_10& x, const fe25519_10& y) {
+        // t[k] is the sum of x[i] * y[k - i], indices of y wrap around and
+        // these products are times 19 (2^255 = 19). Y[k - i + 10] is the
+        // wrapped y. Products of two odd limbs (only for even k) are doubled
+        // as 2^26 * 2^26 = 2 * 2^51, X2 is x with odd limbs doubled.
+        std::array<T, 20> Y;
+        std::array<T, 10> X2;
+        for (std::size_t j = 0; j < 10; ++j) {
+            Y[j] = times19(y.m_v[j]);
+            Y[j + 10] = y.m_v[j];
+            X2[j] = (j & 1) ? F::SHL(x.m_v[j], 1) : x.m_v[j];
+        }
+
+        std::array<T, 10> t;
+        for (std::size_t k = 0; k < 10; ++k) {
+            const std::array<T, 10>& g = (k & 1) ? x.m_v : X2;
+
+            t[k] = F::MULMOD(g[0], Y[k + 10]);
+            for (std::size_t i = 1; i < 10; ++i) {
+                t[k] = F::ADDMOD(t[k], F::MULMOD(g[i], Y[k - i + 10]));
+            }
+        }
+
+        m_v = t;
+        carry();
+    }
+
+    void square(const fe25519_10& x) {
+        // as mul() with y = x but each product x[i] * x[j], i < j, only
+        // once and doubled. For even k, there are two squares x[i] * x[i]
+        // with i = k/2 and i = k/2 + 5 (wraps around).
+        std::array<T, 20> Y;
+        std::array<T, 10> X2, D, D2;
+        for (std::size_t j = 0; j < 10; ++j) {
+            Y[j] = times19(x.m_v[j]);
+            Y[j + 10] = x.m_v[j];
+            X2[j] = (j & 1) ? F::SHL(x.m_v[j], 1) : x.m_v[j];
+            D[j] = F::SHL(x.m_v[j], 1);
+            D2[j] = F::SHL(X2[j], 1);
+        }
+
+        std::array<T, 10> t = F::zero(t);
+        for (std::size_t k = 0; k < 10; ++k) {
+            const std::array<T, 10>& g = (k & 1) ? D : D2;
+
+            if (!(k & 1)) {
+                t[k] = F::ADDMOD(
+                    F::MULMOD(X2[k / 2], Y[k / 2 + 10]),
+                    F::MULMOD(X2[k / 2 + 5], Y[k / 2 + 5]));
+            }
+
+            // i < j = k - i
+            for (std::size_t i = 0; i < (k + 1) / 2; ++i) {
+                t[k] = F::ADDMOD(t[k], F::MULMOD(g[i], Y[k - i + 10]));
+            }
+
+            // i < j = k - i + 10
+            for (std::size_t i = k + 1; i < (k + 11) / 2; ++i) {
+                t[k] = F::ADDMOD(t[k], F::MULMOD(g[i], Y[k - i + 10]));
+            }
+        }
+
+        m_v = t;
+        carry();
+    }
+
+    // k successive squarings, x^(2^k)
+    void nsquare(const fe25519_10& x, const std::size_t k) {
+        square(x);
+        for (std::size_t i = 1; i < k; ++i) square(*this);
+    }
+
+    // x^(2^255-21) = 1/x
+    void invert(const fe25519_10& x) {
+        fe25519_10 z2, z9, z11, z2_5_0, z2_10_0, z2_20_0, z2_50_0, z2_100_0, t;
+
+        z2.square(x);                                   // 2
+        t.nsquare(z2, 2);                               // 8
+        z9.mul(t, x);                                   // 9
+        z11.mul(z9, z2);                                // 11
+        t.square(z11);                                  // 22
+        z2_5_0.mul(t, z9);                              // 2^5 - 2^0
+
+        t.nsquare(z2_5_0, 5);                           // 2^10 - 2^5
+        z2_10_0.mul(t, z2_5_0);                         // 2^10 - 2^0
+
+        t.nsquare(z2_10_0, 10);                         // 2^20 - 2^10
+        z2_20_0.mul(t, z2_10_0);                        // 2^20 - 2^0
+
+        t.nsquare(z2_20_0, 20);                         // 2^40 - 2^20
+        t.mul(t, z2_20_0);                              // 2^40 - 2^0
+
+        t.nsquare(t, 10);                               // 2^50 - 2^10
+        z2_50_0.mul(t, z2_10_0);                        // 2^50 - 2^0
+
+        t.nsquare(z2_50_0, 50);                         // 2^100 - 2^50
+        z2_100_0.mul(t, z2_50_0);                       // 2^100 - 2^0
+
+        t.nsquare(z2_100_0, 100);                       // 2^200 - 2^100
+        t.mul(t, z2_100_0);                             // 2^200 - 2^0
+
+        t.nsquare(t, 50);                               // 2^250 - 2^50
+        t.mul(t, z2_50_0);                              // 2^250 - 2^0
+
+        t.nsquare(t, 5);                                // 2^255 - 2^5
+        mul(t, z11);                                    // 2^255 - 21
+    }
+
+    // x^(2^252-3) = x^((p-5)/8)
+    void pow2523(const fe25519_10& x) {
+        fe25519_10 z2, z9, z2_5_0, z2_10_0, z2_20_0, z2_50_0, z2_100_0, t;
+
+        z2.square(x);                                   // 2
+        t.nsquare(z2, 2);                               // 8
+        z9.mul(t, x);                                   // 9
+        t.mul(z9, z2);                                  // 11
+        t.square(t);                                    // 22
+        z2_5_0.mul(t, z9);                              // 2^5 - 2^0
+
+        t.nsquare(z2_5_0, 5);                           // 2^10 - 2^5
+        z2_10_0.mul(t, z2_5_0);                         // 2^10 - 2^0
+
+        t.nsquare(z2_10_0, 10);                         // 2^20 - 2^10
+        z2_20_0.mul(t, z2_10_0);                        // 2^20 - 2^0
+
+        t.nsquare(z2_20_0, 20);                         // 2^40 - 2^20
+        t.mul(t, z2_20_0);                              // 2^40 - 2^0
+
+        t.nsquare(t, 10);                               // 2^50 - 2^10
+        z2_50_0.mul(t, z2_10_0);                        // 2^50 - 2^0
+
+        t.nsquare(z2_50_0, 50);                         // 2^100 - 2^50
+        z2_100_0.mul(t, z2_50_0);                       // 2^100 - 2^0
+
+        t.nsquare(z2_100_0, 100);                       // 2^200 - 2^100
+        t.mul(t, z2_100_0);                             // 2^200 - 2^0
+
+        t.nsquare(t, 50);                               // 2^250 - 2^50
+        t.mul(t, z2_50_0);                              // 2^250 - 2^0
+
+        t.nsquare(t, 2);                                // 2^252 - 2^2
+        mul(t, x);                                      // 2^252 - 3
+    }
+
+private:
+    // limb i holds bits pos(i) to pos(i) + width(i) - 1
+    static std::size_t pos(const std::size_t i) {
+        return (51 * i + 1) / 2;
+    }
+
+    static std::size_t width(const std::size_t i) {
+        return (i & 1) ? 25 : 26;
+    }
+
+    static std::uint64_t mask(const std::size_t i) {
+        return (std::uint64_t(1) << width(i)) - 1;
+    }
+
+    static T times19(const T& a) {
+        // return (a << 4) + (a << 1) + a;
+        return F::ADDMOD(
+            F::_ADDMOD(F::_SHL(a, 4), F::_SHL(a, 1)),
+            a);
+    }
+
+    // one pass of carries in two interleaved chains (as in ref10 fe_mul),
+    // limbs 1 and 5 may end a little above 25 bits
+    void carry() {
+        carry(0); carry(4);
+        carry(1); carry(5);
+        carry(2); carry(6);
+        carry(3); carry(7);
+        carry(4); carry(8);
+        carry(9); carry(0);
+    }
+
+    // the carry out of the top limb wraps around times 19
+    void carry(const std::size_t i) {
+        const T c = F::SHR(m_v[i], width(i));
+        m_v[i] = F::AND(m_v[i], F::constant(mask(i)));
+
+        if (9 == i)
+            m_v[0] = F::ADDMOD(m_v[0], times19(c));
+        else
+            m_v[i + 1] = F::ADDMOD(m_v[i + 1], c);
+    }
+
+    std::array<T, 10> m_v{};
+};
+
+} // namespace cryptl
+
+#endif
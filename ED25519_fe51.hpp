@@ -0,0 +1,326 @@
+#ifndef _CRYPTL_ED25519_FE51_HPP_
+#define _CRYPTL_ED25519_FE51_HPP_
+
+#include <array>
+#include <cstdint>
+
+#include <cryptl/BitwiseINT.hpp>
+#include <cryptl/ED25519_fe.hpp>
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// fe25519 specialization for native words
+//
+// Five limbs of 51 bits in 64-bit words, products are 128-bit (GCC and Clang
+// unsigned __int128). Results of add, sub and mul are only carried, not
+// reduced: limbs stay a little above 2^51 and the value below 2^256. The
+// element is reduced modulo 2^255-19 in freeze(), for pack and comparisons.
+//
+// Same interface as the 8-bit limb template that the managed instantiations
+// use, so ge25519 and ED_25519 are unchanged.
+//
+
+template <typename NS>
+class fe25519<std::uint32_t, std::uint8_t, bool, BitwiseINT<std::uint32_t>, NS>
+{
+public:
+    fe25519() = default;
+
+    // specifically needed for ge25519 constants and lookup tables
+    fe25519(const std::array<std::uint8_t, 32>& a) {
+        unpack(a);
+    }
+
+    // reduction modulo 2^255-19
+    void freeze() {
+        carry();
+
+        // q = 1 if value >= 2^255-19
+        std::uint64_t q = (m_v[0] + 19) >> 51;
+        q = (m_v[1] + q) >> 51;
+        q = (m_v[2] + q) >> 51;
+        q = (m_v[3] + q) >> 51;
+        q = (m_v[4] + q) >> 51;
+
+        // subtract q(2^255-19)
+        m_v[0] += 19 * q;
+        m_v[1] += m_v[0] >> 51; m_v[0] &= M51;
+        m_v[2] += m_v[1] >> 51; m_v[1] &= M51;
+        m_v[3] += m_v[2] >> 51; m_v[2] &= M51;
+        m_v[4] += m_v[3] >> 51; m_v[3] &= M51;
+        m_v[4] &= M51;
+    }
+
+    // initialize from byte array
+    void unpack(const std::array<std::uint8_t, 32>& x) {
+        const std::uint64_t
+            w0 = load64(x.data()),
+            w1 = load64(x.data() + 8),
+            w2 = load64(x.data() + 16),
+            w3 = load64(x.data() + 24);
+
+        // top bit is ignored
+        m_v[0] = w0 & M51;
+        m_v[1] = ((w0 >> 51) | (w1 << 13)) & M51;
+        m_v[2] = ((w1 >> 38) | (w2 << 26)) & M51;
+        m_v[3] = ((w2 >> 25) | (w3 << 39)) & M51;
+        m_v[4] = (w3 >> 12) & M51;
+    }
+
+    void pack(std::array<std::uint8_t, 32>& r) const {
+        auto y(*this);
+        y.freeze();
+
+        store64(y.m_v[0] | (y.m_v[1] << 51), r.data());
+        store64((y.m_v[1] >> 13) | (y.m_v[2] << 38), r.data() + 8);
+        store64((y.m_v[2] >> 26) | (y.m_v[3] << 25), r.data() + 16);
+        store64((y.m_v[3] >> 39) | (y.m_v[4] << 12), r.data() + 24);
+    }
+
+    bool iszero() const {
+        auto t(*this);
+        t.freeze();
+
+        return 0 == (t.m_v[0] | t.m_v[1] | t.m_v[2] | t.m_v[3] | t.m_v[4]);
+    }
+
+    bool iseq_vartime(const fe25519& y) const {
+        auto t1(*this), t2(y);
+        t1.freeze();
+        t2.freeze();
+
+        return t1.m_v == t2.m_v;
+    }
+
+    void cmov(const fe25519& x, const bool& b) {
+        const std::uint64_t mask = -std::uint64_t(b);
+
+        for (std::size_t i = 0; i < 5; ++i)
+            m_v[i] ^= mask & (x.m_v[i] ^ m_v[i]);
+    }
+
+    // r = b ? x : y
+    void ternary(const bool& b, const fe25519& x, const fe25519& y) {
+        const std::uint64_t mask = -std::uint64_t(b);
+
+        for (std::size_t i = 0; i < 5; ++i)
+            m_v[i] = (mask & x.m_v[i]) | (~mask & y.m_v[i]);
+    }
+
+    // r = a[idx]
+    template <std::size_t N>
+    void arraysubscript(const std::array<fe25519, N>& a, const std::uint8_t& idx) {
+        *this = a[idx];
+    }
+
+    bool getparity() const {
+        auto t(*this);
+        t.freeze();
+
+        return t.m_v[0] & 1;
+    }
+
+    void setone() {
+        m_v = { 1, 0, 0, 0, 0 };
+    }
+
+    void setzero() {
+        m_v = { 0, 0, 0, 0, 0 };
+    }
+
+    void neg(const fe25519& x) {
+        fe25519 z;
+        z.setzero();
+        sub(z, x);
+    }
+
+    void add(const fe25519& x, const fe25519& y) {
+        for (std::size_t i = 0; i < 5; ++i)
+            m_v[i] = x.m_v[i] + y.m_v[i];
+
+        carry();
+    }
+
+    void sub(const fe25519& x, const fe25519& y) {
+        // add 4(2^255-19) so limbs of y up to 2^53 do not underflow
+        m_v[0] = (x.m_v[0] + 0x1fffffffffffb4) - y.m_v[0];
+        m_v[1] = (x.m_v[1] + 0x1ffffffffffffc) - y.m_v[1];
+        m_v[2] = (x.m_v[2] + 0x1ffffffffffffc) - y.m_v[2];
+        m_v[3] = (x.m_v[3] + 0x1ffffffffffffc) - y.m_v[3];
+        m_v[4] = (x.m_v[4] + 0x1ffffffffffffc) - y.m_v[4];
+
+        carry();
+    }
+
+    void mul(const fe25519& x, const fe25519& y) {
+        const std::uint64_t
+            x0 = x.m_v[0], x1 = x.m_v[1], x2 = x.m_v[2], x3 = x.m_v[3], x4 = x.m_v[4],
+            y0 = y.m_v[0], y1 = y.m_v[1], y2 = y.m_v[2], y3 = y.m_v[3], y4 = y.m_v[4];
+
+        // 2^255 = 19
+        const std::uint64_t
+            y1_19 = 19 * y1, y2_19 = 19 * y2, y3_19 = 19 * y3, y4_19 = 19 * y4;
+
+        const U128
+            r0 = U128(x0) * y0 + U128(x1) * y4_19 + U128(x2) * y3_19
+               + U128(x3) * y2_19 + U128(x4) * y1_19,
+            r1 = U128(x0) * y1 + U128(x1) * y0 + U128(x2) * y4_19
+               + U128(x3) * y3_19 + U128(x4) * y2_19,
+            r2 = U128(x0) * y2 + U128(x1) * y1 + U128(x2) * y0
+               + U128(x3) * y4_19 + U128(x4) * y3_19,
+            r3 = U128(x0) * y3 + U128(x1) * y2 + U128(x2) * y1
+               + U128(x3) * y0 + U128(x4) * y4_19,
+            r4 = U128(x0) * y4 + U128(x1) * y3 + U128(x2) * y2
+               + U128(x3) * y1 + U128(x4) * y0;
+
+        carry(r0, r1, r2, r3, r4);
+    }
+
+    void square(const fe25519& x) {
+        const std::uint64_t
+            x0 = x.m_v[0], x1 = x.m_v[1], x2 = x.m_v[2], x3 = x.m_v[3], x4 = x.m_v[4];
+
+        // symmetric cross products counted twice
+        const std::uint64_t
+            x0_2 = 2 * x0, x1_2 = 2 * x1,
+            x3_19 = 19 * x3, x4_19 = 19 * x4;
+
+        const U128
+            r0 = U128(x0) * x0 + U128(x1_2) * x4_19 + U128(2 * x2) * x3_19,
+            r1 = U128(x0_2) * x1 + U128(2 * x2) * x4_19 + U128(x3) * x3_19,
+            r2 = U128(x0_2) * x2 + U128(x1) * x1 + U128(2 * x3) * x4_19,
+            r3 = U128(x0_2) * x3 + U128(x1_2) * x2 + U128(x4) * x4_19,
+            r4 = U128(x0_2) * x4 + U128(x1_2) * x3 + U128(x2) * x2;
+
+        carry(r0, r1, r2, r3, r4);
+    }
+
+    // k successive squarings, x^(2^k)
+    void nsquare(const fe25519& x, const std::size_t k) {
+        square(x);
+        for (std::size_t i = 1; i < k; ++i) square(*this);
+    }
+
+    // x^(2^255-21) = 1/x
+    void invert(const fe25519& x) {
+        fe25519 z2, z9, z11, z2_5_0, z2_10_0, z2_20_0, z2_50_0, z2_100_0, t;
+
+        z2.square(x);                                   // 2
+        t.nsquare(z2, 2);                               // 8
+        z9.mul(t, x);                                   // 9
+        z11.mul(z9, z2);                                // 11
+        t.square(z11);                                  // 22
+        z2_5_0.mul(t, z9);                              // 2^5 - 2^0
+
+        t.nsquare(z2_5_0, 5);                           // 2^10 - 2^5
+        z2_10_0.mul(t, z2_5_0);                         // 2^10 - 2^0
+
+        t.nsquare(z2_10_0, 10);                         // 2^20 - 2^10
+        z2_20_0.mul(t, z2_10_0);                        // 2^20 - 2^0
+
+        t.nsquare(z2_20_0, 20);                         // 2^40 - 2^20
+        t.mul(t, z2_20_0);                              // 2^40 - 2^0
+
+        t.nsquare(t, 10);                               // 2^50 - 2^10
+        z2_50_0.mul(t, z2_10_0);                        // 2^50 - 2^0
+
+        t.nsquare(z2_50_0, 50);                         // 2^100 - 2^50
+        z2_100_0.mul(t, z2_50_0);                       // 2^100 - 2^0
+
+        t.nsquare(z2_100_0, 100);                       // 2^200 - 2^100
+        t.mul(t, z2_100_0);                             // 2^200 - 2^0
+
+        t.nsquare(t, 50);                               // 2^250 - 2^50
+        t.mul(t, z2_50_0);                              // 2^250 - 2^0
+
+        t.nsquare(t, 5);                                // 2^255 - 2^5
+        mul(t, z11);                                    // 2^255 - 21
+    }
+
+    // x^(2^252-3) = x^((p-5)/8)
+    void pow2523(const fe25519& x) {
+        fe25519 z2, z9, z2_5_0, z2_10_0, z2_20_0, z2_50_0, z2_100_0, t;
+
+        z2.square(x);                                   // 2
+        t.nsquare(z2, 2);                               // 8
+        z9.mul(t, x);                                   // 9
+        t.mul(z9, z2);                                  // 11
+        t.square(t);                                    // 22
+        z2_5_0.mul(t, z9);                              // 2^5 - 2^0
+
+        t.nsquare(z2_5_0, 5);                           // 2^10 - 2^5
+        z2_10_0.mul(t, z2_5_0);                         // 2^10 - 2^0
+
+        t.nsquare(z2_10_0, 10);                         // 2^20 - 2^10
+        z2_20_0.mul(t, z2_10_0);                        // 2^20 - 2^0
+
+        t.nsquare(z2_20_0, 20);                         // 2^40 - 2^20
+        t.mul(t, z2_20_0);                              // 2^40 - 2^0
+
+        t.nsquare(t, 10);                               // 2^50 - 2^10
+        z2_50_0.mul(t, z2_10_0);                        // 2^50 - 2^0
+
+        t.nsquare(z2_50_0, 50);                         // 2^100 - 2^50
+        z2_100_0.mul(t, z2_50_0);                       // 2^100 - 2^0
+
+        t.nsquare(z2_100_0, 100);                       // 2^200 - 2^100
+        t.mul(t, z2_100_0);                             // 2^200 - 2^0
+
+        t.nsquare(t, 50);                               // 2^250 - 2^50
+        t.mul(t, z2_50_0);                              // 2^250 - 2^0
+
+        t.nsquare(t, 2);                                // 2^252 - 2^2
+        mul(t, x);                                      // 2^252 - 3
+    }
+
+private:
+    typedef unsigned __int128 U128;
+
+    static const std::uint64_t M51 = (std::uint64_t(1) << 51) - 1;
+
+    static std::uint64_t load64(const std::uint8_t* a) {
+        // written out so the compiler merges it into one load
+        return std::uint64_t(a[0])
+            | (std::uint64_t(a[1]) << 8)
+            | (std::uint64_t(a[2]) << 16)
+            | (std::uint64_t(a[3]) << 24)
+            | (std::uint64_t(a[4]) << 32)
+            | (std::uint64_t(a[5]) << 40)
+            | (std::uint64_t(a[6]) << 48)
+            | (std::uint64_t(a[7]) << 56);
+    }
+
+    static void store64(const std::uint64_t w, std::uint8_t* a) {
+        for (std::size_t j = 0; j < 8; ++j)
+            a[j] = (w >> (8 * j)) & 0xff;
+    }
+
+    // one pass of carries, the carry out of the top limb wraps around times 19
+    void carry() {
+        std::uint64_t c;
+        c = m_v[0] >> 51; m_v[0] &= M51; m_v[1] += c;
+        c = m_v[1] >> 51; m_v[1] &= M51; m_v[2] += c;
+        c = m_v[2] >> 51; m_v[2] &= M51; m_v[3] += c;
+        c = m_v[3] >> 51; m_v[3] &= M51; m_v[4] += c;
+        c = m_v[4] >> 51; m_v[4] &= M51; m_v[0] += 19 * c;
+    }
+
+    // 128-bit products to limbs
+    void carry(U128 r0, U128 r1, U128 r2, U128 r3, U128 r4) {
+        std::uint64_t c;
+        m_v[0] = std::uint64_t(r0) & M51; c = std::uint64_t(r0 >> 51);
+        r1 += c; m_v[1] = std::uint64_t(r1) & M51; c = std::uint64_t(r1 >> 51);
+        r2 += c; m_v[2] = std::uint64_t(r2) & M51; c = std::uint64_t(r2 >> 51);
+        r3 += c; m_v[3] = std::uint64_t(r3) & M51; c = std::uint64_t(r3 >> 51);
+        r4 += c; m_v[4] = std::uint64_t(r4) & M51; c = std::uint64_t(r4 >> 51);
+        m_v[0] += 19 * c;
+        m_v[1] += m_v[0] >> 51; m_v[0] &= M51;
+    }
+
+    std::array<std::uint64_t, 5> m_v{};
+};
+
+} // namespace cryptl
+
+#endif
@@ -1,16 +1,27 @@
 #ifndef _CRYPTL_ED25519_GE_HPP_
 #define _CRYPTL_ED25519_GE_HPP_
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
+#include <type_traits>
+#include <vector>
 
 #include <cryptl/ED25519_fe.hpp>
+#include <cryptl/ED25519_lanes.hpp>
 #include <cryptl/ED25519_sc.hpp>
 
 namespace cryptl {
 
 // direct translation of: supercop-20141124/crypto_sign/ed25519/ref/ge25519.c
 
+// multi-scalar multiplication switches from Bos-Coster to Pippenger buckets
+const std::size_t ED25519_PIPPENGER_POINTS = 256;
+
+// fixed-base comb table (ED25519_comb.hpp)
+template <typename T, typename U, typename B, typename FT, typename FU, typename NS, typename FE>
+class ge25519_comb;
+
 ////////////////////////////////////////////////////////////////////////////////
 // ge25519_aff
 //
@@ -19,7 +30,9 @@ namespace cryptl {
 // FT is Bitwise for 32-bit
 // FU is Bitwise for 8-bit
 // NS is namespace
-template <typename T, typename U, typename B, typename FT, typename FU, typename NS>
+// FE is the field element (fe25519, fe25519_10)
+template <typename T, typename U, typename B, typename FT, typename FU, typename NS,
+          typename FE = fe25519<T, U, B, FT, NS>>
 class ge25519_aff
 {
     typedef std::uint8_t U8;
@@ -27,8 +40,7 @@ class ge25519_aff
 public:
     ge25519_aff() = default;
 
-    ge25519_aff(const fe25519<T, U, B, FT, NS>& x,
-                const fe25519<T, U, B, FT, NS>& y)
+    ge25519_aff(const FE& x, const FE& y)
         : m_x(x),
           m_y(y)
     {}
@@ -75,7 +87,7 @@ public:
         // cmov_aff(t, &ge25519_base_multiples_affine[5*pos+4],equal(b,-4));
         cmov_aff(base_multiples_affine(5*pos + 4), equal(b, -4));
 
-        fe25519<T, U, B, FT, NS> v;
+        FE v;
 
         // fe25519_neg(&v, &t->x);
         v.neg(m_x);
@@ -84,21 +96,14 @@ public:
         m_x.cmov(v, FU::testbit(b, 7));
     }
 
-    const fe25519<T, U, B, FT, NS>& x() const {
+    const FE& x() const {
         return m_x;
     }
 
-    const fe25519<T, U, B, FT, NS>& y() const {
+    const FE& y() const {
         return m_y;
     }
 
-private:
-    static B equal(const U& b, const std::uint8_t c) {
-        // 1: yes; 0: no
-        return FU::logicalNOT(
-            b != FU::constant(c));
-    }
-
     // Multiples of the base point in affine representation
     static const ge25519_aff& base_multiples_affine(const std::size_t i) {
         typedef ge25519_aff A;
@@ -136,6 +141,13 @@ private:
         }
     }
 
+private:
+    static B equal(const U& b, const std::uint8_t c) {
+        // 1: yes; 0: no
+        return FU::logicalNOT(
+            b != FU::constant(c));
+    }
+
     // cmov_aff()
     // Constant-time version of: if(b) r = p
     void cmov_aff(const ge25519_aff& p, const B& b) {
@@ -146,7 +158,7 @@ private:
         m_y.cmov(p.y(), b);
     }
 
-    fe25519<T, U, B, FT, NS> m_x, m_y;
+    FE m_x, m_y;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -157,7 +169,9 @@ private:
 // FT is Bitwise for 32-bit
 // FU is Bitwise for 8-bit
 // NS is namespace
-template <typename T, typename U, typename B, typename FT, typename FU, typename NS>
+// FE is the field element (fe25519, fe25519_10)
+template <typename T, typename U, typename B, typename FT, typename FU, typename NS,
+          typename FE = fe25519<T, U, B, FT, NS>>
 class ge25519
 {
 public:
@@ -175,20 +189,20 @@ public:
 
     B unpackneg_vartime(const std::array<U, 32>& p) {
         // d
-        static const fe25519<T, U, B, FT, NS> ge25519_ecd({
+        static const FE ge25519_ecd({
             0xA3, 0x78, 0x59, 0x13, 0xCA, 0x4D, 0xEB, 0x75,
             0xAB, 0xD8, 0x41, 0x41, 0x4D, 0x0A, 0x70, 0x00, 
             0x98, 0xE8, 0x79, 0x77, 0x79, 0x40, 0xC7, 0x8C,
             0x73, 0xFE, 0x6F, 0x2B, 0xEE, 0x6C, 0x03, 0x52 });
 
         // sqrt(-1)
-        static const fe25519<T, U, B, FT, NS> ge25519_sqrtm1({
+        static const FE ge25519_sqrtm1({
             0xB0, 0xA0, 0x0E, 0x4A, 0x27, 0x1B, 0xEE, 0xC4,
             0x78, 0xE4, 0x2F, 0xAD, 0x06, 0x18, 0x43, 0x2F, 
             0xA7, 0xD7, 0xFB, 0x3D, 0x99, 0x00, 0x4D, 0x2B,
             0x0B, 0xDF, 0xC1, 0x4F, 0x80, 0x24, 0x83, 0x2B });
 
-        fe25519<T, U, B, FT, NS> t, chk, num, den, den2, den4, den6;
+        FE t, chk, num, den, den2, den4, den6;
 
         // fe25519_setone(&r->z);
         m_z.setone();
@@ -255,11 +269,9 @@ public:
         // if (!fe25519_iseq_vartime(&chk, &num))
         //   fe25519_mul(&r->x, &r->x, &ge25519_sqrtm1);
         const B b3 = chk.iseq_vartime(num);
-        fe25519<T, U, B, FT, NS> x3;
+        FE x3;
         x3.mul(m_x, ge25519_sqrtm1);
-        for (std::size_t i = 0; i < 32; ++i) {
-            m_x[i] = FT::ternary(b3, m_x[i], x3[i]);
-        }
+        m_x.ternary(b3, m_x, x3);
 
         // 4. Now we have one of the two square roots, except if input was not a square
 
@@ -281,25 +293,33 @@ public:
         //   fe25519_neg(&r->x, &r->x);
         const B b5 = m_x.getparity() == FU::testbit(p[31], 7);
         const B b45 = FT::AND(b4, b5);
-        fe25519<T, U, B, FT, NS> x5 = m_x;
+        FE x5 = m_x;
         x5.neg(x5);
-        for (std::size_t i = 0; i < 32; ++i) {
-            m_x[i] = FT::ternary(b45, x5[i], m_x[i]);
-        }
+        m_x.ternary(b45, x5, m_x);
 
         // fe25519_mul(&r->t, &r->x, &r->y);
-        fe25519<T, U, B, FT, NS> t5;
+        FE t5;
         t5.mul(m_x, m_y);
-        for (std::size_t i = 0; i < 32; ++i) {
-            m_t[i] = FT::ternary(b4, t5[i], m_t[i]);
-        }
+        m_t.ternary(b4, t5, m_t);
 
         // return 0;
         return b4;
     }
 
+    // after unpackneg_vartime(p), true if p is the encoding pack() returns
+    // (y reduced, no sign bit when x is zero)
+    B iscanonical_vartime(const std::array<U, 32>& p) const {
+        std::array<U, 32> a;
+        m_y.pack(a);
+        a[31] = FU::OR(a[31], FU::AND(p[31], FU::constant(128)));
+
+        return FT::AND(
+            FT::logicalNOT(NS::notequal(a, p)),
+            FT::logicalNOT(FT::AND(m_x.iszero(), FU::testbit(p[31], 7))));
+    }
+
     void pack(std::array<U, 32>& r) const {
-        fe25519<T, U, B, FT, NS> tx, ty, zi;
+        FE tx, ty, zi;
 
         // fe25519_invert(&zi, &p->z);
         zi.invert(m_z);
@@ -468,17 +488,15 @@ public:
             tmp_tp1p1.add_p1p1(tmp_r, tmp_q);
 
             // }
-            for (std::size_t i = 0; i < 32; ++i) {
-                m_x[i] = FT::ternary(tmp_b, tmp_r.m_x[i], m_x[i]);
-                m_y[i] = FT::ternary(tmp_b, tmp_r.m_y[i], m_y[i]);
-                m_z[i] = FT::ternary(tmp_b, tmp_r.m_z[i], m_z[i]);
-                m_t[i] = FT::ternary(tmp_b, tmp_r.m_t[i], m_t[i]);
-
-                tp1p1.m_x[i] = FT::ternary(tmp_b, tmp_tp1p1.m_x[i], tp1p1.m_x[i]);
-                tp1p1.m_y[i] = FT::ternary(tmp_b, tmp_tp1p1.m_y[i], tp1p1.m_y[i]);
-                tp1p1.m_z[i] = FT::ternary(tmp_b, tmp_tp1p1.m_z[i], tp1p1.m_z[i]);
-                tp1p1.m_t[i] = FT::ternary(tmp_b, tmp_tp1p1.m_t[i], tp1p1.m_t[i]);
-            }
+            m_x.ternary(tmp_b, tmp_r.m_x, m_x);
+            m_y.ternary(tmp_b, tmp_r.m_y, m_y);
+            m_z.ternary(tmp_b, tmp_r.m_z, m_z);
+            m_t.ternary(tmp_b, tmp_r.m_t, m_t);
+
+            tp1p1.m_x.ternary(tmp_b, tmp_tp1p1.m_x, tp1p1.m_x);
+            tp1p1.m_y.ternary(tmp_b, tmp_tp1p1.m_y, tp1p1.m_y);
+            tp1p1.m_z.ternary(tmp_b, tmp_tp1p1.m_z, tp1p1.m_z);
+            tp1p1.m_t.ternary(tmp_b, tmp_tp1p1.m_t, tp1p1.m_t);
 
             // if(i != 0) p1p1_to_p2((ge25519_p2 *)r, &tp1p1);
             // else p1p1_to_p3(r, &tp1p1);
@@ -489,32 +507,107 @@ public:
         }
     }
 
+    // uses the installed comb table if there is one
     void scalarmult_base(sc25519<T, U, B, FT, FU, NS>& s) {
-        // signed char b[85];
-        // sc25519_window3(b,s);
-        std::array<U, 85> b;
-        s.window3(b);
+        if (! scalarmult_comb(s, std::is_integral<U>()))
+            scalarmult_base(s, ge25519_haslanes<FE>());
+    }
 
-        // choose_t((ge25519_aff *)r, 0, b[0]);
-        choose_t(0, b[0]);
+    // odd multiples p, 3p, 5p,..., 15p
+    typedef std::array<ge25519, 8> OddMultiples;
 
-        // fe25519_setone(&r->z);
-        m_z.setone();
+    void oddmultiples(OddMultiples& a) const {
+        ge25519 p2;
+        p2.dbl(*this);
 
-        // fe25519_mul(&r->t, &r->x, &r->y);
-        m_t.mul(m_x, m_y);
+        a[0] = *this;
+        for (std::size_t i = 1; i < 8; ++i)
+            a[i].add(a[i - 1], p2);
+    }
 
-        for (std::size_t i = 1; i < 85; ++i) {
-            ge25519_aff<T, U, B, FT, FU, NS> t;
+    // computes [s1]p1 + [s2]B with signed sliding windows (as in ref10
+    // ge_double_scalarmult_vartime), a1 are the odd multiples of p1 and
+    // B is base(), scalars are 32 byte little endian
+    //
+    // native words only: branches on the scalars
+    void double_scalarmult_base_vartime(const OddMultiples& a1,
+                                        const std::array<U, 32>& s1,
+                                        const std::array<U, 32>& s2) {
+        static const OddMultiples a2 = [] {
+            OddMultiples a;
+            base().oddmultiples(a);
+            return a;
+        }();
 
-            // choose_t(&t, (unsigned long long) i, b[i]);
-            t.choose_t(i, b[i]);
+        std::array<std::int8_t, 256> d1, d2;
+        slide(d1, s1);
+        slide(d2, s2);
 
-            // ge25519_mixadd2(r, &t);
-            mixadd2(t);
+        setneutral();
+
+        std::size_t i = 256;
+        while (i > 0 && 0 == d1[i - 1] && 0 == d2[i - 1]) --i;
+
+        ge25519 tp1p1, q;
+
+        for (; i > 0; --i) {
+            tp1p1.dbl_p1p1(*this);
+
+            if (0 != d1[i - 1]) {
+                p1p1_to_p3(tp1p1);
+                if (d1[i - 1] > 0) {
+                    tp1p1.add_p1p1(*this, a1[d1[i - 1] / 2]);
+                } else {
+                    q.neg(a1[-d1[i - 1] / 2]);
+                    tp1p1.add_p1p1(*this, q);
+                }
+            }
+
+            if (0 != d2[i - 1]) {
+                p1p1_to_p3(tp1p1);
+                if (d2[i - 1] > 0) {
+                    tp1p1.add_p1p1(*this, a2[d2[i - 1] / 2]);
+                } else {
+                    q.neg(a2[-d2[i - 1] / 2]);
+                    tp1p1.add_p1p1(*this, q);
+                }
+            }
+
+            if (i > 1)
+                p1p1_to_p2(tp1p1);
+            else
+                p1p1_to_p3(tp1p1);
         }
     }
 
+    // computes [s[0]]p[0] + ... + [s[n-1]]p[n-1], scalars are 32 byte little
+    // endian and below 2^253 (reduced sc25519)
+    //
+    // native words only: branches on the scalars and compares them, which
+    // the managed policies do not have (see lt_vartime in sc25519)
+    void multi_scalarmult_vartime(const std::vector<ge25519>& p,
+                                  const std::vector<std::array<U, 32>>& s) {
+        std::vector<Limbs> a(s.size());
+        for (std::size_t i = 0; i < s.size(); ++i)
+            a[i] = limbs(s[i]);
+
+        multi_scalarmult_vartime(p, a, ge25519_haslanes<FE>());
+    }
+
+    // r = p + q (extended coordinates)
+    void add(const ge25519& p, const ge25519& q) {
+        ge25519 tp1p1;
+        tp1p1.add_p1p1(p, q);
+        p1p1_to_p3(tp1p1);
+    }
+
+    // r = [8]p, clears small order components
+    void mul8(const ge25519& p) {
+        dbl(p);
+        dbl(*this);
+        dbl(*this);
+    }
+
     // Packed coordinates of the base point
     static const ge25519& base() {
         static const ge25519 a(
@@ -546,6 +639,97 @@ public:
     }
 
 private:
+    friend class ge25519_comb<T, U, B, FT, FU, NS, FE>;
+
+    // native words only
+    bool scalarmult_comb(sc25519<T, U, B, FT, FU, NS>& s, std::true_type) {
+        const auto* a = ge25519_comb<T, U, B, FT, FU, NS, FE>::installed();
+        if (nullptr == a) return false;
+
+        std::array<U, 32> b;
+        s.to32bytes(b);
+        a->scalarmult(*this, b);
+        return true;
+    }
+
+    bool scalarmult_comb(sc25519<T, U, B, FT, FU, NS>&, std::false_type) {
+        return false;
+    }
+
+    void scalarmult_base(sc25519<T, U, B, FT, FU, NS>& s, std::false_type) {
+        // signed char b[85];
+        // sc25519_window3(b,s);
+        std::array<U, 85> b;
+        s.window3(b);
+
+        // choose_t((ge25519_aff *)r, 0, b[0]);
+        choose_t(0, b[0]);
+
+        // fe25519_setone(&r->z);
+        m_z.setone();
+
+        // fe25519_mul(&r->t, &r->x, &r->y);
+        m_t.mul(m_x, m_y);
+
+        for (std::size_t i = 1; i < 85; ++i) {
+            ge25519_aff<T, U, B, FT, FU, NS, FE> t;
+
+            // choose_t(&t, (unsigned long long) i, b[i]);
+            t.choose_t(i, b[i]);
+
+            // ge25519_mixadd2(r, &t);
+            mixadd2(t);
+        }
+    }
+
+#ifdef __AVX2__
+    void scalarmult_base(sc25519<T, U, B, FT, FU, NS>& s, std::true_type) {
+        std::array<U, 85> b;
+        s.window3(b);
+
+        ge25519_lanes r;
+        r.scalarmult_base(lanesbase().data(), b);
+        fromlanes(r);
+    }
+
+    // base_multiples_affine() for ge25519_lanes
+    static const std::vector<ge25519_lanes::Affine>& lanesbase() {
+        static const std::vector<ge25519_lanes::Affine> a = [] {
+            std::vector<ge25519_lanes::Affine> v;
+            for (std::size_t i = 0; i < 425; ++i) {
+                const auto& q = ge25519_aff<T, U, B, FT, FU, NS, FE>::base_multiples_affine(i);
+
+                std::array<U, 32> x, y;
+                q.x().pack(x);
+                q.y().pack(y);
+                v.emplace_back(x, y);
+            }
+
+            return v;
+        }();
+
+        return a;
+    }
+
+    void tolanes(ge25519_lanes& r) const {
+        std::array<std::array<U, 32>, 4> a;
+        m_x.pack(a[0]);
+        m_y.pack(a[1]);
+        m_z.pack(a[2]);
+        m_t.pack(a[3]);
+        r.unpack(a);
+    }
+
+    void fromlanes(const ge25519_lanes& r) {
+        std::array<std::array<U, 32>, 4> a;
+        r.pack(a);
+        m_x = FE(a[0]);
+        m_y = FE(a[1]);
+        m_z = FE(a[2]);
+        m_t = FE(a[3]);
+    }
+#endif
+
     void p1p1_to_p2(const ge25519& p) {
         // fe25519_mul(&r->x, &p->x, &p->t);
         m_x.mul(p.m_x, p.m_t);
@@ -565,15 +749,15 @@ private:
         m_t.mul(p.m_x, p.m_y);
     }
 
-    void mixadd2(const ge25519_aff<T, U, B, FT, FU, NS>& q) {
+    void mixadd2(const ge25519_aff<T, U, B, FT, FU, NS, FE>& q) {
         // 2*d
-        static const fe25519<T, U, B, FT, NS> ge25519_ec2d({
+        static const FE ge25519_ec2d({
             0x59, 0xF1, 0xB2, 0x26, 0x94, 0x9B, 0xD6, 0xEB,
             0x56, 0xB1, 0x83, 0x82, 0x9A, 0x14, 0xE0, 0x00, 
             0x30, 0xD1, 0xF3, 0xEE, 0xF2, 0x80, 0x8E, 0x19,
             0xE7, 0xFC, 0xDF, 0x56, 0xDC, 0xD9, 0x06, 0x24 });
 
-        fe25519<T, U, B, FT, NS> a, b, t1, t2, c, d, e, f, g, h, qt;
+        FE a, b, t1, t2, c, d, e, f, g, h, qt;
 
         // fe25519_mul(&qt, &q->x, &q->y);
         qt.mul(q.x(), q.y());
@@ -632,13 +816,13 @@ private:
 
     void add_p1p1(const ge25519& p, const ge25519& q) {
         // 2*d
-        static const fe25519<T, U, B, FT, NS> ge25519_ec2d({
+        static const FE ge25519_ec2d({
             0x59, 0xF1, 0xB2, 0x26, 0x94, 0x9B, 0xD6, 0xEB,
             0x56, 0xB1, 0x83, 0x82, 0x9A, 0x14, 0xE0, 0x00, 
             0x30, 0xD1, 0xF3, 0xEE, 0xF2, 0x80, 0x8E, 0x19,
             0xE7, 0xFC, 0xDF, 0x56, 0xDC, 0xD9, 0x06, 0x24 });
 
-        fe25519<T, U, B, FT, NS> a, b, c, d, t;
+        FE a, b, c, d, t;
 
         // fe25519_sub(&a, &p->y, &p->x); /* A = (Y1-X1)*(Y2-X2) */
         a.sub(p.m_y, p.m_x);
@@ -685,7 +869,7 @@ private:
 
     // See http://www.hyperelliptic.org/EFD/g1p/auto-twisted-extended-1.html#doubling-dbl-2008-hwcd
     void dbl_p1p1(const ge25519& p) {
-        fe25519<T, U, B, FT, NS> a, b, c, d;
+        FE a, b, c, d;
 
         // fe25519_square(&a, &p->x);
         a.square(p.m_x);
@@ -739,7 +923,7 @@ private:
     }
 
     void choose_t(const std::size_t pos, const U& b) {
-        ge25519_aff<T, U, B, FT, FU, NS> a(m_x, m_y);
+        ge25519_aff<T, U, B, FT, FU, NS, FE> a(m_x, m_y);
         a.choose_t(pos, b);
         m_x = a.x();
         m_y = a.y();
@@ -747,26 +931,313 @@ private:
 
     template <std::size_t N>
     void subscript(const std::array<ge25519, N>& pre, const U& idx) {
-        for (std::size_t j = 0; j < 32; ++j) {
-            std::array<T, N> ax, ay, az, at;
+        std::array<FE, N> ax, ay, az, at;
+
+        for (std::size_t i = 0; i < N; ++i) {
+            ax[i] = pre[i].m_x;
+            ay[i] = pre[i].m_y;
+            az[i] = pre[i].m_z;
+            at[i] = pre[i].m_t;
+        }
+
+        m_x.arraysubscript(ax, idx);
+        m_y.arraysubscript(ay, idx);
+        m_z.arraysubscript(az, idx);
+        m_t.arraysubscript(at, idx);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    // multi-scalar multiplication (native, variable time)
+    //
+
+    // scalar as four 64-bit words, little endian
+    typedef std::array<std::uint64_t, 4> Limbs;
+
+    static Limbs limbs(const std::array<U, 32>& s) {
+        Limbs a;
+        for (std::size_t i = 0; i < 4; ++i) {
+            a[i] = 0;
+            for (std::size_t j = 0; j < 8; ++j)
+                a[i] |= std::uint64_t(s[8*i + j]) << (8 * j);
+        }
+
+        return a;
+    }
+
+    static std::size_t bitlength(const Limbs& a) {
+        for (std::size_t i = 4; i > 0; --i) {
+            if (a[i - 1]) return 64*i - __builtin_clzll(a[i - 1]);
+        }
+
+        return 0;
+    }
+
+    static bool lessthan(const Limbs& a, const Limbs& b) {
+        for (std::size_t i = 4; i > 0; --i) {
+            if (a[i - 1] != b[i - 1]) return a[i - 1] < b[i - 1];
+        }
+
+        return false;
+    }
+
+    // a -= b, requires b <= a
+    static void subtract(Limbs& a, const Limbs& b) {
+        std::uint64_t borrow = 0;
+        for (std::size_t i = 0; i < 4; ++i) {
+            const std::uint64_t t = a[i] - b[i];
+            const std::uint64_t c = (a[i] < b[i]) | (t < borrow);
+            a[i] = t - borrow;
+            borrow = c;
+        }
+    }
+
+    // c bits at bit position k
+    static std::uint64_t bits(const Limbs& a, const std::size_t k, const std::size_t c) {
+        if (k >= 256) return 0;
+
+        std::uint64_t w = a[k / 64] >> (k % 64);
+        if (k % 64 + c > 64 && k / 64 < 3)
+            w |= a[k / 64 + 1] << (64 - k % 64);
+
+        return w & ((std::uint64_t(1) << c) - 1);
+    }
+
+    // digits in {0, +-1, +-3,..., +-15} with a = sum r[i] 2^i, nonzero
+    // digits at least five positions apart (ref10 slide)
+    static void slide(std::array<std::int8_t, 256>& r, const std::array<U, 32>& a) {
+        for (std::size_t i = 0; i < 256; ++i)
+            r[i] = 1 & (a[i / 8] >> (i % 8));
+
+        for (std::size_t i = 0; i < 256; ++i) {
+            if (0 == r[i]) continue;
+
+            for (std::size_t b = 1; b <= 6 && i + b < 256; ++b) {
+                if (0 == r[i + b]) continue;
+
+                if (r[i] + (r[i + b] << b) <= 15) {
+                    r[i] += r[i + b] << b;
+                    r[i + b] = 0;
+                } else if (r[i] - (r[i + b] << b) >= -15) {
+                    r[i] -= r[i + b] << b;
+                    for (std::size_t k = i + b; k < 256; ++k) {
+                        if (0 == r[k]) {
+                            r[k] = 1;
+                            break;
+                        }
+                        r[k] = 0;
+                    }
+                } else {
+                    break;
+                }
+            }
+        }
+    }
+
+    // r = 2p
+    void dbl(const ge25519& p) {
+        ge25519 tp1p1;
+        tp1p1.dbl_p1p1(p);
+        p1p1_to_p3(tp1p1);
+    }
+
+    void neg(const ge25519& p) {
+        m_x.neg(p.m_x);
+        m_y = p.m_y;
+        m_z = p.m_z;
+        m_t.neg(p.m_t);
+    }
+
+    // no precomputed form for the second operand of add
+    typedef ge25519 Cached;
 
+    void cache(ge25519& c) const {
+        c = *this;
+    }
+
+    void multi_scalarmult_vartime(const std::vector<ge25519>& p,
+                                  const std::vector<Limbs>& s,
+                                  std::false_type) {
+        if (p.size() < ED25519_PIPPENGER_POINTS)
+            boscoster_vartime(*this, p, s);
+        else
+            pippenger_vartime(*this, p, s);
+    }
+
+#ifdef __AVX2__
+    // Bos-Coster adds two changing points (three lane multiplications for
+    // nine scalar ones), no faster in lanes. Pippenger adds the cached
+    // input points (two lane multiplications).
+    void multi_scalarmult_vartime(const std::vector<ge25519>& p,
+                                  const std::vector<Limbs>& s,
+                                  std::true_type) {
+        if (p.size() < ED25519_PIPPENGER_POINTS) {
+            boscoster_vartime(*this, p, s);
+            return;
+        }
+
+        std::vector<ge25519_lanes> q(p.size());
+        for (std::size_t i = 0; i < p.size(); ++i)
+            p[i].tolanes(q[i]);
+
+        ge25519_lanes r;
+        pippenger_vartime(r, q, s);
+        fromlanes(r);
+    }
+#endif
+
+    // The algorithms below are templates over the point type P (ge25519 or
+    // ge25519_lanes) with setneutral(), add(p, q), dbl(p), neg(p) and
+    // cache(c) for repeated second operands of add.
+
+    // r = [s]p with unsigned 4-bit windows
+    template <typename P>
+    static void scalarmult_vartime(P& r, const P& p, const Limbs& s) {
+        std::array<P, 16> pre;
+        pre[1] = p;
+        for (std::size_t i = 2; i < 16; ++i)
+            pre[i].add(pre[i - 1], p);
+
+        r.setneutral();
+
+        for (std::size_t i = 64; i > 0; --i) {
+            for (std::size_t j = 0; j < 4; ++j)
+                r.dbl(r);
+
+            const std::uint64_t d = bits(s, 4*(i - 1), 4);
+            if (0 != d) r.add(r, pre[d]);
+        }
+    }
+
+    // Bos-Coster: [a]P + [b]Q = [a - b]P + [b](P + Q) for the two largest
+    // scalars a >= b, until one scalar is left
+    template <typename P>
+    static void boscoster_vartime(P& r, std::vector<P> p, std::vector<Limbs> s) {
+        // fewer point additions to multiply out a scalar this much larger
+        const std::size_t FARBITS = 8;
+
+        const auto cmp = [&s] (const std::size_t i, const std::size_t j) {
+            return lessthan(s[i], s[j]);
+        };
+
+        std::vector<std::size_t> heap;
+        for (std::size_t i = 0; i < s.size(); ++i) {
+            if (0 != bitlength(s[i])) heap.push_back(i);
+        }
+
+        std::make_heap(heap.begin(), heap.end(), cmp);
+
+        r.setneutral();
+        P q;
+
+        while (heap.size() > 1) {
+            std::pop_heap(heap.begin(), heap.end(), cmp);
+            const std::size_t i = heap.back(), j = heap.front();
+
+            if (bitlength(s[i]) > bitlength(s[j]) + FARBITS) {
+                scalarmult_vartime(q, p[i], s[i]);
+                r.add(r, q);
+                heap.pop_back();
+                continue;
+            }
+
+            subtract(s[i], s[j]);
+            p[j].add(p[j], p[i]);
+
+            if (0 == bitlength(s[i]))
+                heap.pop_back();
+            else
+                std::push_heap(heap.begin(), heap.end(), cmp);
+        }
+
+        if (1 == heap.size()) {
+            scalarmult_vartime(q, p[heap[0]], s[heap[0]]);
+            r.add(r, q);
+        }
+    }
+
+    // Pippenger: signed c-bit digits, one bucket per digit magnitude and
+    // window, buckets summed with a running sum
+    template <typename P>
+    static void pippenger_vartime(P& r, const std::vector<P>& p, const std::vector<Limbs>& s) {
+        const std::size_t N = p.size();
+
+        // window width minimizing about (255 / c) * (N + 2^c) additions
+        std::size_t c = 2;
+        for (std::size_t k = 3; k <= 16; ++k) {
+            if ((255 / k + 1) * (N + (std::size_t(1) << k))
+                < (255 / c + 1) * (N + (std::size_t(1) << c)))
+                c = k;
+        }
+
+        // scalars below 2^253, the top digit takes the last carry
+        const std::size_t W = 255 / c + 1;
+        const std::int64_t H = std::int64_t(1) << (c - 1);
+
+        std::vector<std::int32_t> digit(N * W);
+        for (std::size_t i = 0; i < N; ++i) {
+            std::int64_t carry = 0;
+            for (std::size_t w = 0; w < W; ++w) {
+                std::int64_t d = std::int64_t(bits(s[i], w*c, c)) + carry;
+                carry = d >= H;
+                if (carry) d -= 2 * H;
+                digit[i*W + w] = d;
+            }
+        }
+
+        std::vector<P> negp(N);
+        std::vector<typename P::Cached> cp(N), cn(N);
+        for (std::size_t i = 0; i < N; ++i) {
+            negp[i].neg(p[i]);
+            p[i].cache(cp[i]);
+            cn[i].neg(cp[i]);
+        }
+
+        std::vector<P> bucket(H);
+        std::vector<bool> used(H);
+
+        r.setneutral();
+        P sum, acc;
+
+        for (std::size_t w = W; w > 0; --w) {
+            for (std::size_t j = 0; j < c; ++j)
+                r.dbl(r);
+
+            used.assign(H, false);
             for (std::size_t i = 0; i < N; ++i) {
-                ax[i] = pre[i].m_x[j];
-                ay[i] = pre[i].m_y[j];
-                az[i] = pre[i].m_z[j];
-                at[i] = pre[i].m_t[j];
+                const std::int32_t d = digit[i*W + w - 1];
+                if (0 == d) continue;
+
+                const std::size_t k = (d > 0 ? d : -d) - 1;
+
+                if (used[k]) {
+                    bucket[k].add(bucket[k], d > 0 ? cp[i] : cn[i]);
+                } else {
+                    bucket[k] = d > 0 ? p[i] : negp[i];
+                    used[k] = true;
+                }
             }
 
-            m_x[j] = FT::arraysubscript(ax, idx);
-            m_y[j] = FT::arraysubscript(ay, idx);
-            m_z[j] = FT::arraysubscript(az, idx);
-            m_t[j] = FT::arraysubscript(at, idx);
+            // sum of k * bucket[k - 1]
+            bool any = false;
+            sum.setneutral();
+            acc.setneutral();
+            for (std::size_t k = H; k > 0; --k) {
+                if (used[k - 1]) {
+                    sum.add(sum, bucket[k - 1]);
+                    any = true;
+                }
+                if (any) acc.add(acc, sum);
+            }
+
+            if (any) r.add(r, acc);
         }
     }
 
-    fe25519<T, U, B, FT, NS> m_x, m_y, m_z, m_t;
+    FE m_x, m_y, m_z, m_t;
 };
 
 } // namespace cryptl
 
+#include <cryptl/ED25519_comb.hpp>
+
 #endif
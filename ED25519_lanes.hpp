@@ -0,0 +1,663 @@
+#ifndef _CRYPTL_ED25519_LANES_HPP_
+#define _CRYPTL_ED25519_LANES_HPP_
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include <cryptl/BitwiseINT.hpp>
+#include <cryptl/ED25519_fe.hpp>
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// ge25519 in four lanes (AVX2)
+//
+// The X, Y, Z and T coordinates of a point in extended coordinates are the
+// four 64-bit lanes of ten 256-bit registers, one register per limb of
+// radix 2^25.5 (as fe25519_10). The point formulas are arranged so that
+// each step is one 4-way field multiplication (_mm256_mul_epu32): doubling
+// and addition of a cached point are two multiplications, where the scalar
+// code has eight or nine.
+//
+// Used by ge25519 for scalarmult_base and Pippenger multi-scalar
+// multiplication when the field element is the native radix 2^51 fe25519.
+//
+
+// field elements with a lanes backend
+template <typename FE>
+struct ge25519_haslanes : std::false_type {};
+
+#if defined(__AVX2__) && defined(__SIZEOF_INT128__)
+template <typename NS>
+struct ge25519_haslanes<fe25519<std::uint32_t,
+                                std::uint8_t,
+                                bool,
+                                BitwiseINT<std::uint32_t>,
+                                NS>> : std::true_type {};
+#endif
+
+#ifdef __AVX2__
+
+////////////////////////////////////////////////////////////////////////////////
+// fe25519_lanes
+//
+// Four field elements, limb i of lane l in register m_v[i]. Only used for
+// temporaries: registers on the stack are aligned, the points are stored
+// in arrays of words (std::vector does not align to 32 bytes).
+//
+// Limbs are unsigned. add, sub and neg end with one parallel carry step,
+// enough to keep limbs below 2^27 for _mm256_mul_epu32 operands (19 times
+// a limb must fit 32 bits). mul ends with a full carry chain.
+//
+
+class fe25519_lanes
+{
+public:
+    typedef std::array<std::uint8_t, 32> Bytes;
+
+    // lane selection for shuffle() and blend()
+    enum { A = 0, B = 1, C = 2, D = 3 };
+
+    fe25519_lanes() = default;
+
+    void load(const std::uint64_t* a) {
+        #pragma GCC unroll 10
+        for (std::size_t i = 0; i < 10; ++i)
+            m_v[i] = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(a + 4*i));
+    }
+
+    void store(std::uint64_t* a) const {
+        #pragma GCC unroll 10
+        for (std::size_t i = 0; i < 10; ++i)
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(a + 4*i), m_v[i]);
+    }
+
+    // 32-bit limbs
+    void load(const std::uint32_t* a) {
+        #pragma GCC unroll 10
+        for (std::size_t i = 0; i < 10; ++i)
+            m_v[i] = _mm256_cvtepu32_epi64(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + 4*i)));
+    }
+
+    void store(std::uint32_t* a) const {
+        const __m256i lo = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+
+        #pragma GCC unroll 10
+
+        for (std::size_t i = 0; i < 10; ++i)
+            _mm_storeu_si128(
+                reinterpret_cast<__m128i*>(a + 4*i),
+                _mm256_castsi256_si128(
+                    _mm256_permutevar8x32_epi32(m_v[i], lo)));
+    }
+
+    // lane l is the element with bytes x[l] (top bit ignored)
+    void unpack(const std::array<Bytes, 4>& x) {
+        std::array<std::array<std::uint64_t, 10>, 4> t;
+        for (std::size_t l = 0; l < 4; ++l) {
+            #pragma GCC unroll 10
+            for (std::size_t i = 0; i < 10; ++i) {
+                std::uint64_t v = 0;
+                for (std::size_t k = pos(i) / 8; k < 32 && 8*k < pos(i) + width(i); ++k) {
+                    v |= 8*k >= pos(i)
+                        ? std::uint64_t(x[l][k]) << (8*k - pos(i))
+                        : std::uint64_t(x[l][k]) >> (pos(i) - 8*k);
+                }
+
+                t[l][i] = v & mask(i);
+            }
+        }
+
+        #pragma GCC unroll 10
+
+        for (std::size_t i = 0; i < 10; ++i)
+            m_v[i] = _mm256_setr_epi64x(t[0][i], t[1][i], t[2][i], t[3][i]);
+    }
+
+    // reduced modulo 2^255-19
+    void pack(std::array<Bytes, 4>& r) const {
+        std::array<std::uint64_t, 40> a;
+        store(a.data());
+
+        for (std::size_t l = 0; l < 4; ++l) {
+            std::array<std::uint64_t, 10> t;
+            #pragma GCC unroll 10
+            for (std::size_t i = 0; i < 10; ++i)
+                t[i] = a[4*i + l];
+
+            freeze(t);
+
+            r[l].fill(0);
+            #pragma GCC unroll 10
+            for (std::size_t i = 0; i < 10; ++i) {
+                for (std::size_t k = pos(i) / 8; k < 32 && 8*k < pos(i) + width(i); ++k) {
+                    r[l][k] |= 0xff & (8*k >= pos(i)
+                                       ? t[i] >> (8*k - pos(i))
+                                       : t[i] << (pos(i) - 8*k));
+                }
+            }
+        }
+    }
+
+    // lanes (a, b, c, d) with small values
+    void set(const std::uint32_t a, const std::uint32_t b,
+             const std::uint32_t c, const std::uint32_t d) {
+        m_v[0] = _mm256_setr_epi64x(a, b, c, d);
+        #pragma GCC unroll 10
+        for (std::size_t i = 1; i < 10; ++i)
+            m_v[i] = _mm256_setzero_si256();
+    }
+
+    // lane l of the result is lane Ll of x
+    template <int LA, int LB, int LC, int LD>
+    void shuffle(const fe25519_lanes& x) {
+        #pragma GCC unroll 10
+        for (std::size_t i = 0; i < 10; ++i)
+            m_v[i] = _mm256_permute4x64_epi64(
+                x.m_v[i], LA | (LB << 2) | (LC << 4) | (LD << 6));
+    }
+
+    // lanes set in MASK (bit l for lane l) from y, the others from x
+    template <int MASK>
+    void blend(const fe25519_lanes& x, const fe25519_lanes& y) {
+        #pragma GCC unroll 10
+        for (std::size_t i = 0; i < 10; ++i)
+            m_v[i] = _mm256_blend_epi32(
+                x.m_v[i], y.m_v[i],
+                (MASK & 1 ? 0x03 : 0) | (MASK & 2 ? 0x0c : 0) |
+                (MASK & 4 ? 0x30 : 0) | (MASK & 8 ? 0xc0 : 0));
+    }
+
+    // constant time: r = y in lanes where mask is all ones
+    void cmov(const fe25519_lanes& y, const __m256i mask) {
+        #pragma GCC unroll 10
+        for (std::size_t i = 0; i < 10; ++i)
+            m_v[i] = _mm256_blendv_epi8(m_v[i], y.m_v[i], mask);
+    }
+
+    void add(const fe25519_lanes& x, const fe25519_lanes& y) {
+        #pragma GCC unroll 10
+        for (std::size_t i = 0; i < 10; ++i)
+            m_v[i] = _mm256_add_epi64(x.m_v[i], y.m_v[i]);
+
+        weakcarry();
+    }
+
+    // x + 2(2^255-19) - y
+    void sub(const fe25519_lanes& x, const fe25519_lanes& y) {
+        #pragma GCC unroll 10
+        for (std::size_t i = 0; i < 10; ++i) {
+            const __m256i p2 = _mm256_set1_epi64x(
+                2 * (0 == i ? mask(0) - 18 : mask(i)));
+
+            m_v[i] = _mm256_sub_epi64(_mm256_add_epi64(x.m_v[i], p2), y.m_v[i]);
+        }
+
+        weakcarry();
+    }
+
+    void neg(const fe25519_lanes& x) {
+        fe25519_lanes z;
+        z.set(0, 0, 0, 0);
+        sub(z, x);
+    }
+
+    // x[l] * y[l] in each lane l, see fe25519_10::mul
+    void mul(const fe25519_lanes& x, const fe25519_lanes& y) {
+        const __m256i n19 = _mm256_set1_epi64x(19);
+
+        // operand scanning keeps the ten sums in registers
+        __m256i Y[20];
+        #pragma GCC unroll 10
+        for (std::size_t j = 0; j < 10; ++j) {
+            Y[j] = _mm256_mul_epu32(y.m_v[j], n19);
+            Y[j + 10] = y.m_v[j];
+        }
+
+        __m256i t[10];
+        #pragma GCC unroll 10
+        for (std::size_t k = 0; k < 10; ++k)
+            t[k] = _mm256_setzero_si256();
+
+        #pragma GCC unroll 10
+        for (std::size_t i = 0; i < 10; ++i) {
+            // odd x[i] times odd y[k - i] (k even) doubled
+            const __m256i g = x.m_v[i];
+            const __m256i g2 = (i & 1) ? _mm256_slli_epi64(g, 1) : g;
+
+            #pragma GCC unroll 10
+            for (std::size_t k = 0; k < 10; ++k) {
+                t[k] = _mm256_add_epi64(
+                    t[k], _mm256_mul_epu32((k & 1) ? g : g2, Y[k - i + 10]));
+            }
+        }
+
+        for (std::size_t i = 0; i < 10; ++i)
+            m_v[i] = t[i];
+
+        carry(0); carry(4);
+        carry(1); carry(5);
+        carry(2); carry(6);
+        carry(3); carry(7);
+        carry(4); carry(8);
+        carry(9); carry(0);
+    }
+
+    // x[l]^2 in each lane l, products x[i] * x[j] with i < j counted once
+    // and doubled
+    void square(const fe25519_lanes& x) {
+        const __m256i n19 = _mm256_set1_epi64x(19);
+
+        // x, 2x, 19x and 38x
+        __m256i x1[10], x2[10], x19[10], x38[10];
+        #pragma GCC unroll 10
+        for (std::size_t j = 0; j < 10; ++j) {
+            x1[j] = x.m_v[j];
+            x2[j] = _mm256_slli_epi64(x.m_v[j], 1);
+            x19[j] = _mm256_mul_epu32(x.m_v[j], n19);
+            x38[j] = _mm256_slli_epi64(x19[j], 1);
+        }
+
+        __m256i t[10];
+        #pragma GCC unroll 10
+        for (std::size_t k = 0; k < 10; ++k)
+            t[k] = _mm256_setzero_si256();
+
+        #pragma GCC unroll 10
+
+        for (std::size_t i = 0; i < 10; ++i) {
+            #pragma GCC unroll 10
+            for (std::size_t j = i; j < 10; ++j) {
+                const bool odd = (i & 1) && (j & 1);
+                const __m256i* g = i + j < 10
+                    ? (odd ? x2 : x1)
+                    : (odd ? x38 : x19);
+
+                const __m256i u = _mm256_mul_epu32(i == j ? x1[i] : x2[i], g[j]);
+                t[(i + j) % 10] = _mm256_add_epi64(t[(i + j) % 10], u);
+            }
+        }
+
+        #pragma GCC unroll 10
+
+        for (std::size_t i = 0; i < 10; ++i)
+            m_v[i] = t[i];
+
+        carry(0); carry(4);
+        carry(1); carry(5);
+        carry(2); carry(6);
+        carry(3); carry(7);
+        carry(4); carry(8);
+        carry(9); carry(0);
+    }
+
+private:
+    static std::size_t pos(const std::size_t i) {
+        return (51 * i + 1) / 2;
+    }
+
+    static std::size_t width(const std::size_t i) {
+        return (i & 1) ? 25 : 26;
+    }
+
+    static std::uint64_t mask(const std::size_t i) {
+        return (std::uint64_t(1) << width(i)) - 1;
+    }
+
+    static __m256i times19(const __m256i a) {
+        return _mm256_add_epi64(
+            _mm256_add_epi64(_mm256_slli_epi64(a, 4), _mm256_slli_epi64(a, 1)),
+            a);
+    }
+
+    // carry out of limb i, the top limb wraps around times 19
+    void carry(const std::size_t i) {
+        const __m256i c = _mm256_srli_epi64(m_v[i], width(i));
+        m_v[i] = _mm256_and_si256(m_v[i], _mm256_set1_epi64x(mask(i)));
+
+        if (9 == i)
+            m_v[0] = _mm256_add_epi64(m_v[0], times19(c));
+        else
+            m_v[i + 1] = _mm256_add_epi64(m_v[i + 1], c);
+    }
+
+    // all limbs at once, limbs below 2^31 end below 2^26 + 2^11
+    void weakcarry() {
+        __m256i c[10];
+        #pragma GCC unroll 10
+        for (std::size_t i = 0; i < 10; ++i) {
+            c[i] = _mm256_srli_epi64(m_v[i], width(i));
+            m_v[i] = _mm256_and_si256(m_v[i], _mm256_set1_epi64x(mask(i)));
+        }
+
+        m_v[0] = _mm256_add_epi64(m_v[0], times19(c[9]));
+        #pragma GCC unroll 10
+        for (std::size_t i = 1; i < 10; ++i)
+            m_v[i] = _mm256_add_epi64(m_v[i], c[i - 1]);
+    }
+
+    // reduction modulo 2^255-19 of one lane
+    static void freeze(std::array<std::uint64_t, 10>& t) {
+        for (std::size_t n = 0; n < 2; ++n) {
+            #pragma GCC unroll 10
+            for (std::size_t i = 0; i < 9; ++i) {
+                t[i + 1] += t[i] >> width(i);
+                t[i] &= mask(i);
+            }
+
+            t[0] += 19 * (t[9] >> 25);
+            t[9] &= mask(9);
+        }
+
+        // q = 1 if value >= 2^255-19
+        std::uint64_t q = (t[0] + 19) >> 26;
+        #pragma GCC unroll 10
+        for (std::size_t i = 1; i < 10; ++i)
+            q = (t[i] + q) >> width(i);
+
+        // subtract q(2^255-19)
+        t[0] += 19 * q;
+        #pragma GCC unroll 10
+        for (std::size_t i = 0; i < 9; ++i) {
+            t[i + 1] += t[i] >> width(i);
+            t[i] &= mask(i);
+        }
+        t[9] &= mask(9);
+    }
+
+    __m256i m_v[10];
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// ge25519_lanes
+//
+
+class ge25519_lanes
+{
+public:
+    typedef fe25519_lanes::Bytes Bytes;
+
+    // affine point as (y - x, y + x, 2dxy, 2), for scalarmult_base
+    class Affine
+    {
+    public:
+        Affine() = default;
+
+        Affine(const Bytes& x, const Bytes& y) {
+            fe25519_lanes a, b, t, u, v;
+
+            // (x, y, x, y), (y, x, y, x)
+            t.unpack({ x, y, x, y });
+            u.shuffle<fe25519_lanes::B, fe25519_lanes::A,
+                      fe25519_lanes::D, fe25519_lanes::C>(t);
+
+            // (y - x, y + x, xy, 2)
+            a.sub(u, t);
+            b.add(u, t);
+            a.blend<2>(a, b);
+            b.mul(t, u);
+            a.blend<4>(a, b);
+            v.set(0, 0, 0, 2);
+            a.blend<8>(a, v);
+
+            // times (1, 1, 2d, 1)
+            b.blend<4>(one(), ec2d());
+            a.mul(a, b);
+            a.store(m_v.data());
+        }
+
+        std::array<std::uint32_t, 40> m_v;
+    };
+
+    ge25519_lanes() = default;
+
+    // from packed coordinates x, y, z, t
+    void unpack(const std::array<Bytes, 4>& xyzt) {
+        fe25519_lanes a;
+        a.unpack(xyzt);
+        a.store(m_v.data());
+    }
+
+    void pack(std::array<Bytes, 4>& xyzt) const {
+        fe25519_lanes a;
+        a.load(m_v.data());
+        a.pack(xyzt);
+    }
+
+    void setneutral() {
+        fe25519_lanes a;
+        a.set(0, 1, 1, 0);
+        a.store(m_v.data());
+    }
+
+    void neg(const ge25519_lanes& p) {
+        fe25519_lanes a, b;
+        a.load(p.m_v.data());
+
+        // (-X, Y, Z, -T)
+        b.neg(a);
+        a.blend<9>(a, b);
+        a.store(m_v.data());
+    }
+
+    // second operand of add as (Y - X, Y + X, 2dT, 2Z)
+    class Cached
+    {
+    public:
+        void neg(const Cached& q) {
+            using L = fe25519_lanes;
+            fe25519_lanes a, b;
+            a.load(q.m_v.data());
+
+            // (Y + X, Y - X, -2dT, 2Z)
+            a.shuffle<L::B, L::A, L::C, L::D>(a);
+            b.neg(a);
+            a.blend<4>(a, b);
+            a.store(m_v.data());
+        }
+
+        std::array<std::uint64_t, 40> m_v;
+    };
+
+    void cache(Cached& c) const {
+        fe25519_lanes a, b;
+        a.load(m_v.data());
+
+        sumdiff(a, a);
+        b.blend<4>(two(), ec2d());
+        a.mul(a, b);
+        a.store(c.m_v.data());
+    }
+
+    // r = p + q
+    void add(const ge25519_lanes& p, const Cached& q) {
+        fe25519_lanes a, b;
+        a.load(p.m_v.data());
+        b.load(q.m_v.data());
+        addcached(a, b);
+        a.store(m_v.data());
+    }
+
+    void add(const ge25519_lanes& p, const ge25519_lanes& q) {
+        Cached c;
+        q.cache(c);
+        add(p, c);
+    }
+
+    // r = 2p
+    void dbl(const ge25519_lanes& p) {
+        using L = fe25519_lanes;
+        fe25519_lanes a, b, s, n;
+        a.load(p.m_v.data());
+
+        // (X, Y, Z, X + Y)
+        b.shuffle<L::A, L::A, L::A, L::A>(a);
+        b.blend<7>(b, zero());
+        a.shuffle<L::A, L::B, L::C, L::B>(a);
+        a.add(a, b);
+
+        // (X^2, Y^2, Z^2, (X + Y)^2) = (A, B, C, E')
+        s.square(a);
+
+        // G = B - A, H = -A - B, F = G - 2C, E = E' + H
+        a.shuffle<L::B, L::B, L::B, L::B>(s);
+        b.shuffle<L::A, L::A, L::A, L::A>(s);
+        n.add(a, b);
+        n.neg(n);                         // H
+        a.sub(a, b);                      // G
+
+        // (G, G, G - 2C, H)
+        b.shuffle<L::C, L::C, L::C, L::C>(s);
+        b.add(b, b);
+        b.sub(a, b);
+        a.blend<4>(a, b);
+        a.blend<8>(a, n);
+
+        // (E, G, F, E) and (F, H, G, H)
+        b.shuffle<L::D, L::D, L::D, L::D>(s);
+        b.add(b, n);                      // E
+        s.shuffle<L::D, L::B, L::C, L::D>(a);
+        s.blend<9>(s, b);
+        b.shuffle<L::C, L::D, L::A, L::D>(a);
+
+        // (EF, GH, FG, EH)
+        a.mul(s, b);
+        a.store(m_v.data());
+    }
+
+    // constant time r = [b[0]]P[0] + ... + [b[84]]P[84], b in -4..3 and
+    // table[5i + k] is kP[i] (k = 0, 1, 2, 3, 4)
+    void scalarmult_base(const Affine* table, const std::array<std::uint8_t, 85>& b) {
+        using L = fe25519_lanes;
+        fe25519_lanes r, q, t, n;
+        r.set(0, 1, 1, 0);
+
+        for (std::size_t i = 0; i < 85; ++i) {
+            const std::int64_t
+                d = static_cast<std::int8_t>(b[i]),
+                neg = (d >> 63) & 1,
+                m = (d ^ -neg) + neg;
+
+            q.load(table[5*i].m_v.data());
+            for (std::int64_t k = 1; k < 5; ++k) {
+                t.load(table[5*i + k].m_v.data());
+                q.cmov(t, _mm256_set1_epi64x(-std::int64_t(m == k)));
+            }
+
+            // -(x, y) is (y + x, y - x, -2dxy, 2)
+            t.shuffle<L::B, L::A, L::C, L::D>(q);
+            n.neg(t);
+            t.blend<4>(t, n);
+            q.cmov(t, _mm256_set1_epi64x(-neg));
+
+            addcached(r, q);
+        }
+
+        r.store(m_v.data());
+    }
+
+private:
+    // r = (Y - X, Y + X, T, Z) from p = (X, Y, Z, T)
+    static void sumdiff(fe25519_lanes& r, const fe25519_lanes& p) {
+        using L = fe25519_lanes;
+        fe25519_lanes a, b, n;
+
+        a.shuffle<L::B, L::B, L::D, L::C>(p);
+        b.shuffle<L::A, L::A, L::A, L::A>(p);
+        b.blend<12>(b, zero());
+        n.neg(b);
+        b.blend<1>(b, n);
+        r.add(a, b);
+    }
+
+    // p += q with q as (Y2 - X2, Y2 + X2, 2dT2, 2Z2)
+    static void addcached(fe25519_lanes& p, const fe25519_lanes& q) {
+        using L = fe25519_lanes;
+        fe25519_lanes s, n, a, b;
+
+        // (A, B, C, D)
+        sumdiff(s, p);
+        s.mul(s, q);
+        n.neg(s);
+
+        // (E, G, F, E) = (B - A, D + C, D - C, B - A)
+        a.shuffle<L::B, L::D, L::D, L::B>(s);
+        b.shuffle<L::A, L::C, L::C, L::A>(n);
+        n.shuffle<L::A, L::C, L::C, L::A>(s);
+        b.blend<2>(b, n);
+        a.add(a, b);
+
+        // (F, H, G, H) = (D - C, B + A, D + C, B + A)
+        b.shuffle<L::C, L::A, L::C, L::A>(s);
+        n.neg(b);
+        b.blend<1>(b, n);
+        s.shuffle<L::D, L::B, L::D, L::B>(s);
+        b.add(s, b);
+
+        // (EF, GH, FG, EH)
+        p.mul(a, b);
+    }
+
+    static const fe25519_lanes& zero() {
+        static const fe25519_lanes a = [] {
+            fe25519_lanes z;
+            z.set(0, 0, 0, 0);
+            return z;
+        }();
+
+        return a;
+    }
+
+    static const fe25519_lanes& one() {
+        static const fe25519_lanes a = [] {
+            fe25519_lanes z;
+            z.set(1, 1, 1, 1);
+            return z;
+        }();
+
+        return a;
+    }
+
+    // (1, 1, 1, 2)
+    static const fe25519_lanes& two() {
+        static const fe25519_lanes a = [] {
+            fe25519_lanes z;
+            z.set(1, 1, 1, 2);
+            return z;
+        }();
+
+        return a;
+    }
+
+    // 2*d in all lanes
+    static const fe25519_lanes& ec2d() {
+        static const fe25519_lanes a = [] {
+            const Bytes d{
+                0x59, 0xF1, 0xB2, 0x26, 0x94, 0x9B, 0xD6, 0xEB,
+                0x56, 0xB1, 0x83, 0x82, 0x9A, 0x14, 0xE0, 0x00,
+                0x30, 0xD1, 0xF3, 0xEE, 0xF2, 0x80, 0x8E, 0x19,
+                0xE7, 0xFC, 0xDF, 0x56, 0xDC, 0xD9, 0x06, 0x24 };
+
+            fe25519_lanes z;
+            z.unpack({ d, d, d, d });
+            return z;
+        }();
+
+        return a;
+    }
+
+    std::array<std::uint64_t, 40> m_v;
+};
+
+#endif
+
+} // namespace cryptl
+
+#endif
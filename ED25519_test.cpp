@@ -1,13 +1,17 @@
 #include <array>
 #include <cstdint>
+#include <cstdio>
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
 #include <string>
 #include <unistd.h>
 #include <vector>
 
 #include <cryptl/ASCII_Hex.hpp>
+#include <cryptl/CTR_DRBG.hpp>
 #include <cryptl/ED25519.hpp>
+#include <cryptl/ED25519_cache.hpp>
 #include <cryptl/NS_cryptl.hpp>
 
 using namespace cryptl;
@@ -24,17 +28,320 @@ void printUsage(const char* exeName) {
     cout << "public key:   " << exeName << SK << endl;
     cout << "sign message: " << exeName << SK << M << endl;
     cout << "open message: " << exeName << PK << M << R << S << endl;
+    cout << "known answer: " << exeName << " -k" << endl;
+}
+
+// encoding of A + (0, -1) = (-x, -y), A has x != 0
+array<uint8_t, 32> addOrder2(const array<uint8_t, 32>& a)
+{
+    // p - y with p = 2^255 - 19
+    array<uint8_t, 32> r;
+    int borrow = 0;
+    for (size_t i = 0; i < 32; ++i) {
+        const int
+            p = (0 == i) ? 0xed : (31 == i) ? 0x7f : 0xff,
+            y = (31 == i) ? (a[i] & 0x7f) : a[i],
+            d = p - y - borrow;
+
+        r[i] = d & 0xff;
+        borrow = d < 0;
+    }
+
+    r[31] |= (a[31] & 0x80) ^ 0x80;
+    return r;
+}
+
+// batch open with a public key that has an order 2 component, open()
+// rejects about half of the signatures and the cofactored batch and its
+// per-signature fallback accept all of them
+bool torsionBatch()
+{
+    array<uint8_t, 32> sk, pk, R, S;
+    for (size_t i = 0; i < 32; ++i) sk[i] = i;
+    ED25519::keypair(pk, sk);
+
+    const auto pkt = addOrder2(pk);
+
+    vector<array<uint8_t, 32>> vR, vS, vpk;
+    vector<vector<uint8_t>> vm;
+
+    // three signatures with pk, one with pkt that open() rejects
+    for (uint8_t i = 0; vR.size() < 4; ++i) {
+        const vector<uint8_t> m(1, i);
+        const bool torsion = 3 == vR.size();
+
+        ED25519::sign(R, S, m, torsion ? pkt : pk, sk);
+        if (torsion && ED25519::open(R, S, m, pkt)) continue;
+
+        vR.push_back(R);
+        vS.push_back(S);
+        vm.push_back(m);
+        vpk.push_back(torsion ? pkt : pk);
+    }
+
+    uint8_t seed = 0;
+    CTR_DRBG_AES128 rng(
+        [&seed] (uint8_t* out, size_t n) {
+            for (size_t i = 0; i < n; ++i) out[i] = seed + i;
+            return true;
+        });
+
+    vector<bool> valid;
+    for (size_t i = 0; i < 64; ++i) {
+        seed = i;
+        rng.instantiate();
+
+        if (! ED25519::open_batch(vR, vS, vm, vpk, valid, rng) ||
+            valid != vector<bool>(4, true))
+            return false;
+    }
+
+    // a bad signature makes every signature be checked on its own
+    vS[0][0] ^= 1;
+    return
+        ! ED25519::open_batch(vR, vS, vm, vpk, valid, rng) &&
+        valid == vector<bool>({ false, true, true, true });
+}
+
+// RFC 8032 7.2 and 7.3 test vectors
+struct RFC8032 {
+    bool ph;
+    string sk, pk, m, ctx, sig;
+};
+
+const vector<RFC8032> rfc8032Vectors = {
+    // Ed25519ctx, context foo
+    { false,
+      "0305334e381af78f141cb666f6199f57bc3495335a256a95bd2a55bf546663f6",
+      "dfc9425e4f968f7f0c29f0259cf5f9aed6851c2bb4ad8bfb860cfee0ab248292",
+      "f726936d19c800494e3fdaff20b276a8",
+      "666f6f",
+      "55a4cc2f70a54e04288c5f4cd1e45a7bb520b36292911876cada7323198dd87a"
+      "8b36950b95130022907a7fb7c4e9b2d5f6cca685a587b4b21f4b888e4e7edb0d" },
+
+    // Ed25519ctx, context bar
+    { false,
+      "0305334e381af78f141cb666f6199f57bc3495335a256a95bd2a55bf546663f6",
+      "dfc9425e4f968f7f0c29f0259cf5f9aed6851c2bb4ad8bfb860cfee0ab248292",
+      "f726936d19c800494e3fdaff20b276a8",
+      "626172",
+      "fc60d5872fc46b3aa69f8b5b4351d5808f92bcc044606db097abab6dbcb1aee3"
+      "216c48e8b3b66431b5b186d1d28f8ee15a5ca2df6668346291c2043d4eb3e90d" },
+
+    // Ed25519ph, message abc
+    { true,
+      "833fe62409237b9d62ec77587520911e9a759cec1d19755b7da901b96dca3d42",
+      "ec172b93ad5e563bf4932c70e1245034c35467ef2efd4d64ebf819683467e2bf",
+      "616263",
+      "",
+      "98a70222f0b8121aa9d30f813d683f809e462b469c7ff87639499bb94e6dae41"
+      "31f85042463c2a355a2003d062adf5aaa10b8c61e636062aaad11c2a26083406" } };
+
+// sign and open with sign_ctx/open_ctx or sign_ph/open_ph, a changed
+// context must not open
+bool rfc8032()
+{
+    for (const auto& v : rfc8032Vectors) {
+        array<uint8_t, 32> sk, pk, R, S;
+        vector<uint8_t> m, ctx;
+        if (!asciiHexToArray(v.sk, sk) ||
+            !asciiHexToArray(v.pk, pk) ||
+            !asciiHexToVector(v.m, m) ||
+            (!v.ctx.empty() && !asciiHexToVector(v.ctx, ctx)))
+            return false;
+
+        const ED25519::SigningKey skey(sk);
+        const ED25519::VerifyKey vk(pk);
+        if (skey.pk() != pk) return false;
+
+        SHA_Stream<SHA512> ph;
+        ph.update(m);
+
+        vector<uint8_t> badctx(ctx);
+        badctx.push_back(0);
+
+        bool ok, bad;
+        if (v.ph) {
+            ok = ED25519::sign_ph(R, S, ph, ctx.data(), ctx.size(), skey) &&
+                ED25519::open_ph(R, S, ph, ctx.data(), ctx.size(), vk);
+            bad = ED25519::open_ph(R, S, ph, badctx.data(), badctx.size(), vk);
+        } else {
+            ok = ED25519::sign_ctx(R, S, m.data(), m.size(), ctx.data(), ctx.size(), skey) &&
+                ED25519::open_ctx(R, S, m.data(), m.size(), ctx.data(), ctx.size(), vk);
+            bad = ED25519::open_ctx(R, S, m.data(), m.size(), badctx.data(), badctx.size(), vk);
+        }
+
+        if (!ok || bad || asciiHex(R) + asciiHex(S) != v.sig) return false;
+    }
+
+    return true;
+}
+
+// keypair with a generated and a loaded comb table, a file with one
+// changed entry must not load
+bool combTable()
+{
+    const string fileName = "ED25519_comb.tmp";
+
+    array<uint8_t, 32> sk, pk, pk2;
+    for (size_t i = 0; i < 32; ++i) sk[i] = 3 * i;
+    ED25519::keypair(pk, sk);
+
+    const ED25519::BaseTable table(5, 2);
+    ED25519::BaseTable::install(&table);
+    ED25519::keypair(pk2, sk);
+    ED25519::BaseTable::install(nullptr);
+    if (pk2 != pk || !table.save(fileName)) return false;
+
+    auto loaded = ED25519::BaseTable::load(fileName);
+    if (!loaded) return false;
+
+    ED25519::BaseTable::install(loaded.get());
+    ED25519::keypair(pk2, sk);
+    ED25519::BaseTable::install(nullptr);
+    if (pk2 != pk) return false;
+
+    // last octet of an entry in the middle of the table
+    {
+        fstream fs(fileName, ios::in | ios::out | ios::binary);
+        const streamoff pos = 64 + table.fileBytes() / 2 - 1;
+        fs.seekg(pos);
+        const char c = fs.get() ^ 1;
+        fs.seekp(pos);
+        fs.put(c);
+    }
+
+    loaded = ED25519::BaseTable::load(fileName);
+    remove(fileName.c_str());
+    return !loaded;
+}
+
+// ten limb field, the default only without 128-bit products
+typedef ED_25519<bool,
+                 uint8_t,
+                 uint32_t,
+                 uint64_t,
+                 BitwiseINT<uint8_t>,
+                 BitwiseINT<uint32_t>,
+                 BitwiseINT<uint64_t>,
+                 uint64_t,
+                 SHA_Functions<uint64_t, uint64_t, BitwiseINT<uint64_t>>,
+                 NS,
+                 fe25519_10<uint64_t, uint8_t, bool, BitwiseINT<uint64_t>, NS>>
+    ED25519_10;
+
+// same keys and signatures as the default typedef, each opens the
+// other's signatures and rejects a changed one
+bool fieldTen()
+{
+    for (size_t n = 0; n < 8; ++n) {
+        array<uint8_t, 32> sk, pk, pk10, R, S, R10, S10;
+        for (size_t i = 0; i < 32; ++i) sk[i] = 7 * i + n;
+        const vector<uint8_t> m(13 * n, n);
+
+        ED25519::keypair(pk, sk);
+        ED25519_10::keypair(pk10, sk);
+        if (pk10 != pk) return false;
+
+        ED25519::sign(R, S, m, pk, sk);
+        ED25519_10::sign(R10, S10, m, pk, sk);
+        if (R10 != R || S10 != S) return false;
+
+        if (!ED25519_10::open(R, S, m, pk) || !ED25519::open(R10, S10, m, pk))
+            return false;
+
+        S10[n] ^= 1;
+        if (ED25519_10::open(R10, S10, m, pk)) return false;
+    }
+
+    return true;
+}
+
+// hits return the cached key, the least recently used key is evicted at
+// capacity, a key that is not a point stays invalid and opens nothing
+bool verifyKeyCache()
+{
+    typedef ED25519_VerifyKeyCache<ED25519> Cache;
+
+    array<array<uint8_t, 32>, 3> pk;
+    array<uint8_t, 32> sk, R, S;
+    for (size_t n = 0; n < 3; ++n) {
+        for (size_t i = 0; i < 32; ++i) sk[i] = 5 * i + n;
+        ED25519::keypair(pk[n], sk);
+    }
+
+    // sk is the secret key of pk[2]
+    vector<uint8_t> m(40, 0x5a);
+    ED25519::sign(R, S, m, pk[2], sk);
+
+    Cache cache(2);
+    const auto a = cache.get(pk[0]), b = cache.get(pk[1]);
+    if (cache.get(pk[0]) != a || 2 != cache.size()) return false;
+
+    // pk[1] is least recently used
+    const auto c = cache.get(pk[2]);
+    if (2 != cache.size() || cache.get(pk[0]) != a || cache.get(pk[2]) != c)
+        return false;
+    if (cache.get(pk[1]) == b || !b->valid() || b->pk() != pk[1])
+        return false;
+
+    // pk[1] evicted pk[0], pk[2] is still cached
+    if (!cache.open(R, S, m, pk[2]) ||
+        !cache.open(R, S, m.data(), m.size(), pk[2]) ||
+        cache.get(pk[2]) != c)
+        return false;
+
+    // message changed and wrong key
+    m[39] ^= 1;
+    if (cache.open(R, S, m.data(), m.size(), pk[2])) return false;
+    m[39] ^= 1;
+    if (cache.open(R, S, m.data(), m.size(), pk[1])) return false;
+
+    // about half of all y have no x
+    array<uint8_t, 32> bad = pk[2];
+    while (ED25519::VerifyKey(bad).valid()) ++bad[0];
+
+    cache.clear();
+    if (0 != cache.size() || cache.get(bad)->valid() ||
+        cache.open(R, S, m, bad) || cache.open(R, S, m.data(), m.size(), bad))
+        return false;
+
+    return 1 == cache.size();
+}
+
+// built-in tests, prints OK or FAIL for each
+bool knownAnswers()
+{
+    const vector<pair<string, bool (*)()>> tests = {
+        { "batch with small order component", torsionBatch },
+        { "RFC 8032 Ed25519ctx and Ed25519ph", rfc8032 },
+        { "fixed-base comb table", combTable },
+        { "ten limb field against the default", fieldTen },
+        { "verification key cache", verifyKeyCache } };
+
+    bool all = true;
+    for (const auto& t : tests) {
+        const bool ok = t.second();
+        cout << (ok ? "OK" : "FAIL") << " " << t.first << endl;
+        all = all && ok;
+    }
+
+    return all;
 }
 
 int main(int argc, char *argv[])
 {
     array<uint8_t, 32> sk, pk, R, S;
     vector<uint8_t> m;
-    bool bs = false, bp = false, bm = false, bR = false, bS = false;
+    bool bs = false, bp = false, bm = false, bR = false, bS = false, bk = false;
     int opt;
-    while (-1 != (opt = getopt(argc, argv, "s:p:m:R:S:"))) {
+    while (-1 != (opt = getopt(argc, argv, "s:p:m:R:S:k"))) {
         switch (opt) {
 
+        case ('k') : // known answer tests
+            bk = true;
+            break;
+
         case ('s') : // secret key
             if (!asciiHexToArray(optarg, sk)) {
                 cerr << "error: secret key in hex: " << optarg << endl;
@@ -77,6 +384,10 @@ int main(int argc, char *argv[])
         }
     }
 
+    if (bk) {
+        return knownAnswers() ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
     if (bs) {
         if (!bp && !bR && !bS) {
             // calculate public key
@@ -0,0 +1,149 @@
+#ifndef _CRYPTL_GF256_HPP_
+#define _CRYPTL_GF256_HPP_
+
+#include <array>
+#include <cstdint>
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// GF(2^8) with the AES irreducible polynomial x^8 + x^4 + x^3 + x + 1
+//
+// All tables are generated at compile time by constexpr functions (C++11
+// single return statement form) and live in static read-only storage.
+//
+
+namespace gf256 {
+
+constexpr std::uint8_t xtime(const std::uint8_t a) {
+    return ((a << 1) ^ ((a >> 7) * 0x1b)) & 0xff;
+}
+
+// bit-serial multiplication (compile time only)
+constexpr std::uint8_t mul(const std::uint8_t a, const std::uint8_t b) {
+    return 0 == b
+        ? 0
+        : ((b & 1) ? a : 0) ^ mul(xtime(a), b >> 1);
+}
+
+// square and multiply
+constexpr std::uint8_t pow(const std::uint8_t a, const unsigned int e) {
+    return 0 == e
+        ? 1
+        : mul((e & 1) ? a : 1, pow(mul(a, a), e >> 1));
+}
+
+// multiplicative inverse, 0 maps to 0
+constexpr std::uint8_t inv(const std::uint8_t a) {
+    return pow(a, 254);
+}
+
+// discrete logarithm to base {03} by search, i is the exponent of v
+constexpr std::uint8_t logSearch(const std::uint8_t a,
+                                 const unsigned int i,
+                                 const std::uint8_t v) {
+    return (v == a || i >= 255) ? i % 255 : logSearch(a, i + 1, mul(v, 3));
+}
+
+constexpr std::uint8_t rotl(const std::uint8_t a, const unsigned int n) {
+    return ((a << n) | (a >> (8 - n))) & 0xff;
+}
+
+// FIPS 197 5.1.1 affine transformation of the inverse
+constexpr std::uint8_t affine(const std::uint8_t b) {
+    return b ^ rotl(b, 1) ^ rotl(b, 2) ^ rotl(b, 3) ^ rotl(b, 4) ^ 0x63;
+}
+
+// inverse of the affine transformation
+constexpr std::uint8_t invAffine(const std::uint8_t b) {
+    return rotl(b, 1) ^ rotl(b, 3) ^ rotl(b, 6) ^ 0x05;
+}
+
+// table generators
+struct SBoxGen {
+    static constexpr std::uint8_t value(const std::uint8_t a) {
+        return affine(inv(a));
+    }
+};
+
+struct InvSBoxGen {
+    static constexpr std::uint8_t value(const std::uint8_t a) {
+        return inv(invAffine(a));
+    }
+};
+
+struct ExpGen {
+    static constexpr std::uint8_t value(const std::uint8_t a) {
+        return pow(3, a);
+    }
+};
+
+struct LogGen {
+    static constexpr std::uint8_t value(const std::uint8_t a) {
+        return 0 == a ? 0 : logSearch(a, 0, 1);
+    }
+};
+
+// compile time integer sequence (std::index_sequence is C++14)
+template <std::size_t... I> struct IndexSeq {};
+
+template <std::size_t N, std::size_t... I>
+struct MakeIndexSeq : MakeIndexSeq<N - 1, N - 1, I...> {};
+
+template <std::size_t... I>
+struct MakeIndexSeq<0, I...> : IndexSeq<I...> {};
+
+template <typename GEN, std::size_t... I>
+constexpr std::array<std::uint8_t, sizeof...(I)> table(IndexSeq<I...>) {
+    return {{ GEN::value(I)... }};
+}
+
+// FIPS 197 Figure 7 and 5.1.1 example
+static_assert(0x63 == SBoxGen::value(0x00) &&
+              0xed == SBoxGen::value(0x53) &&
+              0x16 == SBoxGen::value(0xff), "S-box");
+
+static_assert(0x00 == InvSBoxGen::value(0x63) &&
+              0x53 == InvSBoxGen::value(0xed), "inverse S-box");
+
+// FIPS 197 4.2 example {57} * {83} = {c1}
+static_assert(0xc1 == mul(0x57, 0x83), "multiply");
+
+} // namespace gf256
+
+template <typename T = std::uint8_t>
+class GF256
+{
+public:
+    typedef std::array<std::uint8_t, 256> TableType;
+
+    static constexpr TableType sbox =
+        gf256::table<gf256::SBoxGen>(gf256::MakeIndexSeq<256>());
+
+    static constexpr TableType invsbox =
+        gf256::table<gf256::InvSBoxGen>(gf256::MakeIndexSeq<256>());
+
+    // antilog, exp[i] = {03}^i
+    static constexpr TableType exp =
+        gf256::table<gf256::ExpGen>(gf256::MakeIndexSeq<256>());
+
+    // log to base {03}, log[0] is unused
+    static constexpr TableType log =
+        gf256::table<gf256::LogGen>(gf256::MakeIndexSeq<256>());
+
+    // table-driven multiplication, no branch on operand values but the
+    // table index depends on them (not constant time under cache timing)
+    static T multiply(const T x, const T y) {
+        const T nonzero = -T((0 != x) & (0 != y));
+        return exp[(log[x] + log[y]) % 255] & nonzero;
+    }
+};
+
+template <typename T> constexpr typename GF256<T>::TableType GF256<T>::sbox;
+template <typename T> constexpr typename GF256<T>::TableType GF256<T>::invsbox;
+template <typename T> constexpr typename GF256<T>::TableType GF256<T>::exp;
+template <typename T> constexpr typename GF256<T>::TableType GF256<T>::log;
+
+} // namespace cryptl
+
+#endif
@@ -0,0 +1,118 @@
+#ifndef _CRYPTL_HMAC_HPP_
+#define _CRYPTL_HMAC_HPP_
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <cryptl/SHA_256.hpp>
+#include <cryptl/SHA_Stream.hpp>
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// HMAC (FIPS PUB 198-1)
+//
+// Keyed-hash message authentication code over octet streams. The hash
+// states after the inner and outer padded keys are computed once with the
+// key, so each message only hashes its own data. Input of any chunk size
+// is hashed with SHA_Stream, the message is never held in memory.
+//
+// H is an unmanaged SHA (SHA1, SHA224, SHA256, SHA384, SHA512,...).
+//
+
+template <typename H = SHA256>
+class HMAC
+{
+public:
+    typedef typename H::WordType WordType;
+
+    static const std::size_t WORD_OCTETS = SHA_Stream<H>::WORD_OCTETS;
+    static const std::size_t BLOCK_OCTETS = SHA_Stream<H>::BLOCK_OCTETS;
+    static const std::size_t TAG_OCTETS = SHA_Stream<H>::DIGEST_OCTETS;
+
+    typedef std::array<std::uint8_t, TAG_OCTETS> TagType;
+
+    HMAC(const std::uint8_t* key, const std::size_t keyLength) {
+        rekey(key, keyLength);
+    }
+
+    explicit HMAC(const std::vector<std::uint8_t>& key) {
+        rekey(key.data(), key.size());
+    }
+
+    void rekey(const std::uint8_t* key, const std::size_t keyLength) {
+        // K0 is the key, or its digest if longer than a block
+        std::array<std::uint8_t, BLOCK_OCTETS> K0;
+        K0.fill(0);
+
+        if (keyLength > BLOCK_OCTETS) {
+            m_hash.init();
+            m_hash.update(key, keyLength);
+            m_hash.finalize(K0.data());
+        } else {
+            for (std::size_t i = 0; i < keyLength; ++i)
+                K0[i] = key[i];
+        }
+
+        std::array<std::uint8_t, BLOCK_OCTETS> pad;
+
+        for (std::size_t i = 0; i < BLOCK_OCTETS; ++i)
+            pad[i] = K0[i] ^ 0x36;
+
+        m_inner.init();
+        m_inner.update(pad.data(), pad.size());
+
+        for (std::size_t i = 0; i < BLOCK_OCTETS; ++i)
+            pad[i] = K0[i] ^ 0x5c;
+
+        m_outer.init();
+        m_outer.update(pad.data(), pad.size());
+
+        init();
+    }
+
+    // start a new message
+    void init() {
+        m_hash = m_inner;
+    }
+
+    void update(const std::uint8_t* in, const std::size_t inLength) {
+        m_hash.update(in, inLength);
+    }
+
+    void update(const std::vector<std::uint8_t>& in) {
+        m_hash.update(in);
+    }
+
+    // tag for the message, then ready for the next message
+    void finalize(TagType& tag) {
+        TagType inner;
+        m_hash.finalize(inner.data());
+
+        m_hash = m_outer;
+        m_hash.update(inner.data(), inner.size());
+        m_hash.finalize(tag.data());
+
+        init();
+    }
+
+    // constant time comparison with the expected tag
+    bool verify(const TagType& tag) {
+        TagType a;
+        finalize(a);
+
+        std::uint8_t diff = 0;
+        for (std::size_t i = 0; i < TAG_OCTETS; ++i)
+            diff |= a[i] ^ tag[i];
+
+        return 0 == diff;
+    }
+
+private:
+    SHA_Stream<H> m_hash, m_inner, m_outer;
+};
+
+} // namespace cryptl
+
+#endif
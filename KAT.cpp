@@ -0,0 +1,1651 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <initializer_list>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+#include <cryptl/AES.hpp>
+#include <cryptl/AES_SBoxCircuit.hpp>
+#include <cryptl/AES_VPerm.hpp>
+#include <cryptl/ASCII_Hex.hpp>
+#include <cryptl/BLAKE3.hpp>
+#include <cryptl/BitwiseINT.hpp>
+#include <cryptl/CTR_DRBG.hpp>
+#include <cryptl/CTR_HMAC.hpp>
+#include <cryptl/ChaCha20.hpp>
+#include <cryptl/ChaCha20_Poly1305.hpp>
+#include <cryptl/CipherContext.hpp>
+#include <cryptl/CipherModes.hpp>
+#include <cryptl/GF256.hpp>
+#include <cryptl/HMAC.hpp>
+#include <cryptl/MAC.hpp>
+#include <cryptl/MultiStream.hpp>
+#include <cryptl/OFB_Pipeline.hpp>
+#include <cryptl/ParallelModes.hpp>
+#include <cryptl/Poly1305.hpp>
+#include <cryptl/SHA_224.hpp>
+#include <cryptl/SHA_256.hpp>
+#include <cryptl/SHA_384.hpp>
+#include <cryptl/SHA_512.hpp>
+#include <cryptl/ThreadPool.hpp>
+#include <cryptl/XTS.hpp>
+
+using namespace cryptl;
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+// known answer tests with built-in vectors
+//
+// Modes, MACs and AEADs without NIST response files for AESAVS and SHAVS,
+// and streaming, parallel and alternative implementations compared with
+// the reference ones. Each test prints OK or FAIL.
+//
+
+void printUsage(const char* exeName) {
+    cout << "usage: " << exeName << " [-t name]" << endl
+         << "  -t  only tests with names starting with name" << endl;
+}
+
+vector<uint8_t> fromHex(const string& s)
+{
+    vector<uint8_t> v;
+    asciiHexToVector(s, v);
+    return v;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// XTS-AES (IEEE Std 1619-2007 Annex B)
+//
+
+struct XTSVector {
+    string key1, key2;  // data key, tweak key
+    uint64_t sector;
+    string ptx, ctx;
+};
+
+const vector<XTSVector> xts128Vectors = {
+    // vector 1
+    { "00000000000000000000000000000000",
+      "00000000000000000000000000000000",
+      0,
+      "0000000000000000000000000000000000000000000000000000000000000000",
+      "917cf69ebd68b2ec9b9fe9a3eadda692cd43d2f59598ed858c02c2652fbf922e" },
+    // vector 2
+    { "11111111111111111111111111111111",
+      "22222222222222222222222222222222",
+      0x3333333333,
+      "4444444444444444444444444444444444444444444444444444444444444444",
+      "c454185e6a16936e39334038acef838bfb186fff7480adc4289382ecd6d394f0" },
+    // vectors 15 to 18, ciphertext stealing
+    { "fffefdfcfbfaf9f8f7f6f5f4f3f2f1f0",
+      "bfbebdbcbbbab9b8b7b6b5b4b3b2b1b0",
+      0x123456789a,
+      "000102030405060708090a0b0c0d0e0f10",
+      "6c1625db4671522d3d7599601de7ca09ed" },
+    { "fffefdfcfbfaf9f8f7f6f5f4f3f2f1f0",
+      "bfbebdbcbbbab9b8b7b6b5b4b3b2b1b0",
+      0x123456789a,
+      "000102030405060708090a0b0c0d0e0f1011",
+      "d069444b7a7e0cab09e24447d24deb1fedbf" },
+    { "fffefdfcfbfaf9f8f7f6f5f4f3f2f1f0",
+      "bfbebdbcbbbab9b8b7b6b5b4b3b2b1b0",
+      0x123456789a,
+      "000102030405060708090a0b0c0d0e0f101112",
+      "e5df1351c0544ba1350b3363cd8ef4beedbf9d" },
+    { "fffefdfcfbfaf9f8f7f6f5f4f3f2f1f0",
+      "bfbebdbcbbbab9b8b7b6b5b4b3b2b1b0",
+      0x123456789a,
+      "000102030405060708090a0b0c0d0e0f10111213",
+      "9d84c813f719aa2c7be3f66171c7c5c2edbf9dac" } };
+
+// vector 10, the plain text is octets 0 to 255 twice
+const XTSVector xts256Vector = {
+    "2718281828459045235360287471352662497757247093699959574966967627",
+    "3141592653589793238462643383279502884197169399375105820974944592",
+    0xff,
+    "",
+          "1c3b3a102f770386e4836c99e370cf9bea00803f5e482357a4ae12d414a3e63b"
+          "5d31e276f8fe4a8d66b317f9ac683f44680a86ac35adfc3345befecb4bb188fd"
+          "5776926c49a3095eb108fd1098baec70aaa66999a72a82f27d848b21d4a741b0"
+          "c5cd4d5fff9dac89aeba122961d03a757123e9870f8acf1000020887891429ca"
+          "2a3e7a7d7df7b10355165c8b9a6d0a7de8b062c4500dc4cd120c0f7418dae3d0"
+          "b5781c34803fa75421c790dfe1de1834f280d7667b327f6c8cd7557e12ac3a0f"
+          "93ec05c52e0493ef31a12d3d9260f79a289d6a379bc70c50841473d1a8cc81ec"
+          "583e9645e07b8d9670655ba5bbcfecc6dc3966380ad8fecb17b6ba02469a020a"
+          "84e18e8f84252070c13e9f1f289be54fbc481457778f616015e1327a02b140f1"
+          "505eb309326d68378f8374595c849d84f4c333ec4423885143cb47bd71c5edae"
+          "9be69a2ffeceb1bec9de244fbe15992b11b77c040f12bd8f6a975a44a0f90c29"
+          "a9abc3d4d893927284c58754cce294529f8614dcd2aba991925fedc4ae74ffac"
+          "6e333b93eb4aff0479da9a410e4450e0dd7ae4c6e2910900575da401fc07059f"
+          "645e8b7e9bfdef33943054ff84011493c27b3429eaedb4ed5376441a77ed4385"
+          "1ad77f16f541dfd269d50d6a5f14fb0aab1cbb4c1550be97f7ab4066193c4caa"
+          "773dad38014bd2092fa755c824bb5e54c4f36ffda9fcea70b9c6e693e148c151" };
+
+// encrypt and decrypt one data unit
+template <typename ENC, typename DEC>
+bool xtsCheck(const XTSVector& v,
+              const vector<uint8_t>& ptx,
+              const vector<uint8_t>& ctx)
+{
+    typename ENC::KeyType key1, key2;
+    asciiHexToArray(v.key1, key1);
+    asciiHexToArray(v.key2, key2);
+
+    const typename ENC::KeyContext dataKey(key1), tweakKey(key2, false);
+
+    return XTS(ENC(), dataKey, tweakKey, v.sector, ptx) == ctx &&
+           XTS(DEC(), dataKey, tweakKey, v.sector, ctx) == ptx;
+}
+
+bool xts()
+{
+    bool ok = true;
+
+    for (const auto& v : xts128Vectors) {
+        ok = xtsCheck<AES128, UNAES128>(v, fromHex(v.ptx), fromHex(v.ctx))
+            && ok;
+    }
+
+    const XTSVector& v = xts256Vector;
+    vector<uint8_t> ptx(512);
+    for (size_t i = 0; i < ptx.size(); ++i) ptx[i] = i & 0xff;
+    const auto ctx = fromHex(v.ctx);
+
+    ok = xtsCheck<AES256, UNAES256>(v, ptx, ctx) && ok;
+
+    // consecutive sectors in parallel, the final one partial
+    AES256::KeyType key1, key2;
+    asciiHexToArray(v.key1, key1);
+    asciiHexToArray(v.key2, key2);
+    const AES256::KeyContext dataKey(key1), tweakKey(key2, false);
+
+    vector<uint8_t> in;
+    for (size_t i = 0; i < 4; ++i) in.insert(in.end(), ptx.begin(), ptx.end());
+    in.resize(in.size() - 100);
+
+    ThreadPool pool(3);
+    const auto out = XTS(AES256(), dataKey, tweakKey, v.sector, ptx.size(),
+                         in, pool);
+
+    ok = equal(ctx.begin(), ctx.end(), out.begin()) && ok;
+
+    for (size_t i = 0; i < in.size(); i += ptx.size()) {
+        const size_t len = min(ptx.size(), in.size() - i);
+        const vector<uint8_t>
+            a(in.begin() + i, in.begin() + i + len),
+            b(out.begin() + i, out.begin() + i + len);
+
+        ok = XTS(AES256(), dataKey, tweakKey, v.sector + i / ptx.size(), a)
+            == b && ok;
+    }
+
+    ok = XTS(UNAES256(), dataKey, tweakKey, v.sector, ptx.size(), out, pool)
+        == in && ok;
+
+    return ok;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// CMAC (RFC 4493, NIST SP 800-38B examples) and PMAC1 (Rogaway)
+//
+
+struct MACVector {
+    string key;
+    size_t length;      // message octets
+    string tag;
+};
+
+// the message is a prefix of the SP 800-38B example
+const string cmacMessage =
+    "6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51"
+    "30c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710";
+
+const vector<MACVector> cmac128Vectors = {
+    { "2b7e151628aed2a6abf7158809cf4f3c", 0,
+      "bb1d6929e95937287fa37d129b756746" },
+    { "2b7e151628aed2a6abf7158809cf4f3c", 16,
+      "070a16b46b4d4144f79bdd9dd04a287c" },
+    { "2b7e151628aed2a6abf7158809cf4f3c", 40,
+      "dfa66747de9ae63030ca32611497c827" },
+    { "2b7e151628aed2a6abf7158809cf4f3c", 64,
+      "51f0bebf7e3b9d92fc49741779363cfe" } };
+
+const vector<MACVector> cmac192Vectors = {
+    { "8e73b0f7da0e6452c810f32b809079e562f8ead2522c6b7b", 0,
+      "d17ddf46adaacde531cac483de7a9367" },
+    { "8e73b0f7da0e6452c810f32b809079e562f8ead2522c6b7b", 16,
+      "9e99a7bf31e710900662f65e617c5184" },
+    { "8e73b0f7da0e6452c810f32b809079e562f8ead2522c6b7b", 40,
+      "8a1de5be2eb31aad089a82e6ee908b0e" },
+    { "8e73b0f7da0e6452c810f32b809079e562f8ead2522c6b7b", 64,
+      "a1d5df0eed790f794d77589659f39a11" } };
+
+const vector<MACVector> cmac256Vectors = {
+    { "603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4", 0,
+      "028962f61b7bf89efc6b551f4667d983" },
+    { "603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4", 16,
+      "28a7023f452e8f82bd4bf28d8c37c35c" },
+    { "603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4", 40,
+      "aaf3d8f1de5640c232f5b169b9c911e6" },
+    { "603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4", 64,
+      "e1992190549f6ed5696a2c056c315410" } };
+
+// PMAC-AES-128 with octets 0, 1, 2,... as the message
+const vector<MACVector> pmac128Vectors = {
+    { "000102030405060708090a0b0c0d0e0f", 0,
+      "4399572cd6ea5341b8d35876a7098af7" },
+    { "000102030405060708090a0b0c0d0e0f", 3,
+      "256ba5193c1b991b4df0c51f388a9e27" },
+    { "000102030405060708090a0b0c0d0e0f", 16,
+      "ebbd822fa458daf6dfdad7c27da76338" },
+    { "000102030405060708090a0b0c0d0e0f", 20,
+      "0412ca150bbf79058d8c75a58c993f55" },
+    { "000102030405060708090a0b0c0d0e0f", 32,
+      "e97ac04e9e5e3399ce5355cd7407bc75" },
+    { "000102030405060708090a0b0c0d0e0f", 34,
+      "5cba7d5eb24f7c86ccc54604e53d5512" },
+    { "000102030405060708090a0b0c0d0e0f", 1000,
+      "01cc3529fcb42950d4327116b06dcba7" } };
+
+// streamed in chunks of 1, 7 and 17 octets, twice with the same context
+template <typename CTX, typename KEY>
+bool macStream(const KEY& key,
+               const vector<uint8_t>& msg,
+               const string& tag)
+{
+    bool ok = true;
+
+    for (const size_t chunk : { 1, 7, 17 }) {
+        CTX ctx(key);
+
+        for (size_t n = 0; n < 2; ++n) {
+            for (size_t i = 0; i < msg.size(); i += chunk)
+                ctx.update(msg.data() + i, min(chunk, msg.size() - i));
+
+            typename CTX::BlockType t;
+            ctx.finalize(t);
+            ok = asciiHex(t) == tag && ok;
+        }
+    }
+
+    return ok;
+}
+
+template <typename T>
+bool cmacCheck(const vector<MACVector>& vectors)
+{
+    const auto M = fromHex(cmacMessage);
+
+    bool ok = true;
+    for (const auto& v : vectors) {
+        typename T::KeyType k;
+        asciiHexToArray(v.key, k);
+        const CMAC_Key<T> key(k);
+
+        const vector<uint8_t> msg(M.begin(), M.begin() + v.length);
+
+        ok = asciiHex(CMAC(key, msg)) == v.tag && ok;
+        ok = macStream<CMAC_Context<T>>(key, msg, v.tag) && ok;
+    }
+
+    return ok;
+}
+
+bool cmac()
+{
+    return cmacCheck<AES128>(cmac128Vectors) &
+           cmacCheck<AES192>(cmac192Vectors) &
+           cmacCheck<AES256>(cmac256Vectors);
+}
+
+bool pmac()
+{
+    ThreadPool pool(3);
+
+    bool ok = true;
+    for (const auto& v : pmac128Vectors) {
+        AES128::KeyType k;
+        asciiHexToArray(v.key, k);
+        const PMAC_Key<AES128> key(k);
+
+        vector<uint8_t> msg(v.length);
+        for (size_t i = 0; i < msg.size(); ++i) msg[i] = i & 0xff;
+
+        ok = asciiHex(PMAC(key, msg)) == v.tag && ok;
+        ok = macStream<PMAC_Context<AES128>>(key, msg, v.tag) && ok;
+
+        // parallel chunks of two and of 64 blocks
+        ok = asciiHex(PMAC(key, msg, pool, 32)) == v.tag && ok;
+        ok = asciiHex(PMAC(key, msg, pool, 1024)) == v.tag && ok;
+    }
+
+    return ok;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// HMAC (RFC 4231) and CTR_HMAC (NIST SP 800-38A F.5 cipher text)
+//
+
+struct HMACVector {
+    string key, data;   // octets
+    vector<string> tags; // SHA-224, SHA-256, SHA-384, SHA-512
+};
+
+const string
+    rfc4231Key6 = string(131, '\xaa'),
+    rfc4231Data6 = "Test Using Larger Than Block-Size Key - Hash Key First",
+    rfc4231Data7 = "This is a test using a larger than block-size key and a "
+                   "larger than block-size data. The key needs to be hashed "
+                   "before being used by the HMAC algorithm.";
+
+// test case 5 is truncated to 128 bits
+const vector<HMACVector> hmacVectors = {
+    { string(20, '\x0b'), "Hi There",
+      { "896fb1128abbdf196832107cd49df33f47b4b1169912ba4f53684b22",
+        "b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7",
+        "afd03944d84895626b0825f4ab46907f15f9dadbe4101ec682aa034c7cebc59c"
+        "faea9ea9076ede7f4af152e8b2fa9cb6",
+        "87aa7cdea5ef619d4ff0b4241a1d6cb02379f4e2ce4ec2787ad0b30545e17cde"
+        "daa833b7d6b8a702038b274eaea3f4e4be9d914eeb61f1702e696c203a126854" } },
+    { "Jefe", "what do ya want for nothing?",
+      { "a30e01098bc6dbbf45690f3a7e9e6d0f8bbea2a39e6148008fd05e44",
+        "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843",
+        "af45d2e376484031617f78d2b58a6b1b9c7ef464f5a01b47e42ec3736322445e"
+        "8e2240ca5e69e2c78b3239ecfab21649",
+        "164b7a7bfcf819e2e395fbe73b56e0a387bd64222e831fd610270cd7ea250554"
+        "9758bf75c05a994a6d034f65f8f0e6fdcaeab1a34d4a6b4b636e070a38bce737" } },
+    { string(20, '\xaa'), string(50, '\xdd'),
+      { "7fb3cb3588c6c1f6ffa9694d7d6ad2649365b0c1f65d69d1ec8333ea",
+        "773ea91e36800e46854db8ebd09181a72959098b3ef8c122d9635514ced565fe",
+        "88062608d3e6ad8a0aa2ace014c8a86f0aa635d947ac9febe83ef4e55966144b"
+        "2a5ab39dc13814b94e3ab6e101a34f27",
+        "fa73b0089d56a284efb0f0756c890be9b1b5dbdd8ee81a3655f83e33b2279d39"
+        "bf3e848279a722c806b485a47e67c807b946a337bee8942674278859e13292fb" } },
+    { "\x01\x02\x03\x04\x05\x06\x07\x08\x09\x0a\x0b\x0c\x0d"
+      "\x0e\x0f\x10\x11\x12\x13\x14\x15\x16\x17\x18\x19",
+      string(50, '\xcd'),
+      { "6c11506874013cac6a2abc1bb382627cec6a90d86efc012de7afec5a",
+        "82558a389a443c0ea4cc819899f2083a85f0faa3e578f8077a2e3ff46729665b",
+        "3e8a69b7783c25851933ab6290af6ca77a9981480850009cc5577c6e1f573b4e"
+        "6801dd23c4a7d679ccf8a386c674cffb",
+        "b0ba465637458c6990e5a8c5f61d4af7e576d97ff94b872de76f8050361ee3db"
+        "a91ca5c11aa25eb4d679275cc5788063a5f19741120c4f2de2adebeb10a298dd" } },
+    { string(20, '\x0c'), "Test With Truncation",
+      { "0e2aea68a90c8d37c988bcdb9fca6fa8",
+        "a3b6167473100ee06e0c796c2955552b",
+        "3abf34c3503b2a23a46efc619baef897",
+        "415fad6271580a531d4179bc891d87a6" } },
+    { rfc4231Key6, rfc4231Data6,
+      { "95e9a0db962095adaebe9b2d6f0dbce2d499f112f2d2b7273fa6870e",
+        "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54",
+        "4ece084485813e9088d2c63a041bc5b44f9ef1012a2b588f3cd11f05033ac4c6"
+        "0c2ef6ab4030fe8296248df163f44952",
+        "80b24263c7c1a3ebb71493c1dd7be8b49b46d1f41b4aeec1121b013783f8f352"
+        "6b56d037e05f2598bd0fd2215d6a1e5295e64f73f63f0aec8b915a985d786598" } },
+    { rfc4231Key6, rfc4231Data7,
+      { "3a854166ac5d9f023f54d517d0b39dbd946770db9c2b95c9f6f565d1",
+        "9b09ffa71b942fcb27635fbcd5b0e944bfdc63644f0713938a7f51535c3a35e2",
+        "6617178e941f020d351e2f254e8fd32c602420feb0b8fb9adccebb82461e99c5"
+        "a678cc31e799176d3860e6110c46523e",
+        "e37b6a775dc87dbaa4dfa9f96e5e3ffddebd71f8867289865df5a32d20cdc944"
+        "b6022cac3c4982b10d5eeb55c3e4de15134676fb6de0446065c97440fa8c6a58" }
+    } };
+
+// tag streamed in chunks of 1, 7 and 17 octets, compared up to the length
+// of the expected tag
+template <typename H>
+bool hmacCheck(const string& key, const string& data, const string& tag)
+{
+    const vector<uint8_t>
+        k(key.begin(), key.end()),
+        msg(data.begin(), data.end());
+
+    HMAC<H> mac(k);
+
+    bool ok = true;
+    for (const size_t chunk : { 1, 7, 17 }) {
+        for (size_t i = 0; i < msg.size(); i += chunk)
+            mac.update(msg.data() + i, min(chunk, msg.size() - i));
+
+        typename HMAC<H>::TagType t;
+        mac.finalize(t);
+        ok = 0 == asciiHex(t).compare(0, tag.size(), tag) && ok;
+
+        // whole tags are also verified, and rejected with one bit changed
+        if (tag.size() == 2 * t.size()) {
+            mac.update(msg);
+            ok = mac.verify(t) && ok;
+
+            t[0] ^= 1;
+            mac.update(msg);
+            ok = ! mac.verify(t) && ok;
+        }
+    }
+
+    return ok;
+}
+
+bool hmac()
+{
+    bool ok = true;
+    for (const auto& v : hmacVectors) {
+        ok = hmacCheck<SHA224>(v.key, v.data, v.tags[0]) && ok;
+        ok = hmacCheck<SHA256>(v.key, v.data, v.tags[1]) && ok;
+        ok = hmacCheck<SHA384>(v.key, v.data, v.tags[2]) && ok;
+        ok = hmacCheck<SHA512>(v.key, v.data, v.tags[3]) && ok;
+    }
+
+    return ok;
+}
+
+struct CTRHMACVector {
+    string key;
+    size_t length;      // octets of the SP 800-38A plain text
+    string ctx, sha256, sha512;
+};
+
+// the plain text and cipher text are SP 800-38A F.5.1 and F.5.5, the tags
+// are HMAC-SHA-256 and HMAC-SHA-512 over the IV and cipher text
+const string
+    ctrIV = "f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff",
+    ctrMacKey =
+        "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f";
+
+const vector<CTRHMACVector> ctrHmac128Vectors = {
+    { "2b7e151628aed2a6abf7158809cf4f3c", 64,
+      "874d6191b620e3261bef6864990db6ce9806f66b7970fdff8617187bb9fffdff"
+      "5ae4df3edbd5d35e5b4f09020db03eab1e031dda2fbe03d1792170a0f3009cee",
+      "bdaedebf9a5f9f119c90ec732820f9aa080da07835ea00218b02b99221bf9472",
+      "8543df83464fd85530560835976b6a3bbb64797bc0a59dd326610aac3458529e"
+      "fbc0e74fdcc89acef30bbc7d0f504ecfa4d5e992549ae6aaf236cb7ba0756f8f" },
+    { "2b7e151628aed2a6abf7158809cf4f3c", 60,
+      "874d6191b620e3261bef6864990db6ce9806f66b7970fdff8617187bb9fffdff"
+      "5ae4df3edbd5d35e5b4f09020db03eab1e031dda2fbe03d1792170a0",
+      "c32554dc8ce1cc586216b0ad616d1eaa60822486c530db41c08b88d83348e06a",
+      "41f6939c7e5a695876f53844578639cf1aa4731b5cf6a99707ee41e172562705"
+      "62c9b6e5bb891e191f34060fee875cb870057fc52551083562f8d6137904b1f2" } };
+
+const CTRHMACVector ctrHmac256Vector = {
+    "603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4", 64,
+    "601ec313775789a5b7a7f504bbf3d228f443e3ca4d62b59aca84e990cacaf5c5"
+    "2b0930daa23de94ce87017ba2d84988ddfc9c58db67aada613c2dd08457941a6",
+    "8befb1019b34ed28eee0d42eef0230933c8ccd09e8d5a4838c233868a684aa98",
+    "" };
+
+// seal, open, open with a changed tag, and a context with small chunks
+// fed in pieces of 1, 7 and 17 octets
+template <typename ENC, typename DEC, typename H>
+bool ctrHmacCheck(const CTRHMACVector& v, const string& tag)
+{
+    typename ENC::KeyType k;
+    asciiHexToArray(v.key, k);
+    const typename ENC::KeyContext key(k, false);
+
+    typename ENC::BlockType IV;
+    asciiHexToArray(ctrIV, IV);
+
+    const HMAC<H> mac(fromHex(ctrMacKey));
+
+    const auto M = fromHex(cmacMessage);
+    const vector<uint8_t> msg(M.begin(), M.begin() + v.length);
+
+    bool ok = true;
+
+    typename HMAC<H>::TagType t;
+    const auto ctx = CTR_HMAC_Seal(ENC(), key, mac, IV, msg, t);
+    ok = asciiHex(ctx) == v.ctx && asciiHex(t) == tag && ok;
+
+    vector<uint8_t> out;
+    ok = CTR_HMAC_Open(DEC(), key, mac, IV, ctx, t, out) && out == msg && ok;
+
+    t[t.size() - 1] ^= 0x80;
+    ok = ! CTR_HMAC_Open(DEC(), key, mac, IV, ctx, t, out) && out.empty() &&
+         ok;
+
+    for (const size_t chunk : { 1, 7, 17 }) {
+        CTR_HMAC_Context<ENC, H> c(key, mac, IV, 20);
+
+        out.clear();
+        for (size_t i = 0; i < msg.size(); i += chunk) {
+            const vector<uint8_t> a(msg.begin() + i,
+                                    msg.begin() + min(i + chunk, msg.size()));
+            c.update(a, out);
+        }
+
+        c.finalize(t);
+        ok = out == ctx && asciiHex(t) == tag && ok;
+    }
+
+    return ok;
+}
+
+bool ctrHmac()
+{
+    bool ok = true;
+    for (const auto& v : ctrHmac128Vectors) {
+        ok = ctrHmacCheck<AES128, UNAES128, SHA256>(v, v.sha256) && ok;
+        ok = ctrHmacCheck<AES128, UNAES128, SHA512>(v, v.sha512) && ok;
+    }
+
+    const auto& v = ctrHmac256Vector;
+    ok = ctrHmacCheck<AES256, UNAES256, SHA256>(v, v.sha256) && ok;
+
+    return ok;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ChaCha20, Poly1305 and ChaCha20-Poly1305 (RFC 8439)
+//
+
+const string sunscreen =
+    "Ladies and Gentlemen of the class of '99: If I could offer you only "
+    "one tip for the future, sunscreen would be it.";
+
+// section 2.4.2 with key octets 0, 1,..., 31 and block counter 1
+bool chacha20()
+{
+    ChaCha20_KeyType key;
+    for (size_t i = 0; i < key.size(); ++i) key[i] = i;
+
+    ChaCha20_NonceType nonce;
+    asciiHexToArray("000000000000004a00000000", nonce);
+
+    const vector<uint8_t> msg(sunscreen.begin(), sunscreen.end());
+    const string ctx =
+        "6e2e359a2568f98041ba0728dd0d6981e97e7aec1d4360c20a27afccfd9fae0b"
+        "f91b65c5524733ab8f593dabcd62b3571639d624e65152ab8f530c359f0861d8"
+        "07ca0dbf500d6a6156a38e088a22b65e52bc514d16ccf806818ce91ab7793736"
+        "5af90bbf74a35be6b40b8eedf2785e42874d";
+
+    bool ok = true;
+    for (const size_t chunk : { 1, 7, 64, 114 }) {
+        ChaCha20_Context c(key, nonce, 1);
+
+        vector<uint8_t> out(msg.size());
+        for (size_t i = 0; i < msg.size(); i += chunk) {
+            const size_t n = min(chunk, msg.size() - i);
+            ok = n == c.update(msg.data() + i, n, out.data() + i) && ok;
+        }
+
+        ok = asciiHex(out) == ctx && ok;
+    }
+
+    return ok;
+}
+
+// section 2.5.2
+bool poly1305()
+{
+    Poly1305::KeyType key;
+    asciiHexToArray(
+        "85d6be7857556d337f4452fe42d506a80103808afb0db2fd4abff6af4149f51b",
+        key);
+
+    const string msg = "Cryptographic Forum Research Group";
+
+    bool ok = true;
+    for (const size_t chunk : { 1, 7, 17 }) {
+        Poly1305 mac(key);
+
+        for (size_t i = 0; i < msg.size(); i += chunk) {
+            mac.update(reinterpret_cast<const uint8_t*>(msg.data()) + i,
+                       min(chunk, msg.size() - i));
+        }
+
+        Poly1305::TagType tag;
+        mac.finalize(tag);
+        ok = asciiHex(tag) == "a8061dc1305136c6c22b8baf0c0127a9" && ok;
+    }
+
+    return ok;
+}
+
+struct AEADVector {
+    string key, nonce, aad, ptx, ctx, tag;
+};
+
+// section 2.8.2, then vectors computed with OpenSSL: the 1000 octet message
+// (0, 1, 2,...) spans the eight block key stream and is only checked by its
+// tag, which covers the cipher text
+const vector<AEADVector> aeadVectors = {
+    { "808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f",
+      "070000004041424344454647",
+      "50515253c0c1c2c3c4c5c6c7",
+      sunscreen,
+      "d31a8d34648e60db7b86afbc53ef7ec2a4aded51296e08fea9e2b5a736ee62d6"
+      "3dbea45e8ca9671282fafb69da92728b1a71de0a9e060b2905d6a5b67ecd3b36"
+      "92ddbd7f2d778b8c9803aee328091b58fab324e4fad675945585808b4831d7bc"
+      "3ff4def08e4b7a9de576d26586cec64b6116",
+      "1ae10b594f09e26a7e902ecbd0600691" },
+    { "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f",
+      "000000000000004a00000000",
+      "",
+      string(1000, '\0'),
+      "",
+      "3a1dbf6abb8a2adb41240ae7527a3b39" },
+    { "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f",
+      "000000000000004a00000000",
+      "50515253c0c1c2c3c4c5c6c7",
+      "",
+      "",
+      "98c05666d554643845437de6285d6a38" } };
+
+bool aead()
+{
+    bool ok = true;
+    for (const auto& v : aeadVectors) {
+        CHACHA20_POLY1305::KeyType key;
+        CHACHA20_POLY1305::NonceType nonce;
+        asciiHexToArray(v.key, key);
+        asciiHexToArray(v.nonce, nonce);
+
+        const auto aad = fromHex(v.aad);
+
+        vector<uint8_t> msg(v.ptx.begin(), v.ptx.end());
+        if (v.ctx.empty()) {
+            for (size_t i = 0; i < msg.size(); ++i) msg[i] = i & 0xff;
+        }
+
+        CHACHA20_POLY1305::TagType tag;
+        const auto ctx = ChaChaPoly_Seal(key, nonce, aad, msg, tag);
+        ok = asciiHex(tag) == v.tag && ok;
+        ok = (v.ctx.empty() || asciiHex(ctx) == v.ctx) && ok;
+
+        vector<uint8_t> out;
+        ok = ChaChaPoly_Open(key, nonce, aad, ctx, tag, out) && out == msg &&
+             ok;
+
+        // changed tag, output is wiped
+        tag[0] ^= 1;
+        ok = ! ChaChaPoly_Open(key, nonce, aad, ctx, tag, out) &&
+             out.empty() && ok;
+        tag[0] ^= 1;
+
+        // streamed in chunks of 1, 7 and 65 octets
+        for (const size_t chunk : { 1, 7, 65 }) {
+            ChaChaPoly_Context<CHACHA20_POLY1305> c(key, nonce, aad);
+
+            out.clear();
+            for (size_t i = 0; i < msg.size(); i += chunk) {
+                const vector<uint8_t> a(
+                    msg.begin() + i,
+                    msg.begin() + min(i + chunk, msg.size()));
+                ok = c.update(a, out) && ok;
+            }
+
+            CHACHA20_POLY1305::TagType t;
+            c.finalize(t);
+            ok = out == ctx && t == tag && ok;
+        }
+    }
+
+    return ok;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// BLAKE3 (official test vectors)
+//
+
+struct BLAKE3Vector {
+    size_t length;
+    string hash, keyed;
+};
+
+// input octets i % 251, the 32 octet outputs
+const vector<BLAKE3Vector> blake3Vectors = {
+    { 0,
+      "af1349b9f5f9a1a6a0404dea36dcc9499bcb25c9adc112b7cc9a93cae41f3262",
+      "92b2b75604ed3c761f9d6f62392c8a9227ad0ea3f09573e783f1498a4ed60d26" },
+    { 1,
+      "2d3adedff11b61f14c886e35afa036736dcd87a74d27b5c1510225d0f592e213",
+      "6d7878dfff2f485635d39013278ae14f1454b8c0a3a2d34bc1ab38228a80c95b" },
+    { 1023,
+      "10108970eeda3eb932baac1428c7a2163b0e924c9a9e25b35bba72b28f70bd11",
+      "c951ecdf03288d0fcc96ee3413563d8a6d3589547f2c2fb36d9786470f1b9d6e" },
+    { 1024,
+      "42214739f095a406f3fc83deb889744ac00df831c10daa55189b5d121c855af7",
+      "75c46f6f3d9eb4f55ecaaee480db732e6c2105546f1e675003687c31719c7ba4" },
+    { 1025,
+      "d00278ae47eb27b34faecf67b4fe263f82d5412916c1ffd97c8cb7fb814b8444",
+      "357dc55de0c7e382c900fd6e320acc04146be01db6a8ce7210b7189bd664ea69" },
+    { 2048,
+      "e776b6028c7cd22a4d0ba182a8bf62205d2ef576467e838ed6f2529b85fba24a",
+      "879cf1fa2ea0e79126cb1063617a05b6ad9d0b696d0d757cf053439f60a99dd1" },
+    { 2049,
+      "5f4d72f40d7a5f82b15ca2b2e44b1de3c2ef86c426c95c1af0b6879522563030",
+      "9f29700902f7c86e514ddc4df1e3049f258b2472b6dd5267f61bf13983b78dd5" },
+    { 3072,
+      "b98cb0ff3623be03326b373de6b9095218513e64f1ee2edd2525c7ad1e5cffd2",
+      "044a0e7b172a312dc02a4c9a818c036ffa2776368d7f528268d2e6b5df191770" },
+    { 3073,
+      "7124b49501012f81cc7f11ca069ec9226cecb8a2c850cfe644e327d22d3e1cd3",
+      "68dede9bef00ba89e43f31a6825f4cf433389fedae75c04ee9f0cf16a427c95a" },
+    { 4096,
+      "015094013f57a5277b59d8475c0501042c0b642e531b0a1c8f58d2163229e969",
+      "befc660aea2f1718884cd8deb9902811d332f4fc4a38cf7c7300d597a081bfc0" },
+    { 4097,
+      "9b4052b38f1c5fc8b1f9ff7ac7b27cd242487b3d890d15c96a1c25b8aa0fb995",
+      "00df940cd36bb9fa7cbbc3556744e0dbc8191401afe70520ba292ee3ca80abbc" },
+    { 5120,
+      "9cadc15fed8b5d854562b26a9536d9707cadeda9b143978f319ab34230535833",
+      "2c493e48e9b9bf31e0553a22b23503c0a3388f035cece68eb438d22fa1943e20" },
+    { 5121,
+      "628bd2cb2004694adaab7bbd778a25df25c47b9d4155a55f8fbd79f2fe154cff",
+      "6ccf1c34753e7a044db80798ecd0782a8f76f33563accaddbfbb2e0ea4b2d024" },
+    { 6144,
+      "3e2e5b74e048f3add6d21faab3f83aa44d3b2278afb83b80b3c35164ebeca205",
+      "3d6b6d21281d0ade5b2b016ae4034c5dec10ca7e475f90f76eac7138e9bc8f1d" },
+    { 6145,
+      "f1323a8631446cc50536a9f705ee5cb619424d46887f3c376c695b70e0f0507f",
+      "9ac301e9e39e45e3250a7e3b3df701aa0fb6889fbd80eeecf28dbc6300fbc539" },
+    { 7168,
+      "61da957ec2499a95d6b8023e2b0e604ec7f6b50e80a9678b89d2628e99ada77a",
+      "b42835e40e9d4a7f42ad8cc04f85a963a76e18198377ed84adddeaecacc6f3fc" },
+    { 7169,
+      "a003fc7a51754a9b3c7fae0367ab3d782dccf28855a03d435f8cfe74605e7817",
+      "ed9b1a922c046fdb3d423ae34e143b05ca1bf28b710432857bf738bcedbfa511" },
+    { 8192,
+      "aae792484c8efe4f19e2ca7d371d8c467ffb10748d8a5a1ae579948f718a2a63",
+      "dc9637c8845a770b4cbf76b8daec0eebf7dc2eac11498517f08d44c8fc00d58a" },
+    { 8193,
+      "bab6c09cb8ce8cf459261398d2e7aef35700bf488116ceb94a36d0f5f1b7bc3b",
+      "954a2a75420c8d6547e3ba5b98d963e6fa6491addc8c023189cc519821b4a1f5" },
+    { 16384,
+      "f875d6646de28985646f34ee13be9a576fd515f76b5b0a26bb324735041ddde4",
+      "9e9fc4eb7cf081ea7c47d1807790ed211bfec56aa25bb7037784c13c4b707b0d" },
+    { 31744,
+      "62b6960e1a44bcc1eb1a611a8d6235b6b4b78f32e7abc4fb4c6cdcce94895c47",
+      "efa53b389ab67c593dba624d898d0f7353ab99e4ac9d42302ee64cbf9939a419" },
+    { 102400,
+      "bc3e3d41a1146b069abffad3c0d44860cf664390afce4d9661f7902e7943e085",
+      "1c35d1a5811083fd7119f5d5d1ba027b4d01c0c6c49fb6ff2cf75393ea5db4a7" } };
+
+const string blake3Key = "whats the Elvish word for friend";
+
+vector<uint8_t> blake3Message(const size_t length)
+{
+    vector<uint8_t> msg(length);
+    for (size_t i = 0; i < msg.size(); ++i) msg[i] = i % 251;
+    return msg;
+}
+
+string blake3Stream(BLAKE3 h,
+                    const vector<uint8_t>& msg,
+                    const size_t chunk,
+                    const size_t outLength)
+{
+    for (size_t i = 0; i < msg.size(); i += chunk)
+        h.update(msg.data() + i, min(chunk, msg.size() - i));
+
+    vector<uint8_t> out(outLength);
+    h.finalize(out.data(), out.size());
+    return asciiHex(out);
+}
+
+bool blake3()
+{
+    BLAKE3::KeyType key;
+    copy(blake3Key.begin(), blake3Key.end(), key.begin());
+
+    ThreadPool pool(3);
+
+    bool ok = true;
+    for (const auto& v : blake3Vectors) {
+        const auto msg = blake3Message(v.length);
+
+        ok = asciiHex(digest(BLAKE3(), msg)) == v.hash && ok;
+        ok = asciiHex(digest(BLAKE3(key), msg)) == v.keyed && ok;
+        ok = asciiHex(digest(BLAKE3(&pool), msg)) == v.hash && ok;
+        ok = asciiHex(digest(BLAKE3(key, &pool), msg)) == v.keyed && ok;
+
+        // chunk and subtree boundaries split across updates
+        for (const size_t chunk : { 1, 1023, 5 * 1024 }) {
+            ok = blake3Stream(BLAKE3(), msg, chunk, 32) == v.hash && ok;
+            ok = blake3Stream(BLAKE3(key, &pool), msg, chunk, 32) == v.keyed &&
+                 ok;
+        }
+    }
+
+    // extended output over three root blocks
+    const string xofEmpty =
+        "af1349b9f5f9a1a6a0404dea36dcc9499bcb25c9adc112b7cc9a93cae41f3262"
+        "e00f03e7b69af26b7faaf09fcd333050338ddfe085b8cc869ca98b206c08243a"
+        "26f5487789e8f660afe6c99ef9e0c52b92e7393024a80459cf91f476f9ffdbda"
+        "7001c22e159b402631f277ca96f2defdf1078282314e763699a31c5363165421"
+        "cce14d";
+    const string xofKeyed =
+        "1c35d1a5811083fd7119f5d5d1ba027b4d01c0c6c49fb6ff2cf75393ea5db4a7"
+        "f9dbdd3e1d81dcbca3ba241bb18760f207710b751846faaeb9dff8262710999a"
+        "59b2aa1aca298a032d94eacfadf1aa192418eb54808db23b56e34213266aa084"
+        "99a16b354f018fc4967d05f8b9d2ad87a7278337be9693fc638a3bfdbe314574"
+        "ee6fc4";
+
+    ok = blake3Stream(BLAKE3(), blake3Message(0), 1, 131) == xofEmpty && ok;
+    ok = blake3Stream(BLAKE3(key), blake3Message(102400), 4096, 131) ==
+             xofKeyed && ok;
+
+    return ok;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// cipher mode contexts (chunked update() and PKCS#7 padding)
+//
+
+// SP 800-38A key and IV, the messages are octets 0, 1, 2,...
+const string
+    modeKey = "2b7e151628aed2a6abf7158809cf4f3c",
+    modeIV = "000102030405060708090a0b0c0d0e0f";
+
+vector<uint8_t> countMessage(const size_t length)
+{
+    vector<uint8_t> msg(length);
+    for (size_t i = 0; i < msg.size(); ++i) msg[i] = i & 0xff;
+    return msg;
+}
+
+// update() in chunks then finalize(), false if finalize() fails
+template <typename CTX>
+bool contextStream(CTX ctx,
+                   const vector<uint8_t>& in,
+                   const size_t chunk,
+                   vector<uint8_t>& out)
+{
+    out.clear();
+    for (size_t i = 0; i < in.size(); i += chunk) {
+        const vector<uint8_t> a(in.begin() + i,
+                                in.begin() + min(i + chunk, in.size()));
+        ctx.update(a, out);
+    }
+
+    return ctx.finalize(out);
+}
+
+// same as the one-shot modes, OFB and CFB may truncate the last block
+bool contextModes(const AES128::KeyContext& key, const AES128::BlockType& IV)
+{
+    const auto msg = countMessage(160);
+    const vector<uint8_t> part(msg.begin(), msg.begin() + 150);
+
+    const auto
+        ecb = ECB(AES128(), key, msg),
+        cbc = CBC(AES128(), key, IV, msg),
+        ofb = OFB(AES128(), key, IV, msg),
+        cfb = CFB(AES128(), key, IV, msg);
+
+    const vector<uint8_t>
+        ofbPart(ofb.begin(), ofb.begin() + part.size()),
+        cfbPart(cfb.begin(), cfb.begin() + part.size());
+
+    bool ok = true;
+    vector<uint8_t> out;
+
+    for (const size_t chunk : { 1, 7, 16, 17, 160 }) {
+        ok = contextStream(ECB_Context<AES128>(key), msg, chunk, out) &&
+             out == ecb && ok;
+        ok = contextStream(ECB_Context<UNAES128>(key), ecb, chunk, out) &&
+             out == msg && ok;
+
+        ok = contextStream(CBC_Context<AES128>(key, IV), msg, chunk, out) &&
+             out == cbc && ok;
+        ok = contextStream(CBC_Context<UNAES128>(key, IV), cbc, chunk, out) &&
+             out == msg && ok;
+
+        ok = contextStream(OFB_Context<AES128>(key, IV), part, chunk, out) &&
+             out == ofbPart && ok;
+        ok = contextStream(OFB_Context<UNAES128>(key, IV), ofbPart, chunk,
+                           out) && out == part && ok;
+
+        ok = contextStream(CFB_Context<AES128>(key, IV), part, chunk, out) &&
+             out == cfbPart && ok;
+        ok = contextStream(CFB_Context<UNAES128>(key, IV), cfbPart, chunk,
+                           out) && out == part && ok;
+
+        // block modes without padding need whole blocks
+        ok = ! contextStream(ECB_Context<AES128>(key), part, chunk, out) &&
+             ok;
+        ok = ! contextStream(CBC_Context<AES128>(key, IV), part, chunk, out) &&
+             ok;
+    }
+
+    return ok;
+}
+
+// padded to a whole number of blocks, a full block when it already is
+bool contextPadding(const AES128::KeyContext& key,
+                    const AES128::BlockType& IV)
+{
+    bool ok = true;
+    vector<uint8_t> out;
+
+    for (const size_t length : { 0, 1, 15, 16, 64, 65, 79 }) {
+        const auto msg = countMessage(length);
+
+        auto padded = msg;
+        const size_t pad = 16 - length % 16;
+        padded.insert(padded.end(), pad, pad);
+
+        const auto
+            ecb = ECB(AES128(), key, padded),
+            cbc = CBC(AES128(), key, IV, padded);
+
+        for (const size_t chunk : { 1, 7, 16, 17 }) {
+            ok = contextStream(ECB_Context<AES128>(key, true), msg, chunk,
+                               out) && out == ecb && ok;
+            ok = contextStream(ECB_Context<UNAES128>(key, true), ecb, chunk,
+                               out) && out == msg && ok;
+
+            ok = contextStream(CBC_Context<AES128>(key, IV, true), msg, chunk,
+                               out) && out == cbc && ok;
+            ok = contextStream(CBC_Context<UNAES128>(key, IV, true), cbc,
+                               chunk, out) && out == msg && ok;
+        }
+    }
+
+    // pad octet of zero, larger than a block, and not repeated
+    const vector<string> badBlocks = {
+        "000102030405060708090a0b0c0d0e00",
+        "11111111111111111111111111111111",
+        "000102030405060708090a0b0c0d0302" };
+
+    for (const auto& b : badBlocks) {
+        auto padded = countMessage(16);
+        const auto last = fromHex(b);
+        padded.insert(padded.end(), last.begin(), last.end());
+
+        const auto ctx = CBC(AES128(), key, IV, padded);
+
+        CBC_Context<UNAES128> c(key, IV, true);
+        vector<uint8_t> a(ctx.size(), 0xaa);
+        ok = 16 == c.update(ctx.data(), ctx.size(), a.data()) && ok;
+
+        // the held back block is zeroed, not released
+        size_t N;
+        ok = ! c.finalize(a.data() + 16, N) && 0 == N && ok;
+        ok = all_of(a.begin() + 16, a.end(),
+                    [] (const uint8_t x) { return 0 == x; }) && ok;
+
+        ok = ! contextStream(CBC_Context<UNAES128>(key, IV, true), ctx, 7,
+                             out) && 16 == out.size() && ok;
+    }
+
+    // padded cipher text must be whole blocks
+    const auto ctx = ECB(AES128(), key, countMessage(32));
+    const vector<uint8_t> partial(ctx.begin(), ctx.begin() + 31);
+    ok = ! contextStream(ECB_Context<UNAES128>(key, true), partial, 7, out) &&
+         ok;
+
+    return ok;
+}
+
+bool cipherContext()
+{
+    AES128::KeyType k;
+    AES128::BlockType IV;
+    asciiHexToArray(modeKey, k);
+    asciiHexToArray(modeIV, IV);
+    const AES128::KeyContext key(k, true);
+
+    return contextModes(key, IV) & contextPadding(key, IV);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// parallel modes and the thread pool
+//
+
+// the counter carries through four octets after six blocks
+const string carryIV = "f0f1f2f3f4f5f6f7f8f9fafbfffffffa";
+
+// chunkOctets of 1 and 17 give chunks of one block, 49 of three blocks
+// and 1000 of 62 blocks
+bool parallelModes()
+{
+    AES128::KeyType k;
+    AES128::BlockType IV, ctrIV;
+    asciiHexToArray(modeKey, k);
+    asciiHexToArray(modeIV, IV);
+    asciiHexToArray(carryIV, ctrIV);
+    const AES128::KeyContext key(k, true);
+
+    const auto
+        msg = countMessage(1008),
+        odd = countMessage(1001);
+
+    const auto
+        ecb = ECB(AES128(), key, msg),
+        cbc = CBC(AES128(), key, IV, msg),
+        cfb = CFB(AES128(), key, IV, msg),
+        ctr = CTR(AES128(), key, ctrIV, odd);
+
+    ThreadPool pool(3);
+
+    bool ok = true;
+    for (const size_t chunk : { 1, 17, 49, 1000 }) {
+        ok = ECB(AES128(), key, msg, pool, chunk) == ecb && ok;
+        ok = ECB(UNAES128(), key, ecb, pool, chunk) == msg && ok;
+
+        ok = CBC(UNAES128(), key, IV, cbc, pool, chunk) == msg && ok;
+        ok = CFB(UNAES128(), key, IV, cfb, pool, chunk) == msg && ok;
+
+        ok = CTR(AES128(), key, ctrIV, odd, pool, chunk) == ctr && ok;
+        ok = CTR(AES128(), key, ctrIV, ctr, pool, chunk) == odd && ok;
+    }
+
+    // the key schedule expanded for each call
+    ok = ECB(AES128(), k, msg, pool, 49) == ecb && ok;
+    ok = CBC(UNAES128(), k, IV, cbc, pool, 49) == msg && ok;
+    ok = CFB(UNAES128(), k, IV, cfb, pool, 49) == msg && ok;
+    ok = CTR(AES128(), k, ctrIV, odd, pool, 49) == ctr && ok;
+
+    return ok;
+}
+
+// every index once, the first exception rethrown after the batch, and
+// nested calls inline on the calling pool thread
+bool threadPool()
+{
+    ThreadPool pool(3);
+
+    bool ok = true;
+
+    vector<size_t> count(100);
+    pool.run(count.size(), [&count] (const size_t i) { ++count[i]; });
+    ok = all_of(count.begin(), count.end(),
+                [] (const size_t n) { return 1 == n; }) && ok;
+
+    atomic<size_t> done(0);
+    try {
+        pool.run(count.size(),
+                 [&done] (const size_t i) {
+                     if (5 == i) throw runtime_error("task");
+                     ++done;
+                 });
+        ok = false;
+    }
+    catch (const runtime_error&) {
+        ok = count.size() - 1 == done && ok;
+    }
+
+    vector<thread::id> outer(8), inner(8 * 4);
+    pool.run(outer.size(),
+             [&] (const size_t i) {
+                 outer[i] = this_thread::get_id();
+                 pool.run(4,
+                          [&, i] (const size_t j) {
+                              inner[4 * i + j] = this_thread::get_id();
+                          });
+             });
+
+    for (size_t i = 0; i < inner.size(); ++i)
+        ok = inner[i] == outer[i / 4] && ok;
+
+    // a parallel mode inside a task
+    AES128::KeyType k;
+    asciiHexToArray(modeKey, k);
+    const AES128::KeyContext key(k);
+    const auto msg = countMessage(1024);
+    const auto ecb = ECB(AES128(), key, msg);
+
+    vector<vector<uint8_t>> out(4);
+    pool.run(out.size(),
+             [&] (const size_t i) {
+                 out[i] = ECB(AES128(), key, msg, pool, 64);
+             });
+
+    for (const auto& a : out) ok = a == ecb && ok;
+
+    return ok;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// GF(2^8) multiplication (log/antilog tables against bit-serial)
+//
+
+bool gf256Multiply()
+{
+    typedef BitwiseINT<uint8_t> B;
+
+    bool ok = true;
+    for (unsigned int x = 0; x < 256; ++x) {
+        for (unsigned int y = 0; y < 256; ++y) {
+            uint8_t a = x, b = y, p = 0;
+            for (size_t i = 0; i < 8; ++i) {
+                if (b & 1) p ^= a;
+                b >>= 1;
+                a = B::xtime(a, 0x1b);
+            }
+
+            ok = GF256<>::multiply(x, y) == p &&
+                 B::multiply(x, y, 0x1b) == p &&
+                 gf256::mul(x, y) == p && ok;
+        }
+    }
+
+    return ok;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// AES implementations (FIPS 197 Appendix C)
+//
+
+struct BlockVector {
+    string key, ptx, ctx;
+};
+
+// C.1, C.2 and C.3
+const vector<BlockVector> fips197Vectors = {
+    { "000102030405060708090a0b0c0d0e0f",
+      "00112233445566778899aabbccddeeff",
+      "69c4e0d86a7b0430d8cdb78070b4c55a" },
+    { "000102030405060708090a0b0c0d0e0f1011121314151617",
+      "00112233445566778899aabbccddeeff",
+      "dda97ca4864cdfe06eaf70a0ec0d7191" },
+    { "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f",
+      "00112233445566778899aabbccddeeff",
+      "8ea2b7ca516745bfeafc49904b496089" } };
+
+// cipher and inverse cipher with the key expansion, then the key context
+// (equivalent inverse cipher)
+template <typename T>
+bool fips197Check(const BlockVector& v)
+{
+    typename T::KeyType k;
+    typename T::BlockType ptx, ctx, out;
+    asciiHexToArray(v.key, k);
+    asciiHexToArray(v.ptx, ptx);
+    asciiHexToArray(v.ctx, ctx);
+
+    bool ok = true;
+
+    typename T::ScheduleType w;
+    typename T::KeyExpansion()(k, w);
+
+    typename T::Encrypt()(ptx, out, w);
+    ok = out == ctx && ok;
+
+    typename T::Decrypt()(ctx, out, w);
+    ok = out == ptx && ok;
+
+    const typename T::KeyContext key(k);
+
+    key.encrypt(ptx, out);
+    ok = out == ctx && ok;
+
+    key.decrypt(ctx, out);
+    ok = out == ptx && ok;
+
+    return ok;
+}
+
+typedef AES_SBoxCircuit<uint8_t, uint8_t, BitwiseINT<uint8_t>> SBoxCircuit;
+typedef AES_InvSBoxCircuit<uint8_t, uint8_t, BitwiseINT<uint8_t>>
+    InvSBoxCircuit;
+
+// all 256 inputs against the tables, then the circuits in each key size
+bool sboxCircuit()
+{
+    bool ok = true;
+    for (unsigned int x = 0; x < 256; ++x) {
+        ok = SBoxCircuit()(x) == GF256<>::sbox[x] &&
+             InvSBoxCircuit()(x) == GF256<>::invsbox[x] && ok;
+    }
+
+    typedef BitwiseINT<uint8_t> B;
+
+    return fips197Check<AES_128<uint8_t, uint8_t, uint8_t, B, SBoxCircuit,
+                                InvSBoxCircuit>>(fips197Vectors[0]) &
+           fips197Check<AES_192<uint8_t, uint8_t, uint8_t, B, SBoxCircuit,
+                                InvSBoxCircuit>>(fips197Vectors[1]) &
+           fips197Check<AES_256<uint8_t, uint8_t, uint8_t, B, SBoxCircuit,
+                                InvSBoxCircuit>>(fips197Vectors[2]) &
+           fips197Check<AES128>(fips197Vectors[0]) &
+           fips197Check<AES192>(fips197Vectors[1]) &
+           fips197Check<AES256>(fips197Vectors[2]) &
+           ok;
+}
+
+// the 32-bit column variants, also in a mode and with the S-box circuits
+bool columns()
+{
+    AES128::KeyType k;
+    AES128::BlockType IV;
+    asciiHexToArray(modeKey, k);
+    asciiHexToArray(modeIV, IV);
+
+    const auto msg = countMessage(160);
+    const auto cbc = CBC(AES128(), k, IV, msg);
+
+    return fips197Check<AES128_Columns>(fips197Vectors[0]) &
+           fips197Check<AES192_Columns>(fips197Vectors[1]) &
+           fips197Check<AES256_Columns>(fips197Vectors[2]) &
+           fips197Check<AES_Columns<4, true, SBoxCircuit, InvSBoxCircuit>>(
+               fips197Vectors[0]) &
+           (CBC(AES128_Columns(), k, IV, msg) == cbc) &
+           (CBC(UNAES128_Columns(), k, IV, cbc) == msg);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// many streams (MultiStream.hpp)
+//
+
+// unequal and empty jobs, more than the lanes
+const vector<size_t> streamLengths = { 160, 0, 16, 48, 320, 32, 0, 96, 16 };
+
+template <typename T>
+vector<StreamJob<T, uint8_t>> streamJobs(
+    const vector<typename T::KeyContext>& ctx,
+    const vector<typename T::BlockType>& IV,
+    const vector<vector<uint8_t>>& in,
+    vector<vector<uint8_t>>& out)
+{
+    vector<StreamJob<T, uint8_t>> jobs;
+    out.resize(in.size());
+
+    for (size_t i = 0; i < in.size(); ++i) {
+        out[i].assign(in[i].size(), 0);
+        jobs.push_back(
+            { &ctx[i], IV[i], in[i].data(), out[i].data(), in[i].size() });
+    }
+
+    return jobs;
+}
+
+// the same as CBC() and OFB() on each stream, with a different key and IV
+// for each stream
+template <typename ENC, typename DEC>
+bool multiStreamCheck()
+{
+    const size_t N = streamLengths.size();
+
+    vector<typename ENC::KeyType> keys(N);
+    vector<typename ENC::BlockType> IV(N);
+    vector<vector<uint8_t>> msg(N);
+
+    for (size_t i = 0; i < N; ++i) {
+        for (size_t j = 0; j < keys[i].size(); ++j) keys[i][j] = 31 * i + j;
+        for (size_t j = 0; j < IV[i].size(); ++j) IV[i][j] = i + 7 * j;
+
+        msg[i] = countMessage(streamLengths[i]);
+        for (auto& a : msg[i]) a ^= i;
+    }
+
+    bool ok = true;
+
+    // batched key expansion
+    const auto ctx = MultiRekey(ENC(), keys);
+    const auto ctxEnc = MultiRekey<3>(ENC(), keys, false);
+
+    for (size_t i = 0; i < N; ++i) {
+        const typename ENC::KeyContext key(keys[i]);
+
+        ok = ctx[i].hasDecrypt() &&
+             ctx[i].encSchedule() == key.encSchedule() &&
+             ctx[i].decSchedule() == key.decSchedule() &&
+             ! ctxEnc[i].hasDecrypt() &&
+             ctxEnc[i].encSchedule() == key.encSchedule() && ok;
+    }
+
+    vector<vector<uint8_t>> cbc, ofb, out;
+
+    auto jobs = streamJobs<ENC>(ctx, IV, msg, cbc);
+    MultiCBC(ENC(), jobs);
+
+    for (size_t i = 0; i < N; ++i) {
+        ok = cbc[i] == CBC(ENC(), ctx[i], IV[i], msg[i]) && ok;
+
+        // chaining block is the last cipher text block
+        if (! cbc[i].empty()) {
+            ok = equal(jobs[i].chain.begin(), jobs[i].chain.end(),
+                       cbc[i].end() - jobs[i].chain.size()) && ok;
+        }
+    }
+
+    auto undo = streamJobs<DEC>(ctx, IV, cbc, out);
+    MultiCBC(DEC(), undo);
+    ok = out == msg && ok;
+
+    jobs = streamJobs<ENC>(ctx, IV, msg, ofb);
+    MultiOFB<3>(ENC(), jobs);
+
+    for (size_t i = 0; i < N; ++i)
+        ok = ofb[i] == OFB(ENC(), ctx[i], IV[i], msg[i]) && ok;
+
+    undo = streamJobs<DEC>(ctx, IV, ofb, out);
+    MultiOFB(DEC(), undo);
+    ok = out == msg && ok;
+
+    // a stream continued by a second call
+    vector<uint8_t> a(msg[4].size());
+    vector<StreamJob<ENC, uint8_t>> half = {
+        { &ctx[4], IV[4], msg[4].data(), a.data(), a.size() / 2 } };
+
+    MultiCBC<1>(ENC(), half);
+    half[0].in += half[0].length;
+    half[0].out += half[0].length;
+    MultiCBC<1>(ENC(), half);
+    ok = a == cbc[4] && ok;
+
+    return ok;
+}
+
+bool multiStream()
+{
+    return multiStreamCheck<AES128, UNAES128>() &
+           multiStreamCheck<AES256, UNAES256>() &
+           multiStreamCheck<AES128_Columns, UNAES128_Columns>();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// OFB with precomputed key stream (OFB_Pipeline.hpp)
+//
+
+// update() in chunks, optionally with fill() before each one
+template <typename P>
+vector<uint8_t> pipelineRun(P& p,
+                            const vector<uint8_t>& in,
+                            const size_t chunk,
+                            const bool fill)
+{
+    vector<uint8_t> out;
+    for (size_t i = 0; i < in.size(); i += chunk) {
+        if (fill) p.fill();
+
+        const vector<uint8_t> a(in.begin() + i,
+                                in.begin() + min(i + chunk, in.size()));
+        p.update(a, out);
+    }
+
+    return out;
+}
+
+// the same as OFB(), with a background thread and with fill(), in chunks
+// larger than a four block ring
+bool ofbPipeline()
+{
+    AES128::KeyType k;
+    AES128::BlockType IV;
+    asciiHexToArray(modeKey, k);
+    asciiHexToArray(modeIV, IV);
+    const AES128::KeyContext key(k, false);
+
+    const auto msg = countMessage(4000);
+    const auto ofb = OFB(AES128(), key, IV, msg);
+
+    bool ok = true;
+
+    for (const size_t chunk : { 1, 7, 1000, 4000 }) {
+        for (const size_t ring : { 4, 1024 }) {
+            OFB_Pipeline<AES128> a(key, IV, true, ring);
+            ok = pipelineRun(a, msg, chunk, false) == ofb && ok;
+
+            OFB_Pipeline<AES128> b(key, IV, false, ring);
+            ok = pipelineRun(b, msg, chunk, true) == ofb && ok;
+
+            // without fill(), update() generates the key stream
+            OFB_Pipeline<AES128> c(key, IV, false, ring);
+            ok = pipelineRun(c, msg, chunk, false) == ofb && ok;
+
+            OFB_Pipeline<UNAES128> d(k, IV, true, ring);
+            ok = pipelineRun(d, ofb, chunk, false) == msg && ok;
+        }
+    }
+
+    // fill() is bounded by the ring and maxBlocks, a no-op with a thread
+    OFB_Pipeline<AES128> a(key, IV, false, 4);
+    ok = 3 == a.fill(3) && 48 == a.available() && ok;
+    ok = 1 == a.fill() && 64 == a.available() && 0 == a.fill() && ok;
+
+    // a partial last block
+    const vector<uint8_t> part(msg.begin(), msg.begin() + 50);
+    ok = pipelineRun(a, part, 7, true) ==
+             vector<uint8_t>(ofb.begin(), ofb.begin() + 50) && ok;
+
+    OFB_Pipeline<AES128> b(key, IV, true, 4);
+    ok = 0 == b.fill() && ok;
+
+    return ok;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// CTR_DRBG (NIST SP 800-90A, AES without derivation function)
+//
+
+struct DRBGVector {
+    string entropy, personalization;
+    string reseedEntropy, reseedAdditional; // no reseed if empty
+    string additional1, additional2;
+    string returned;                        // second generate() call
+};
+
+// CAVP CTR_DRBG AES-128 no df, no prediction resistance COUNT 0, then
+// vectors computed with OpenSSL: a reseed with additional input and
+// personalization and additional input shorter than seedlen
+const vector<DRBGVector> drbg128Vectors = {
+    // COUNT 0
+    { "ce50f33da5d4c1d3d4004eb35244b7f2cd7f2e5076fbf6780a7ff634b249a5fc",
+      "", "", "", "", "",
+      "6545c0529d372443b392ceb3ae3a99a30f963eaf313280f1d1a1e87f9db373d3"
+      "61e75d18018266499cccd64d9bbb8de0185f213383080faddec46bae1f784e5a" },
+    { "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f",
+      "404142434445464748494a4b4c4d4e4f505152535455565758595a5b5c5d5e5f",
+      "808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f",
+      "c0c1c2c3c4c5c6c7c8c9cacbcccdcecfd0d1d2d3d4d5d6d7d8d9dadbdcdddedf",
+      "606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f",
+      "a0a1a2a3a4a5a6a7a8a9aaabacadaeafb0b1b2b3b4b5b6b7b8b9babbbcbdbebf",
+      "5cb3b4588406d23b544eec76f41e23e365539f050a4596d76ff78c8ce63f9253"
+      "adf4c17f6e35167bad2580031d64565b9d8e0ef44b665874f87ac4915fb4814f" },
+    { "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f",
+      "404142434445464748494a4b4c4d4e4f50515253",
+      "", "",
+      "6061626364",
+      "",
+      "d907204378e5afd62110484b28063a18b1ae2a354813381b3b8f51e1f28d6cb6"
+      "5f0a4e8401fec1e8950861119e8b20e452a51c8d9552e4710382dc97fcaaf0b4" } };
+
+const DRBGVector drbg256Vector = {
+    "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+    "202122232425262728292a2b2c2d2e2f",
+    "404142434445464748494a4b4c4d4e4f505152535455565758595a5b5c5d5e5f"
+    "606162636465666768696a6b6c6d6e6f",
+    "808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f"
+    "a0a1a2a3a4a5a6a7a8a9aaabacadaeaf",
+    "c0c1c2c3c4c5c6c7c8c9cacbcccdcecfd0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+    "e0e1e2e3e4e5e6e7e8e9eaebecedeeef",
+    "101112131415161718191a1b1c1d1e1f202122232425262728292a2b2c2d2e2f"
+    "303132333435363738393a3b3c3d3e3f",
+    "a0a1a2a3a4a5a6a7a8a9aaabacadaeafb0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+    "c0c1c2c3c4c5c6c7c8c9cacbcccdcecf",
+    "7a053e36d25aa35dacb8f3ecd0e680abd3010008d12f27a6274c742de6feb432"
+    "c80c71cc7ba59738fcd29fcdf93c4c8be2267d42c6326372fa3f4975939dc446" };
+
+// the entropy source returns the vector entropy, then fails
+template <typename T>
+bool drbgCheck(const DRBGVector& v)
+{
+    vector<vector<uint8_t>> entropy = { fromHex(v.entropy) };
+    if (! v.reseedEntropy.empty())
+        entropy.push_back(fromHex(v.reseedEntropy));
+
+    size_t calls = 0;
+    const DRBG_EntropySource source =
+        [&entropy, &calls] (uint8_t* out, const size_t n) {
+            if (calls == entropy.size() || entropy[calls].size() != n)
+                return false;
+
+            copy(entropy[calls].begin(), entropy[calls].end(), out);
+            ++calls;
+            return true;
+        };
+
+    CTR_DRBG<T> drbg(source, fromHex(v.personalization));
+    bool ok = drbg.instantiated();
+
+    if (! v.reseedEntropy.empty())
+        ok = drbg.reseed(fromHex(v.reseedAdditional)) && ok;
+
+    vector<uint8_t> out(v.returned.size() / 2);
+    ok = drbg.generate(out, fromHex(v.additional1)) &&
+         drbg.generate(out, fromHex(v.additional2)) &&
+         asciiHex(out) == v.returned && ok;
+
+    // a failed reseed leaves the generator uninstantiated
+    ok = ! drbg.reseed() && ! drbg.instantiated() &&
+         ! drbg.generate(out) && ok;
+
+    return ok;
+}
+
+bool ctrDrbg()
+{
+    bool ok = true;
+    for (const auto& v : drbg128Vectors)
+        ok = drbgCheck<AES128>(v) && ok;
+
+    return drbgCheck<AES256>(drbg256Vector) && ok;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// vector permute AES (AES_VPerm.hpp, needs SSSE3)
+//
+
+#ifdef __SSSE3__
+
+// the first three of four lanes, each with its own key, against the
+// reference cipher (the fourth lane has no key context and is not used)
+template <typename T, typename REF>
+bool vpermLanes()
+{
+    const size_t L = 4, n = 3;
+
+    array<typename T::KeyType, L> k;
+    array<typename T::KeyContext, L> ctx;
+    array<const typename T::KeyContext*, L> lane;
+    array<typename T::BlockType, L> in, out, back;
+
+    lane.fill(nullptr);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < k[i].size(); ++j) k[i][j] = 17 * i + j;
+        for (size_t j = 0; j < in[i].size(); ++j) in[i][j] = 5 * i + 3 * j;
+
+        ctx[i].rekey(k[i]);
+        lane[i] = &ctx[i];
+    }
+
+    in[n].fill(0x5a);
+    out[n].fill(0xa5);
+    back[n].fill(0xa5);
+
+    T::KeyContext::encryptLanes(lane, in, out, n);
+    T::KeyContext::decryptLanes(lane, out, back, n);
+
+    bool ok = true;
+    for (size_t i = 0; i < n; ++i) {
+        const typename REF::KeyContext key(k[i]);
+
+        typename T::BlockType a;
+        key.encrypt(in[i], a);
+        ok = out[i] == a && back[i] == in[i] && ok;
+    }
+
+    // unused lane is not written
+    typename T::BlockType untouched;
+    untouched.fill(0xa5);
+    return out[n] == untouched && back[n] == untouched && ok;
+}
+
+// modes against the table AES
+template <typename T, typename UNT>
+bool vpermModes()
+{
+    AES128::KeyType k;
+    AES128::BlockType IV, ctrIV;
+    asciiHexToArray(modeKey, k);
+    asciiHexToArray(modeIV, IV);
+    asciiHexToArray(carryIV, ctrIV);
+
+    const typename T::KeyContext key(k);
+    const auto
+        msg = countMessage(160),
+        ecb = ECB(AES128(), k, msg),
+        cbc = CBC(AES128(), k, IV, msg),
+        cfb = CFB(AES128(), k, IV, msg),
+        ofb = OFB(AES128(), k, IV, msg),
+        ctr = CTR(AES128(), k, ctrIV, msg);
+
+    return ECB(T(), key, msg) == ecb && ECB(UNT(), key, ecb) == msg &&
+           CBC(T(), key, IV, msg) == cbc && CBC(UNT(), key, IV, cbc) == msg &&
+           CFB(T(), key, IV, msg) == cfb && CFB(UNT(), key, IV, cfb) == msg &&
+           OFB(T(), key, IV, msg) == ofb && OFB(UNT(), key, IV, ofb) == msg &&
+           CTR(T(), key, ctrIV, msg) == ctr;
+}
+
+bool vperm()
+{
+    return fips197Check<AES128_VPerm>(fips197Vectors[0]) &
+           fips197Check<AES192_VPerm>(fips197Vectors[1]) &
+           fips197Check<AES256_VPerm>(fips197Vectors[2]) &
+           vpermLanes<AES128_VPerm, AES128>() &
+           vpermLanes<AES192_VPerm, AES192>() &
+           vpermLanes<AES256_VPerm, AES256>() &
+           vpermModes<AES128_VPerm, UNAES128_VPerm>();
+}
+
+#endif // __SSSE3__
+
+int main(int argc, char *argv[])
+{
+    string prefix;
+    int opt;
+    while (-1 != (opt = getopt(argc, argv, "t:"))) {
+        switch (opt) {
+        case ('t') :
+            prefix = optarg;
+            break;
+        default :
+            printUsage(argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    const vector<pair<string, bool (*)()>> tests = {
+        { "XTS-AES IEEE 1619", xts },
+        { "CMAC RFC 4493 and SP 800-38B", cmac },
+        { "PMAC1 AES-128", pmac },
+        { "HMAC RFC 4231", hmac },
+        { "CTR_HMAC SP 800-38A", ctrHmac },
+        { "ChaCha20 RFC 8439", chacha20 },
+        { "Poly1305 RFC 8439", poly1305 },
+        { "ChaCha20-Poly1305 RFC 8439", aead },
+        { "BLAKE3 hash and keyed hash", blake3 },
+        { "CipherContext chunks and PKCS#7 padding", cipherContext },
+        { "ParallelModes against CipherModes", parallelModes },
+        { "ThreadPool exceptions and nested runs", threadPool },
+        { "GF(2^8) multiply", gf256Multiply },
+        { "AES S-box circuits", sboxCircuit },
+        { "AES 32-bit columns", columns },
+        { "MultiStream CBC, OFB and rekey", multiStream },
+        { "OFB_Pipeline against OFB", ofbPipeline },
+        { "CTR_DRBG SP 800-90A", ctrDrbg },
+#ifdef __SSSE3__
+        { "AES vector permute (SSSE3)", vperm },
+#endif
+    };
+
+    bool all = true;
+    for (const auto& t : tests) {
+        if (0 != t.first.compare(0, prefix.size(), prefix)) continue;
+
+        const bool ok = t.second();
+        cout << (ok ? "OK" : "FAIL") << " " << t.first << endl;
+        all = all && ok;
+    }
+
+    return all ? EXIT_SUCCESS : EXIT_FAILURE;
+}
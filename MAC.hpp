@@ -0,0 +1,454 @@
+#ifndef _CRYPTL_MAC_HPP_
+#define _CRYPTL_MAC_HPP_
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <cryptl/ThreadPool.hpp>
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// block cipher message authentication codes
+//
+// CMAC (NIST SP 800-38B) and PMAC1 (Rogaway, "Efficient Instantiations of
+// Tweakable Blockciphers and Refinements to Modes OCB and PMAC").
+//
+// A MAC key holds the key context and the derived subkeys, computed once.
+// A MAC context streams input of any chunk size with one cipher call per
+// block. It keeps a reference to the MAC key, which must outlive it.
+// After finalize() the context is ready for the next message.
+//
+// T is one of the sized AES variants (AES_128, AES_192, AES_256).
+//
+
+// multiply by x in GF(2^128), big-endian block (SP 800-38B subkeys)
+template <typename BLK>
+void macDouble(BLK& a)
+{
+    const std::size_t B = a.size();
+    const unsigned int msb = a[0] >> 7;
+
+    for (std::size_t j = 0; j < B - 1; ++j)
+        a[j] = ((a[j] << 1) | (a[j + 1] >> 7)) & 0xff;
+
+    a[B - 1] = ((a[B - 1] << 1) ^ (0x87 & -msb)) & 0xff;
+}
+
+// multiply by x^-1 in GF(2^128), big-endian block
+template <typename BLK>
+void macHalve(BLK& a)
+{
+    const std::size_t B = a.size();
+    const unsigned int lsb = a[B - 1] & 1;
+
+    for (std::size_t j = B - 1; j > 0; --j)
+        a[j] = ((a[j] >> 1) | (a[j - 1] << 7)) & 0xff;
+
+    a[0] >>= 1;
+
+    // x^-1 = x^127 + x^6 + x + 1
+    a[0] ^= 0x80 & -lsb;
+    a[B - 1] ^= 0x43 & -lsb;
+}
+
+// 10* padding of a partial block with N octets
+template <typename BLK>
+void macPad(BLK& a, const std::size_t N)
+{
+    for (std::size_t j = N; j < a.size(); ++j)
+        a[j] = j == N ? 0x80 : 0;
+}
+
+// compare tags in constant time
+template <typename BLK>
+bool macVerify(const BLK& a, const BLK& b)
+{
+    unsigned int diff = 0;
+    for (std::size_t j = 0; j < a.size(); ++j)
+        diff |= a[j] ^ b[j];
+
+    return 0 == diff;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// streaming input, holds back the last block for finalize()
+//
+
+template <typename CRTP, typename T, typename U>
+class MAC_Context
+{
+public:
+    typedef typename T::BlockType BlockType;
+
+    void update(const U* in, const std::size_t inLength) {
+        const std::size_t B = m_buf.size();
+        auto* ptr = static_cast<CRTP*>(this);
+
+        std::size_t inIdx = 0;
+
+        while (m_bufLength < B && inIdx < inLength)
+            m_buf[m_bufLength++] = in[inIdx++];
+
+        // buffered block is not the last one
+        if (inIdx == inLength) return;
+        ptr->absorb(m_buf.data());
+
+        // whole blocks directly from input, except the last one
+        while (inLength - inIdx > B) {
+            ptr->absorb(in + inIdx);
+            inIdx += B;
+        }
+
+        m_bufLength = 0;
+        while (inIdx < inLength)
+            m_buf[m_bufLength++] = in[inIdx++];
+    }
+
+    void update(const std::vector<U>& in) {
+        update(in.data(), in.size());
+    }
+
+    void finalize(BlockType& tag) {
+        static_cast<CRTP*>(this)->finalBlock(m_buf, m_bufLength, tag);
+        m_bufLength = 0;
+    }
+
+protected:
+    MAC_Context()
+        : m_bufLength(0)
+    {}
+
+private:
+    BlockType m_buf;
+    std::size_t m_bufLength;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// CMAC
+//
+
+template <typename T>
+class CMAC_Key
+{
+public:
+    typedef typename T::KeyType KeyType;
+    typedef typename T::BlockType BlockType;
+    typedef typename T::KeyContext KeyContext;
+
+    CMAC_Key() = default;
+
+    explicit CMAC_Key(const KeyType& key) {
+        rekey(key);
+    }
+
+    void rekey(const KeyType& key) {
+        // only the forward cipher is used
+        m_key.rekey(key, false);
+
+        BlockType L;
+        for (auto& a : L) a = 0;
+        m_key.encrypt(L, L);
+
+        m_K1 = L;
+        macDouble(m_K1);
+
+        m_K2 = m_K1;
+        macDouble(m_K2);
+    }
+
+    const KeyContext& keyContext() const { return m_key; }
+    const BlockType& K1() const { return m_K1; }
+    const BlockType& K2() const { return m_K2; }
+
+private:
+    KeyContext m_key;
+    BlockType m_K1, m_K2;
+};
+
+template <typename T, typename U = typename T::VarType>
+class CMAC_Context : public MAC_Context<CMAC_Context<T, U>, T, U>
+{
+public:
+    typedef typename T::BlockType BlockType;
+
+    explicit CMAC_Context(const CMAC_Key<T>& key)
+        : m_key(key)
+    {
+        reset();
+    }
+
+    void absorb(const U* in) {
+        for (std::size_t j = 0; j < m_X.size(); ++j)
+            m_X[j] ^= in[j];
+
+        m_key.keyContext().encrypt(m_X, m_X);
+    }
+
+    void finalBlock(BlockType& last, const std::size_t N, BlockType& tag) {
+        const std::size_t B = last.size();
+
+        // complete block uses K1, padded partial block uses K2
+        if (N < B) macPad(last, N);
+        const BlockType& K = N < B ? m_key.K2() : m_key.K1();
+
+        for (std::size_t j = 0; j < B; ++j)
+            m_X[j] ^= last[j] ^ K[j];
+
+        m_key.keyContext().encrypt(m_X, tag);
+
+        reset();
+    }
+
+private:
+    void reset() {
+        for (auto& a : m_X) a = 0;
+    }
+
+    const CMAC_Key<T>& m_key;
+    BlockType m_X;
+};
+
+template <typename T, typename U>
+typename T::BlockType CMAC(const CMAC_Key<T>& key,
+                           const std::vector<U>& msg)
+{
+    typename T::BlockType tag;
+    CMAC_Context<T, U> ctx(key);
+    ctx.update(msg);
+    ctx.finalize(tag);
+    return tag;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// PMAC1
+//
+// Block i (from 1) is masked by offset Delta_i = Delta_(i-1) XOR L(ntz(i)),
+// where L(k) = x^k * E(0). Blocks are independent given the offset, and
+// Delta_i is the XOR of L(k) over bits k set in the Gray code of i, so
+// any range of blocks can be processed on its own.
+//
+
+template <typename T>
+class PMAC_Key
+{
+public:
+    typedef typename T::KeyType KeyType;
+    typedef typename T::BlockType BlockType;
+    typedef typename T::KeyContext KeyContext;
+
+    PMAC_Key() = default;
+
+    explicit PMAC_Key(const KeyType& key) {
+        rekey(key);
+    }
+
+    void rekey(const KeyType& key) {
+        // only the forward cipher is used
+        m_key.rekey(key, false);
+
+        for (auto& a : m_L[0]) a = 0;
+        m_key.encrypt(m_L[0], m_L[0]);
+
+        m_Linv = m_L[0];
+        macHalve(m_Linv);
+
+        for (std::size_t k = 1; k < m_L.size(); ++k) {
+            m_L[k] = m_L[k - 1];
+            macDouble(m_L[k]);
+        }
+    }
+
+    const KeyContext& keyContext() const { return m_key; }
+
+    // L(k) = x^k * L
+    const BlockType& L(const std::size_t k) const { return m_L[k]; }
+
+    // x^-1 * L
+    const BlockType& Linv() const { return m_Linv; }
+
+    // offset for block i
+    BlockType offset(const std::uint64_t i) const {
+        const std::uint64_t gray = i ^ (i >> 1);
+
+        BlockType delta;
+        for (auto& a : delta) a = 0;
+
+        for (std::size_t k = 0; k < m_L.size(); ++k) {
+            if ((gray >> k) & 1) {
+                for (std::size_t j = 0; j < delta.size(); ++j)
+                    delta[j] ^= m_L[k][j];
+            }
+        }
+
+        return delta;
+    }
+
+private:
+    KeyContext m_key;
+    std::array<BlockType, 64> m_L;
+    BlockType m_Linv;
+};
+
+// number of trailing zero bits (i is not zero)
+inline std::size_t pmacNTZ(std::uint64_t i)
+{
+    std::size_t n = 0;
+    while (0 == (i & 1)) {
+        i >>= 1;
+        ++n;
+    }
+
+    return n;
+}
+
+// sum of encrypted masked blocks [first, end) numbered from 1,
+// starting from offset Delta_(first - 1)
+template <typename T, typename U>
+void pmacBlocks(const PMAC_Key<T>& key,
+                const U* in,
+                const std::uint64_t first,
+                const std::uint64_t end,
+                typename T::BlockType& delta,
+                typename T::BlockType& sigma)
+{
+    typename T::BlockType X;
+    const std::size_t B = X.size();
+
+    for (std::uint64_t i = first; i < end; ++i, in += B) {
+        const auto& L = key.L(pmacNTZ(i));
+
+        for (std::size_t j = 0; j < B; ++j) {
+            delta[j] ^= L[j];
+            X[j] = in[j] ^ delta[j];
+        }
+
+        key.keyContext().encrypt(X, X);
+
+        for (std::size_t j = 0; j < B; ++j)
+            sigma[j] ^= X[j];
+    }
+}
+
+// tag from sum of all blocks before the last one
+template <typename T>
+void pmacFinal(const PMAC_Key<T>& key,
+               typename T::BlockType& sigma,
+               typename T::BlockType& last,
+               const std::size_t N,
+               typename T::BlockType& tag)
+{
+    const std::size_t B = last.size();
+
+    if (N < B) macPad(last, N);
+
+    for (std::size_t j = 0; j < B; ++j)
+        sigma[j] ^= last[j];
+
+    // complete last block is marked with x^-1 * L
+    if (N == B) {
+        for (std::size_t j = 0; j < B; ++j)
+            sigma[j] ^= key.Linv()[j];
+    }
+
+    key.keyContext().encrypt(sigma, tag);
+}
+
+template <typename T, typename U = typename T::VarType>
+class PMAC_Context : public MAC_Context<PMAC_Context<T, U>, T, U>
+{
+public:
+    typedef typename T::BlockType BlockType;
+
+    explicit PMAC_Context(const PMAC_Key<T>& key)
+        : m_key(key)
+    {
+        reset();
+    }
+
+    void absorb(const U* in) {
+        ++m_count;
+        pmacBlocks(m_key, in, m_count, m_count + 1, m_delta, m_sigma);
+    }
+
+    void finalBlock(BlockType& last, const std::size_t N, BlockType& tag) {
+        pmacFinal(m_key, m_sigma, last, N, tag);
+        reset();
+    }
+
+private:
+    void reset() {
+        m_count = 0;
+        for (auto& a : m_delta) a = 0;
+        for (auto& a : m_sigma) a = 0;
+    }
+
+    const PMAC_Key<T>& m_key;
+    std::uint64_t m_count;
+    BlockType m_delta, m_sigma;
+};
+
+template <typename T, typename U>
+typename T::BlockType PMAC(const PMAC_Key<T>& key,
+                           const std::vector<U>& msg)
+{
+    typename T::BlockType tag;
+    PMAC_Context<T, U> ctx(key);
+    ctx.update(msg);
+    ctx.finalize(tag);
+    return tag;
+}
+
+// blocks in chunks of chunkOctets are processed in parallel
+template <typename T, typename U>
+typename T::BlockType PMAC(const PMAC_Key<T>& key,
+                           const std::vector<U>& msg,
+                           ThreadPool& pool,
+                           const std::size_t chunkOctets = 16 * 1024)
+{
+    typename T::BlockType last, tag;
+    const std::size_t B = last.size();
+
+    // all blocks except the last one (which may be partial or empty)
+    const std::size_t
+        N = msg.empty() ? 0 : (msg.size() - 1) / B,
+        C = chunkOctets < B ? 1 : chunkOctets / B,
+        numChunks = (N + C - 1) / C;
+
+    std::vector<typename T::BlockType> sums(numChunks);
+
+    pool.run(
+        numChunks,
+        [&] (const std::size_t i) {
+            const std::size_t
+                first = i * C,
+                end = first + C < N ? first + C : N;
+
+            auto delta = key.offset(first);
+            auto& sigma = sums[i];
+            for (auto& a : sigma) a = 0;
+
+            pmacBlocks(key, msg.data() + first * B, first + 1, end + 1,
+                       delta, sigma);
+        });
+
+    typename T::BlockType sigma;
+    for (auto& a : sigma) a = 0;
+
+    for (const auto& s : sums) {
+        for (std::size_t j = 0; j < B; ++j)
+            sigma[j] ^= s[j];
+    }
+
+    const std::size_t lastLength = msg.size() - N * B;
+    for (std::size_t j = 0; j < lastLength; ++j)
+        last[j] = msg[N * B + j];
+
+    pmacFinal(key, sigma, last, lastLength, tag);
+    return tag;
+}
+
+} // namespace cryptl
+
+#endif
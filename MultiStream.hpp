@@ -0,0 +1,221 @@
+#ifndef _CRYPTL_MULTI_STREAM_HPP_
+#define _CRYPTL_MULTI_STREAM_HPP_
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// many independent streams
+//
+// CBC encryption and OFB are serial within a stream, each block waits for
+// the one before it. With many streams (sessions), each with its own key
+// and IV, L streams are processed together with their cipher rounds
+// interleaved so the latencies overlap. When a stream finishes, its lane
+// is refilled from the next job. Output is identical to CBC() and OFB()
+// on each stream alone.
+//
+// Key expansion for many keys is batched the same way.
+//
+// T is a sized AES variant. The lanes are the static functions of
+// T::KeyContext (rekeyLanes, encryptLanes, decryptLanes).
+//
+
+const std::size_t MULTI_STREAM_LANES = 4;
+
+// one stream of whole blocks, the chaining block is updated so a stream
+// can be continued by another call
+template <typename T, typename U>
+struct StreamJob
+{
+    const typename T::KeyContext* key;
+    typename T::BlockType chain;        // IV, then last cipher/OFB block
+    const U* in;
+    U* out;
+    std::size_t length;                 // octets
+};
+
+// L lanes of streams, pre(job, offset, inBlock) and
+// post(job, offset, inBlock, outBlock) are called before and after the
+// cipher for each block of each job
+template <std::size_t L, typename T, typename U, typename PRE, typename POST>
+void multiStreamLanes(T dummy,
+                      std::vector<StreamJob<T, U>>& jobs,
+                      const bool forward,
+                      const PRE& pre,
+                      const POST& post)
+{
+    typedef typename T::KeyContext KeyContext;
+    typedef typename T::BlockType BlockType;
+
+    const std::size_t B = BlockType().size();
+
+    std::array<const KeyContext*, L> ctx;
+    std::array<BlockType, L> inBlock, outBlock;
+    std::array<std::size_t, L> job, offset;
+    ctx.fill(nullptr);
+
+    std::size_t nextJob = 0, n = 0;
+
+    while (true) {
+        // refill idle lanes
+        while (n < L && nextJob < jobs.size()) {
+            const auto& a = jobs[nextJob];
+#ifdef USE_ASSERT
+            // even number of blocks
+            assert(0 == a.length % B);
+#endif
+            if (a.length >= B) {
+                ctx[n] = a.key;
+                job[n] = nextJob;
+                offset[n] = 0;
+                ++n;
+            }
+
+            ++nextJob;
+        }
+
+        if (0 == n) break;
+
+        for (std::size_t k = 0; k < n; ++k)
+            pre(jobs[job[k]], offset[k], inBlock[k]);
+
+        if (forward)
+            KeyContext::encryptLanes(ctx, inBlock, outBlock, n);
+        else
+            KeyContext::decryptLanes(ctx, inBlock, outBlock, n);
+
+        for (std::size_t k = 0; k < n; ++k)
+            post(jobs[job[k]], offset[k], inBlock[k], outBlock[k]);
+
+        // retire finished streams, the last lane moves into the gap
+        for (std::size_t k = 0; k < n; ) {
+            offset[k] += B;
+
+            if (offset[k] + B > jobs[job[k]].length) {
+                --n;
+                ctx[k] = ctx[n];
+                job[k] = job[n];
+                offset[k] = offset[n];
+            } else {
+                ++k;
+            }
+        }
+    }
+}
+
+// cipher block chaining mode (CBC) on many streams
+template <std::size_t L = MULTI_STREAM_LANES, typename T, typename U>
+void MultiCBC(T dummy, std::vector<StreamJob<T, U>>& jobs)
+{
+    typedef typename T::BlockType BlockType;
+    const std::size_t B = BlockType().size();
+
+    if (T::isEncryption()) {
+        multiStreamLanes<L>(
+            dummy,
+            jobs,
+            true,
+            [B] (const StreamJob<T, U>& a,
+                 const std::size_t offset,
+                 BlockType& inBlock) {
+                for (std::size_t j = 0; j < B; ++j)
+                    inBlock[j] = a.in[j + offset] ^ a.chain[j];
+            },
+            [B] (StreamJob<T, U>& a,
+                 const std::size_t offset,
+                 const BlockType& inBlock,
+                 const BlockType& outBlock) {
+                for (std::size_t j = 0; j < B; ++j)
+                    a.out[j + offset] = outBlock[j];
+
+                a.chain = outBlock;
+            });
+
+    } else { // isDecryption
+        multiStreamLanes<L>(
+            dummy,
+            jobs,
+            false,
+            [B] (const StreamJob<T, U>& a,
+                 const std::size_t offset,
+                 BlockType& inBlock) {
+                for (std::size_t j = 0; j < B; ++j)
+                    inBlock[j] = a.in[j + offset];
+            },
+            [B] (StreamJob<T, U>& a,
+                 const std::size_t offset,
+                 const BlockType& inBlock,
+                 const BlockType& outBlock) {
+                for (std::size_t j = 0; j < B; ++j)
+                    a.out[j + offset] = outBlock[j] ^ a.chain[j];
+
+                a.chain = inBlock;
+            });
+    }
+}
+
+// output feedback mode (OFB) on many streams
+template <std::size_t L = MULTI_STREAM_LANES, typename T, typename U>
+void MultiOFB(T dummy, std::vector<StreamJob<T, U>>& jobs)
+{
+    typedef typename T::BlockType BlockType;
+    const std::size_t B = BlockType().size();
+
+    // the forward cipher in both directions
+    multiStreamLanes<L>(
+        dummy,
+        jobs,
+        true,
+        [] (const StreamJob<T, U>& a,
+            const std::size_t offset,
+            BlockType& inBlock) {
+            inBlock = a.chain;
+        },
+        [B] (StreamJob<T, U>& a,
+             const std::size_t offset,
+             const BlockType& inBlock,
+             const BlockType& outBlock) {
+            for (std::size_t j = 0; j < B; ++j)
+                a.out[j + offset] = outBlock[j] ^ a.in[j + offset];
+
+            a.chain = outBlock;
+        });
+}
+
+// key expansion for many keys, L at a time
+template <std::size_t L = MULTI_STREAM_LANES, typename T>
+std::vector<typename T::KeyContext> MultiRekey(
+    T dummy,
+    const std::vector<typename T::KeyType>& keys,
+    const bool withDecrypt = true)
+{
+    typedef typename T::KeyContext KeyContext;
+
+    std::vector<KeyContext> ctx(keys.size());
+
+    std::array<const typename T::KeyType*, L> key;
+    std::array<KeyContext*, L> lane;
+    key.fill(nullptr);
+    lane.fill(nullptr);
+
+    for (std::size_t i = 0; i < keys.size(); i += L) {
+        const std::size_t n = i + L < keys.size() ? L : keys.size() - i;
+
+        for (std::size_t k = 0; k < n; ++k) {
+            key[k] = &keys[i + k];
+            lane[k] = &ctx[i + k];
+        }
+
+        KeyContext::rekeyLanes(key, lane, withDecrypt, n);
+    }
+
+    return ctx;
+}
+
+} // namespace cryptl
+
+#endif
@@ -0,0 +1,220 @@
+#ifndef _CRYPTL_OFB_PIPELINE_HPP_
+#define _CRYPTL_OFB_PIPELINE_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// output feedback mode (OFB) with precomputed key stream
+//
+// The OFB key stream depends only on the key and IV. It is generated ahead
+// of the data into a ring buffer, either by a background thread or by
+// calling fill() when the application is idle. Encrypting or decrypting
+// arriving data is then only an XOR with the buffered key stream.
+//
+// Input may be any length, the key stream is consumed octet by octet. The
+// output is identical to OFB() and OFB_Context. If the ring buffer runs
+// dry, update() waits for the background thread or, without one, generates
+// the key stream itself.
+//
+// One thread calls update() and fill(). With a background thread, the ring
+// buffer is single producer and single consumer.
+//
+
+template <typename T, typename U = typename T::VarType>
+class OFB_Pipeline
+{
+public:
+    typedef typename T::BlockType BlockType;
+
+    // ring buffer of ringBlocks key stream blocks
+    OFB_Pipeline(const typename T::KeyContext& key,
+                 const BlockType& IV,
+                 const bool background = true,
+                 const std::size_t ringBlocks = 1024)
+        : m_key(key),
+          m_lastBlock(IV),
+          m_ring((0 == ringBlocks ? 1 : ringBlocks) * IV.size()),
+          m_produced(0),
+          m_consumed(0),
+          m_stop(false)
+    {
+        if (background) start();
+    }
+
+    OFB_Pipeline(const typename T::KeyType& key,
+                 const BlockType& IV,
+                 const bool background = true,
+                 const std::size_t ringBlocks = 1024)
+        : OFB_Pipeline(typename T::KeyContext(key, false),
+                       IV,
+                       background,
+                       ringBlocks)
+    {}
+
+    ~OFB_Pipeline() {
+        if (m_thread.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop = true;
+            }
+
+            m_spaceReady.notify_one();
+            m_thread.join();
+        }
+    }
+
+    OFB_Pipeline(const OFB_Pipeline&) = delete;
+    OFB_Pipeline& operator= (const OFB_Pipeline&) = delete;
+
+    // without a background thread, generate key stream until the ring
+    // buffer is full (or maxBlocks), returns number of blocks generated
+    std::size_t fill(const std::size_t maxBlocks = std::size_t(-1)) {
+        if (m_thread.joinable()) return 0;
+
+        std::size_t N = space();
+        if (N > maxBlocks) N = maxBlocks;
+
+        produce(N);
+        return N;
+    }
+
+    // key stream octets ready for use
+    std::size_t available() const {
+        return m_produced.load(std::memory_order_acquire) * blockSize()
+            - m_consumed.load(std::memory_order_relaxed);
+    }
+
+    // encrypt or decrypt (the same in OFB mode)
+    void update(const U* in, const std::size_t inLength, U* out) {
+        const std::size_t R = m_ring.size();
+
+        std::size_t idx = 0;
+        while (idx < inLength) {
+            std::size_t N = waitAvailable();
+            if (N > inLength - idx) N = inLength - idx;
+
+            // contiguous up to the end of the ring
+            const std::size_t
+                pos = m_consumed.load(std::memory_order_relaxed) % R;
+            if (N > R - pos) N = R - pos;
+
+            const U* ks = m_ring.data() + pos;
+            for (std::size_t j = 0; j < N; ++j)
+                out[idx + j] = in[idx + j] ^ ks[j];
+
+            idx += N;
+            m_consumed.fetch_add(N, std::memory_order_release);
+
+            if (m_thread.joinable()) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_spaceReady.notify_one();
+            }
+        }
+    }
+
+    // appends to out
+    void update(const std::vector<U>& in, std::vector<U>& out) {
+        const std::size_t offset = out.size();
+        out.resize(offset + in.size());
+        update(in.data(), in.size(), out.data() + offset);
+    }
+
+private:
+    std::size_t blockSize() const {
+        return m_lastBlock.size();
+    }
+
+    // blocks that may be written without overwriting unused key stream
+    std::size_t space() const {
+        const std::size_t
+            B = blockSize(),
+            C = m_ring.size() / B,
+            oldest = m_consumed.load(std::memory_order_acquire) / B,
+            produced = m_produced.load(std::memory_order_relaxed);
+
+        return oldest + C - produced;
+    }
+
+    // generate N blocks into the ring buffer
+    void produce(const std::size_t N) {
+        const std::size_t
+            B = blockSize(),
+            C = m_ring.size() / B;
+
+        std::size_t produced = m_produced.load(std::memory_order_relaxed);
+
+        for (std::size_t i = 0; i < N; ++i, ++produced) {
+            // the forward cipher in both directions
+            m_key.encrypt(m_lastBlock, m_lastBlock);
+
+            U* ks = m_ring.data() + (produced % C) * B;
+            for (std::size_t j = 0; j < B; ++j)
+                ks[j] = m_lastBlock[j];
+        }
+
+        m_produced.store(produced, std::memory_order_release);
+    }
+
+    // returns key stream octets available, at least one
+    std::size_t waitAvailable() {
+        std::size_t N = available();
+        if (N > 0) return N;
+
+        if (! m_thread.joinable()) {
+            produce(space());
+            return available();
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_dataReady.wait(lock, [this] { return 0 != available(); });
+        return available();
+    }
+
+    void start() {
+        m_thread = std::thread([this] {
+            // generate in batches so the consumer is not woken every block
+            const std::size_t batch = m_ring.size() / blockSize() / 4 + 1;
+
+            while (true) {
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_spaceReady.wait(lock, [this, batch] {
+                        return m_stop || space() >= batch || 0 == available();
+                    });
+
+                    if (m_stop) return;
+                }
+
+                produce(space());
+
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_dataReady.notify_one();
+                }
+            }
+        });
+    }
+
+    const typename T::KeyContext m_key;
+    BlockType m_lastBlock;
+
+    std::vector<U> m_ring;
+    std::atomic<std::size_t> m_produced; // blocks
+    std::atomic<std::size_t> m_consumed; // octets
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_spaceReady, m_dataReady;
+    bool m_stop;
+};
+
+} // namespace cryptl
+
+#endif
@@ -0,0 +1,282 @@
+#ifndef _CRYPTL_PARALLEL_MODES_HPP_
+#define _CRYPTL_PARALLEL_MODES_HPP_
+
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include <cryptl/CipherModes.hpp>
+#include <cryptl/ThreadPool.hpp>
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// multi-threaded block cipher modes
+//
+// Overloads of the functions in CipherModes.hpp taking a thread pool. The
+// input is split into chunks (default 16 KB, sized for cache) which are
+// processed concurrently. Output is identical to the serial functions.
+//
+// Parallel: ECB, CBC decryption, CFB decryption, CTR
+//
+// CBC and CFB encryption and OFB are inherently serial and have no
+// overloads here. Use the functions in CipherModes.hpp.
+//
+
+const std::size_t PARALLEL_CHUNK_OCTETS = 16 * 1024;
+
+// calls func(firstBlock, endBlock) for each chunk of whole blocks
+template <typename FUNC>
+void parallelChunks(ThreadPool& pool,
+                    const std::size_t numBlocks,
+                    const std::size_t chunkBlocks,
+                    const FUNC& func)
+{
+    const std::size_t C = 0 == chunkBlocks ? 1 : chunkBlocks;
+    const std::size_t numChunks = (numBlocks + C - 1) / C;
+
+    pool.run(
+        numChunks,
+        [numBlocks, C, &func] (const std::size_t i) {
+            const std::size_t
+                first = i * C,
+                end = first + C < numBlocks ? first + C : numBlocks;
+
+            func(first, end);
+        });
+}
+
+// electronic code book mode (ECB)
+template <typename T, typename U>
+std::vector<U> ECB(T dummy,
+                   const typename T::KeyContext& key,
+                   const std::vector<U>& inText,
+                   ThreadPool& pool,
+                   const std::size_t chunkOctets = PARALLEL_CHUNK_OCTETS)
+{
+    const std::size_t B = typename T::BlockType().size();
+    const std::size_t N = inText.size() / B;
+#ifdef USE_ASSERT
+    // even number of blocks
+    assert(N * B == inText.size());
+#endif
+    std::vector<U> outText(inText.size());
+
+    parallelChunks(
+        pool,
+        N,
+        chunkOctets / B,
+        [&] (const std::size_t first, const std::size_t end) {
+            typename T::BlockType inBlock, outBlock;
+
+            for (std::size_t i = first; i < end; ++i) {
+                const std::size_t offset = i * B;
+
+                for (std::size_t j = 0; j < B; ++j)
+                    inBlock[j] = inText[j + offset];
+
+                cryptBlock(dummy, key, inBlock, outBlock);
+
+                for (std::size_t j = 0; j < B; ++j)
+                    outText[j + offset] = outBlock[j];
+            }
+        });
+
+    return outText;
+}
+
+// cipher block chaining mode (CBC) decryption
+template <typename T, typename U>
+std::vector<U> CBC(T dummy,
+                   const typename T::KeyContext& key,
+                   const typename T::BlockType& IV,
+                   const std::vector<U>& inText,
+                   ThreadPool& pool,
+                   const std::size_t chunkOctets = PARALLEL_CHUNK_OCTETS)
+{
+    static_assert(std::is_same<typename T::Algo, typename T::Decrypt>::value,
+                  "CBC encryption is serial, use CipherModes.hpp");
+
+    const std::size_t B = IV.size();
+    const std::size_t N = inText.size() / B;
+#ifdef USE_ASSERT
+    // even number of blocks
+    assert(N * B == inText.size());
+#endif
+    std::vector<U> outText(inText.size());
+
+    parallelChunks(
+        pool,
+        N,
+        chunkOctets / B,
+        [&] (const std::size_t first, const std::size_t end) {
+            typename T::BlockType inBlock, outBlock, lastBlock = IV;
+
+            // chaining input is the preceding cipher text block
+            if (first > 0) {
+                for (std::size_t j = 0; j < B; ++j)
+                    lastBlock[j] = inText[j + (first - 1) * B];
+            }
+
+            for (std::size_t i = first; i < end; ++i) {
+                const std::size_t offset = i * B;
+
+                for (std::size_t j = 0; j < B; ++j)
+                    inBlock[j] = inText[j + offset];
+
+                key.decrypt(inBlock, outBlock);
+
+                for (std::size_t j = 0; j < B; ++j)
+                    outText[j + offset] = outBlock[j] ^ lastBlock[j];
+
+                lastBlock = inBlock;
+            }
+        });
+
+    return outText;
+}
+
+// cipher feedback mode (CFB) decryption
+template <typename T, typename U>
+std::vector<U> CFB(T dummy,
+                   const typename T::KeyContext& key,
+                   const typename T::BlockType& IV,
+                   const std::vector<U>& inText,
+                   ThreadPool& pool,
+                   const std::size_t chunkOctets = PARALLEL_CHUNK_OCTETS)
+{
+    static_assert(std::is_same<typename T::Algo, typename T::Decrypt>::value,
+                  "CFB encryption is serial, use CipherModes.hpp");
+
+    const std::size_t B = IV.size();
+    const std::size_t N = inText.size() / B;
+#ifdef USE_ASSERT
+    // even number of blocks
+    assert(N * B == inText.size());
+#endif
+    std::vector<U> outText(inText.size());
+
+    parallelChunks(
+        pool,
+        N,
+        chunkOctets / B,
+        [&] (const std::size_t first, const std::size_t end) {
+            typename T::BlockType outBlock, lastBlock = IV;
+
+            // feedback is the preceding cipher text block
+            if (first > 0) {
+                for (std::size_t j = 0; j < B; ++j)
+                    lastBlock[j] = inText[j + (first - 1) * B];
+            }
+
+            for (std::size_t i = first; i < end; ++i) {
+                const std::size_t offset = i * B;
+
+                key.encrypt(lastBlock, outBlock);
+
+                for (std::size_t j = 0; j < B; ++j) {
+                    outText[j + offset] = outBlock[j] ^ inText[j + offset];
+                    lastBlock[j] = inText[j + offset];
+                }
+            }
+        });
+
+    return outText;
+}
+
+// counter mode (CTR)
+template <typename T, typename U>
+std::vector<U> CTR(T dummy,
+                   const typename T::KeyContext& key,
+                   const typename T::BlockType& IV,
+                   const std::vector<U>& inText,
+                   ThreadPool& pool,
+                   const std::size_t chunkOctets = PARALLEL_CHUNK_OCTETS)
+{
+    const std::size_t B = IV.size();
+    const std::size_t N = (inText.size() + B - 1) / B;
+    std::vector<U> outText(inText.size());
+
+    parallelChunks(
+        pool,
+        N,
+        chunkOctets / B,
+        [&] (const std::size_t first, const std::size_t end) {
+            typename T::BlockType inBlock = IV, outBlock;
+
+            // counter block for first block in chunk
+            incrementCounter(inBlock, first);
+
+            for (std::size_t i = first; i < end; ++i) {
+                const std::size_t offset = i * B;
+
+                key.encrypt(inBlock, outBlock);
+                incrementCounter(inBlock, 1);
+
+                for (std::size_t j = 0; j < B && j + offset < inText.size(); ++j)
+                    outText[j + offset] = outBlock[j] ^ inText[j + offset];
+            }
+        });
+
+    return outText;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// one-shot modes (key schedule expanded for each call)
+//
+
+template <typename T, typename U>
+std::vector<U> ECB(T dummy,
+                   const typename T::KeyType& key,
+                   const std::vector<U>& inText,
+                   ThreadPool& pool,
+                   const std::size_t chunkOctets = PARALLEL_CHUNK_OCTETS)
+{
+    return ECB(dummy,
+               typename T::KeyContext(key, T::isDecryption()),
+               inText,
+               pool, chunkOctets);
+}
+
+template <typename T, typename U>
+std::vector<U> CBC(T dummy,
+                   const typename T::KeyType& key,
+                   const typename T::BlockType& IV,
+                   const std::vector<U>& inText,
+                   ThreadPool& pool,
+                   const std::size_t chunkOctets = PARALLEL_CHUNK_OCTETS)
+{
+    return CBC(dummy,
+               typename T::KeyContext(key, T::isDecryption()),
+               IV, inText,
+               pool, chunkOctets);
+}
+
+template <typename T, typename U>
+std::vector<U> CFB(T dummy,
+                   const typename T::KeyType& key,
+                   const typename T::BlockType& IV,
+                   const std::vector<U>& inText,
+                   ThreadPool& pool,
+                   const std::size_t chunkOctets = PARALLEL_CHUNK_OCTETS)
+{
+    return CFB(dummy, typename T::KeyContext(key, false), IV, inText,
+               pool, chunkOctets);
+}
+
+template <typename T, typename U>
+std::vector<U> CTR(T dummy,
+                   const typename T::KeyType& key,
+                   const typename T::BlockType& IV,
+                   const std::vector<U>& inText,
+                   ThreadPool& pool,
+                   const std::size_t chunkOctets = PARALLEL_CHUNK_OCTETS)
+{
+    return CTR(dummy, typename T::KeyContext(key, false), IV, inText,
+               pool, chunkOctets);
+}
+
+} // namespace cryptl
+
+#endif
@@ -0,0 +1,198 @@
+#ifndef _CRYPTL_POLY1305_HPP_
+#define _CRYPTL_POLY1305_HPP_
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// Poly1305 (RFC 8439 section 2.5)
+//
+// One-time authenticator. The accumulator and r are held in three limbs of
+// 44, 44 and 42 bits in 64-bit words, products are 128-bit (GCC and Clang
+// unsigned __int128). Partial blocks are buffered between calls to update().
+//
+
+class Poly1305
+{
+public:
+    typedef std::array<std::uint8_t, 32> KeyType;
+    typedef std::array<std::uint8_t, 16> TagType;
+
+    explicit Poly1305(const KeyType& key) {
+        rekey(key);
+    }
+
+    void rekey(const KeyType& key) {
+        const std::uint64_t
+            t0 = load64(key.data()),
+            t1 = load64(key.data() + 8);
+
+        // clamp r
+        m_r[0] = t0 & 0xffc0fffffff;
+        m_r[1] = ((t0 >> 44) | (t1 << 20)) & 0xfffffc0ffff;
+        m_r[2] = (t1 >> 24) & 0x00ffffffc0f;
+
+        m_pad[0] = load64(key.data() + 16);
+        m_pad[1] = load64(key.data() + 24);
+
+        m_h.fill(0);
+        m_bufLength = 0;
+    }
+
+    void update(const std::uint8_t* in, const std::size_t inLength) {
+        const std::size_t B = m_buf.size();
+        std::size_t idx = 0;
+
+        // complete buffered partial block
+        if (m_bufLength > 0) {
+            while (m_bufLength < B && idx < inLength)
+                m_buf[m_bufLength++] = in[idx++];
+
+            if (B == m_bufLength) {
+                blocks(m_buf.data(), B, HIBIT);
+                m_bufLength = 0;
+            }
+        }
+
+        // whole blocks directly from input
+        const std::size_t N = (inLength - idx) / B * B;
+        blocks(in + idx, N, HIBIT);
+        idx += N;
+
+        // buffer remainder
+        while (idx < inLength)
+            m_buf[m_bufLength++] = in[idx++];
+    }
+
+    void update(const std::vector<std::uint8_t>& in) {
+        update(in.data(), in.size());
+    }
+
+    // zero fill to a block boundary (RFC 8439 section 2.8 padding)
+    void padBlock() {
+        if (0 == m_bufLength) return;
+
+        while (m_bufLength < m_buf.size())
+            m_buf[m_bufLength++] = 0;
+
+        blocks(m_buf.data(), m_buf.size(), HIBIT);
+        m_bufLength = 0;
+    }
+
+    void finalize(TagType& tag) {
+        const std::uint64_t M44 = 0xfffffffffff, M42 = 0x3ffffffffff;
+
+        // last partial block has 1 appended instead of the high bit
+        if (m_bufLength > 0) {
+            m_buf[m_bufLength++] = 1;
+            while (m_bufLength < m_buf.size())
+                m_buf[m_bufLength++] = 0;
+
+            blocks(m_buf.data(), m_buf.size(), 0);
+            m_bufLength = 0;
+        }
+
+        std::uint64_t h0 = m_h[0], h1 = m_h[1], h2 = m_h[2], c;
+
+        // fully carry h
+        c = h1 >> 44; h1 &= M44;
+        h2 += c; c = h2 >> 42; h2 &= M42;
+        h0 += c * 5; c = h0 >> 44; h0 &= M44;
+        h1 += c; c = h1 >> 44; h1 &= M44;
+        h2 += c; c = h2 >> 42; h2 &= M42;
+        h0 += c * 5; c = h0 >> 44; h0 &= M44;
+        h1 += c;
+
+        // g = h + 5 - 2^130, select h or g in constant time
+        std::uint64_t g0, g1, g2;
+        g0 = h0 + 5; c = g0 >> 44; g0 &= M44;
+        g1 = h1 + c; c = g1 >> 44; g1 &= M44;
+        g2 = h2 + c - (std::uint64_t(1) << 42);
+
+        c = (g2 >> 63) - 1;
+        g0 &= c; g1 &= c; g2 &= c;
+        c = ~c;
+        h0 = (h0 & c) | g0;
+        h1 = (h1 & c) | g1;
+        h2 = (h2 & c) | g2;
+
+        // h + s mod 2^128
+        const std::uint64_t t0 = m_pad[0], t1 = m_pad[1];
+        h0 += t0 & M44; c = h0 >> 44; h0 &= M44;
+        h1 += (((t0 >> 44) | (t1 << 20)) & M44) + c; c = h1 >> 44; h1 &= M44;
+        h2 += ((t1 >> 24) & M42) + c; h2 &= M42;
+
+        store64(h0 | (h1 << 44), tag.data());
+        store64((h1 >> 20) | (h2 << 24), tag.data() + 8);
+
+        m_h.fill(0);
+    }
+
+private:
+    static const std::uint64_t HIBIT = std::uint64_t(1) << 40;
+
+    static std::uint64_t load64(const std::uint8_t* a) {
+        // written out so the compiler merges it into one load
+        return std::uint64_t(a[0])
+            | (std::uint64_t(a[1]) << 8)
+            | (std::uint64_t(a[2]) << 16)
+            | (std::uint64_t(a[3]) << 24)
+            | (std::uint64_t(a[4]) << 32)
+            | (std::uint64_t(a[5]) << 40)
+            | (std::uint64_t(a[6]) << 48)
+            | (std::uint64_t(a[7]) << 56);
+    }
+
+    static void store64(const std::uint64_t w, std::uint8_t* a) {
+        for (std::size_t j = 0; j < 8; ++j)
+            a[j] = (w >> (8 * j)) & 0xff;
+    }
+
+    // h = (h + m) * r for each 16 octet block
+    void blocks(const std::uint8_t* m, std::size_t len, const std::uint64_t hibit) {
+        typedef unsigned __int128 U128;
+
+        const std::uint64_t M44 = 0xfffffffffff, M42 = 0x3ffffffffff;
+
+        const std::uint64_t r0 = m_r[0], r1 = m_r[1], r2 = m_r[2];
+        const std::uint64_t s1 = r1 * (5 << 2), s2 = r2 * (5 << 2);
+
+        std::uint64_t h0 = m_h[0], h1 = m_h[1], h2 = m_h[2];
+
+        for (; len >= 16; len -= 16, m += 16) {
+            const std::uint64_t t0 = load64(m), t1 = load64(m + 8);
+
+            h0 += t0 & M44;
+            h1 += ((t0 >> 44) | (t1 << 20)) & M44;
+            h2 += ((t1 >> 24) & M42) | hibit;
+
+            const U128 d0 = U128(h0) * r0 + U128(h1) * s2 + U128(h2) * s1;
+            U128 d1 = U128(h0) * r1 + U128(h1) * r0 + U128(h2) * s2;
+            U128 d2 = U128(h0) * r2 + U128(h1) * r1 + U128(h2) * r0;
+
+            // partial reduction, 2^130 = 5
+            std::uint64_t c;
+            c = std::uint64_t(d0 >> 44); h0 = std::uint64_t(d0) & M44;
+            d1 += c; c = std::uint64_t(d1 >> 44); h1 = std::uint64_t(d1) & M44;
+            d2 += c; c = std::uint64_t(d2 >> 42); h2 = std::uint64_t(d2) & M42;
+            h0 += c * 5; c = h0 >> 44; h0 &= M44;
+            h1 += c;
+        }
+
+        m_h[0] = h0;
+        m_h[1] = h1;
+        m_h[2] = h2;
+    }
+
+    std::array<std::uint64_t, 3> m_r, m_h;
+    std::array<std::uint64_t, 2> m_pad;
+    std::array<std::uint8_t, 16> m_buf;
+    std::size_t m_bufLength;
+};
+
+} // namespace cryptl
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef _CRYPTL_SHA_HPP_
 #define _CRYPTL_SHA_HPP_
 
+#include <array>
 #include <cassert>
 #include <climits>
 #include <cstdint>
@@ -99,27 +100,70 @@ public:
         auto* ptr = static_cast<CRTP*>(this);
 
         ptr->initHashValue();
+        hashMessage();
+        ptr->afterHash();
+    }
+
+    // incremental hashing without keeping the whole message:
+    // beginHash(), then msgInput() whole blocks followed by hashBlocks()
+    // any number of times, then endHash() (the last block is padded)
+    void beginHash() {
+        clearMessage();
+        static_cast<CRTP*>(this)->initHashValue();
+    }
+
+    void hashBlocks() {
+#ifdef USE_ASSERT
+        assert(0 == m_message.size() * wordSizeBits() % blockSizeBits());
+#endif
+        hashMessage();
+        clearMessage();
+    }
+
+    void endHash() {
+        hashBlocks();
+        static_cast<CRTP*>(this)->afterHash();
+    }
+
+    // hash one block of 16 words in place of msgInput() and hashBlocks(),
+    // the words are not copied into the message
+    void hashBlock(std::array<MSG, 16>& a) {
+        auto* ptr = static_cast<CRTP*>(this);
+
+        m_block = a.data();
 
         std::size_t msgIndex = 0;
-        while (msgIndex < m_message.size()) {
-            ptr->prepMsgSchedule(msgIndex);
-            ptr->initWorkingVars();
-            ptr->workingLoop();
-            ptr->updateHash();
-        }
+        ptr->prepMsgSchedule(msgIndex);
+        ptr->initWorkingVars();
+        ptr->workingLoop();
+        ptr->updateHash();
 
-        ptr->afterHash();
+        m_block = nullptr;
     }
 
 protected:
-    SHA_Base() = default;
+    SHA_Base()
+        : m_block(nullptr)
+    {}
 
     // note: reference not const so assignment can unbox laziness
     MSG& msgWord(std::size_t& index) {
-        return m_message[index++];
+        return m_block ? m_block[index++] : m_message[index++];
     }
 
 private:
+    void hashMessage() {
+        auto* ptr = static_cast<CRTP*>(this);
+
+        std::size_t msgIndex = 0;
+        while (msgIndex < m_message.size()) {
+            ptr->prepMsgSchedule(msgIndex);
+            ptr->initWorkingVars();
+            ptr->workingLoop();
+            ptr->updateHash();
+        }
+    }
+
     static void append(std::ostream& os,
                        std::size_t& lengthBits,
                        const char c) {
@@ -148,6 +192,9 @@ private:
     }
 
     std::vector<MSG> m_message;
+
+    // block of hashBlock() while it is hashed
+    MSG* m_block;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
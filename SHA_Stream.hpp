@@ -0,0 +1,142 @@
+#ifndef _CRYPTL_SHA_STREAM_HPP_
+#define _CRYPTL_SHA_STREAM_HPP_
+
+#include <array>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+#include <cryptl/SHA_256.hpp>
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// SHA message digest over octet streams
+//
+// Input of any chunk size is hashed one block at a time with hashBlock(),
+// the message is never held in memory and nothing is allocated. A copy
+// of the object is a copy of the hash state, so a common prefix can be
+// hashed once.
+//
+// H is an unmanaged SHA (SHA1, SHA224, SHA256, SHA384, SHA512,...).
+//
+
+template <typename H = SHA256>
+class SHA_Stream
+{
+public:
+    typedef typename H::WordType WordType;
+
+    static const std::size_t WORD_OCTETS = sizeof(WordType);
+    static const std::size_t BLOCK_OCTETS =
+        std::tuple_size<typename H::MsgType>::value * WORD_OCTETS;
+    static const std::size_t DIGEST_OCTETS =
+        std::tuple_size<typename H::DigType>::value
+        * sizeof(typename H::DigType::value_type);
+
+    typedef std::array<std::uint8_t, DIGEST_OCTETS> DigestType;
+
+    SHA_Stream() {
+        init();
+    }
+
+    // start a new message
+    void init() {
+        m_hash.beginHash();
+        m_bufLength = 0;
+        m_length = 0;
+    }
+
+    void update(const std::uint8_t* in, const std::size_t inLength) {
+        std::size_t idx = 0;
+        m_length += inLength;
+
+        // complete buffered partial block
+        if (m_bufLength > 0) {
+            while (m_bufLength < BLOCK_OCTETS && idx < inLength)
+                m_buf[m_bufLength++] = in[idx++];
+
+            if (BLOCK_OCTETS == m_bufLength) {
+                inputBlock(m_buf.data());
+                m_bufLength = 0;
+            }
+        }
+
+        // whole blocks directly from input
+        while (inLength - idx >= BLOCK_OCTETS) {
+            inputBlock(in + idx);
+            idx += BLOCK_OCTETS;
+        }
+
+        // buffer remainder
+        while (idx < inLength)
+            m_buf[m_bufLength++] = in[idx++];
+    }
+
+    void update(const std::vector<std::uint8_t>& in) {
+        update(in.data(), in.size());
+    }
+
+    // pad the final block (FIPS 180-4 5.1) and write the digest, then
+    // ready for the next message
+    void finalize(std::uint8_t* out) {
+        // message length field is two words
+        const std::size_t lengthOctets = 2 * WORD_OCTETS;
+        const std::uint64_t lengthBits = m_length * 8;
+
+        m_buf[m_bufLength++] = 0x80;
+
+        if (m_bufLength > BLOCK_OCTETS - lengthOctets) {
+            while (m_bufLength < BLOCK_OCTETS)
+                m_buf[m_bufLength++] = 0;
+
+            inputBlock(m_buf.data());
+            m_bufLength = 0;
+        }
+
+        while (m_bufLength < BLOCK_OCTETS)
+            m_buf[m_bufLength++] = 0;
+
+        for (std::size_t j = 0; j < 8; ++j)
+            m_buf[BLOCK_OCTETS - 1 - j] = (lengthBits >> (8 * j)) & 0xff;
+
+        inputBlock(m_buf.data());
+        m_hash.endHash();
+
+        std::size_t idx = 0;
+        for (const auto& w : m_hash.digest()) {
+            for (std::size_t j = sizeof(w); j > 0; --j)
+                out[idx++] = (w >> (8 * (j - 1))) & 0xff;
+        }
+
+        init();
+    }
+
+    void finalize(DigestType& out) {
+        finalize(out.data());
+    }
+
+private:
+    // one block of octets as big-endian words
+    void inputBlock(const std::uint8_t* a) {
+        typename H::MsgType msg;
+        for (std::size_t i = 0; i < msg.size(); ++i) {
+            WordType w = 0;
+            for (std::size_t j = 0; j < WORD_OCTETS; ++j)
+                w = (w << 8) | a[i * WORD_OCTETS + j];
+
+            msg[i] = w;
+        }
+
+        m_hash.hashBlock(msg);
+    }
+
+    H m_hash;
+    std::array<std::uint8_t, BLOCK_OCTETS> m_buf;
+    std::size_t m_bufLength;
+    std::uint64_t m_length;
+};
+
+} // namespace cryptl
+
+#endif
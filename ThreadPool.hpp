@@ -0,0 +1,221 @@
+#ifndef _CRYPTL_THREAD_POOL_HPP_
+#define _CRYPTL_THREAD_POOL_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// work stealing thread pool
+//
+// Each worker owns a task queue. Work is dealt round-robin to the queues,
+// owners pop from the back of their own queue and idle workers steal from
+// the front of other queues. The thread calling run() also takes tasks
+// until the whole batch is done, so a pool of N workers applies N + 1
+// threads to a batch.
+//
+// A run() called from inside a task (on any pool thread) calls its
+// functions inline instead of queueing a second batch. The first exception
+// thrown by a task is rethrown from run() once the whole batch is done.
+//
+
+class ThreadPool
+{
+public:
+    explicit ThreadPool(const std::size_t numWorkers = defaultWorkers())
+        : m_stop(false),
+          m_queued(0),
+          m_pending(0)
+    {
+        for (std::size_t i = 0; i < numWorkers; ++i)
+            m_queues.emplace_back(new Queue);
+
+        for (std::size_t i = 0; i < numWorkers; ++i)
+            m_workers.emplace_back([this, i] { workerLoop(i); });
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+
+        m_wakeWorkers.notify_all();
+
+        for (auto& t : m_workers) t.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator= (const ThreadPool&) = delete;
+
+    // number of threads applied to a batch (workers and caller)
+    std::size_t concurrency() const {
+        return m_workers.size() + 1;
+    }
+
+    // calls func(i) for i = 0, 1,..., N - 1 and returns when all are done
+    void run(const std::size_t N,
+             const std::function<void (std::size_t)>& func)
+    {
+        if (0 == N) return;
+
+        if (m_queues.empty() || 1 == N || this == current()) {
+            for (std::size_t i = 0; i < N; ++i) func(i);
+            return;
+        }
+
+        // one batch at a time
+        std::lock_guard<std::mutex> batchLock(m_batchMutex);
+        const CurrentPool onPool(this);
+
+        m_pending = N;
+
+        // counted as queued once visible, so workers never spin on empty
+        // queues while the batch is dealt
+        for (std::size_t i = 0; i < N; ++i) {
+            auto& q = *m_queues[i % m_queues.size()];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            q.tasks.emplace_back([&func, i] { func(i); });
+            ++m_queued;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+        }
+
+        m_wakeWorkers.notify_all();
+
+        // caller steals work too
+        std::function<void ()> task;
+        while (steal(0, task)) runTask(task);
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_batchDone.wait(lock, [this] { return 0 == m_pending; });
+
+        if (m_error) {
+            std::exception_ptr error;
+            error.swap(m_error);
+            std::rethrow_exception(error);
+        }
+    }
+
+    static std::size_t defaultWorkers() {
+        const std::size_t N = std::thread::hardware_concurrency();
+        return N > 1 ? N - 1 : 0;
+    }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void ()>> tasks;
+    };
+
+    // pool of the calling thread while it runs tasks
+    static ThreadPool*& current() {
+        static thread_local ThreadPool* pool = nullptr;
+        return pool;
+    }
+
+    class CurrentPool {
+    public:
+        explicit CurrentPool(ThreadPool* pool)
+            : m_prev(current())
+        {
+            current() = pool;
+        }
+
+        ~CurrentPool() {
+            current() = m_prev;
+        }
+
+    private:
+        ThreadPool* m_prev;
+    };
+
+    bool pop(const std::size_t idx, std::function<void ()>& task) {
+        auto& q = *m_queues[idx];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.tasks.empty()) return false;
+
+        task = std::move(q.tasks.back());
+        q.tasks.pop_back();
+        --m_queued;
+        return true;
+    }
+
+    bool steal(const std::size_t idx, std::function<void ()>& task) {
+        const std::size_t N = m_queues.size();
+
+        for (std::size_t i = 0; i < N; ++i) {
+            auto& q = *m_queues[(idx + i) % N];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (q.tasks.empty()) continue;
+
+            task = std::move(q.tasks.front());
+            q.tasks.pop_front();
+            --m_queued;
+            return true;
+        }
+
+        return false;
+    }
+
+    void runTask(std::function<void ()>& task) {
+        try {
+            task();
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (! m_error) m_error = std::current_exception();
+        }
+
+        if (1 == m_pending--) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_batchDone.notify_all();
+        }
+    }
+
+    void workerLoop(const std::size_t idx) {
+        const CurrentPool onPool(this);
+        std::function<void ()> task;
+
+        while (true) {
+            if (pop(idx, task) || steal(idx + 1, task)) {
+                runTask(task);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (m_stop) return;
+
+            // sleep until there is work or shutdown
+            m_wakeWorkers.wait(lock, [this] {
+                return m_stop || 0 != m_queued;
+            });
+
+            if (m_stop) return;
+        }
+    }
+
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread> m_workers;
+
+    std::mutex m_mutex, m_batchMutex;
+    std::condition_variable m_wakeWorkers, m_batchDone;
+    bool m_stop;
+    std::exception_ptr m_error;
+    std::atomic<std::size_t> m_queued, m_pending;
+};
+
+} // namespace cryptl
+
+#endif
@@ -0,0 +1,213 @@
+#ifndef _CRYPTL_XTS_HPP_
+#define _CRYPTL_XTS_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include <cryptl/ThreadPool.hpp>
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// XTS-AES mode (IEEE Std 1619-2007, NIST SP 800-38E)
+//
+// Each data unit (sector) is encrypted independently with a tweak derived
+// from its sector number, so any sector may be read or written alone. The
+// data key and tweak key are two different AES keys of the same size.
+// A data unit is at least one block. When it is not an even number of
+// blocks, ciphertext stealing keeps the cipher text the same length.
+//
+// T is AES_128 or AES_256 (encryption) or UNAES_128 or UNAES_256
+// (decryption). Key contexts for decryption need the decryption schedule.
+//
+
+// tweak as a 128-bit little-endian integer in two 64-bit words
+typedef std::array<std::uint64_t, 2> XTS_Tweak;
+
+// multiplication by alpha (x) in GF(2^128) mod x^128 + x^7 + x^2 + x + 1
+inline void xtsMulAlpha(XTS_Tweak& t)
+{
+    const std::uint64_t carry = t[1] >> 63;
+    t[1] = (t[1] << 1) | (t[0] >> 63);
+    t[0] = (t[0] << 1) ^ (0x87 & -carry);
+}
+
+// tweaks for consecutive blocks, computed a batch at a time
+template <std::size_t N>
+void xtsTweakBatch(XTS_Tweak& t, std::array<XTS_Tweak, N>& batch)
+{
+    for (auto& a : batch) {
+        a = t;
+        xtsMulAlpha(t);
+    }
+}
+
+template <typename BLK>
+void xtsWhiten(BLK& blk, const XTS_Tweak& t)
+{
+    for (std::size_t j = 0; j < 8; ++j) {
+        blk[j] ^= (t[0] >> (8 * j)) & 0xff;
+        blk[j + 8] ^= (t[1] >> (8 * j)) & 0xff;
+    }
+}
+
+// one block with tweak: out = E(in XOR t) XOR t (or the inverse cipher)
+template <typename T, typename U>
+void xtsBlock(T dummy,
+              const typename T::KeyContext& dataKey,
+              const XTS_Tweak& t,
+              const U* in,
+              U* out)
+{
+    typename T::BlockType inBlock, outBlock;
+    const std::size_t B = inBlock.size();
+
+    for (std::size_t j = 0; j < B; ++j)
+        inBlock[j] = in[j];
+
+    xtsWhiten(inBlock, t);
+
+    if (T::isEncryption())
+        dataKey.encrypt(inBlock, outBlock);
+    else
+        dataKey.decrypt(inBlock, outBlock);
+
+    xtsWhiten(outBlock, t);
+
+    for (std::size_t j = 0; j < B; ++j)
+        out[j] = outBlock[j];
+}
+
+// one data unit of length octets (random access)
+// returns false if the data unit is shorter than a block
+template <typename T, typename U>
+bool XTS(T dummy,
+         const typename T::KeyContext& dataKey,
+         const typename T::KeyContext& tweakKey,
+         const std::uint64_t sectorNumber,
+         const U* in,
+         const std::size_t length,
+         U* out)
+{
+    typename T::BlockType tweakBlock;
+    const std::size_t B = tweakBlock.size();
+    if (length < B) return false;
+
+    // initial tweak is the encrypted sector number (little-endian)
+    for (std::size_t j = 0; j < B; ++j)
+        tweakBlock[j] = j < 8 ? (sectorNumber >> (8 * j)) & 0xff : 0;
+
+    tweakKey.encrypt(tweakBlock, tweakBlock);
+
+    XTS_Tweak t = { 0, 0 };
+    for (std::size_t j = 0; j < 8; ++j) {
+        t[0] |= std::uint64_t(tweakBlock[j]) << (8 * j);
+        t[1] |= std::uint64_t(tweakBlock[j + 8]) << (8 * j);
+    }
+
+    const std::size_t
+        N = length / B,        // whole blocks
+        partial = length % B;  // stolen octets
+
+    // blocks before ciphertext stealing
+    const std::size_t M = partial ? N - 1 : N;
+
+    std::array<XTS_Tweak, 8> batch;
+    for (std::size_t i = 0; i < M; i += batch.size()) {
+        xtsTweakBatch(t, batch);
+
+        for (std::size_t k = 0; k < batch.size() && i + k < M; ++k) {
+            const std::size_t offset = (i + k) * B;
+            xtsBlock(dummy, dataKey, batch[k], in + offset, out + offset);
+        }
+    }
+
+    if (partial) {
+        // tweak for block M is batch[M % 8], back up to it
+        XTS_Tweak tM = M % batch.size() ? batch[M % batch.size()] : t;
+        XTS_Tweak tN = tM;
+        xtsMulAlpha(tN);
+
+        // encryption uses tweak M then N, decryption N then M
+        const XTS_Tweak
+            &first = T::isEncryption() ? tM : tN,
+            &second = T::isEncryption() ? tN : tM;
+
+        const std::size_t offset = M * B;
+        std::array<U, 16> CC, PP;
+
+        xtsBlock(dummy, dataKey, first, in + offset, CC.data());
+
+        for (std::size_t j = 0; j < B; ++j)
+            PP[j] = j < partial ? in[offset + B + j] : CC[j];
+
+        for (std::size_t j = 0; j < partial; ++j)
+            out[offset + B + j] = CC[j];
+
+        xtsBlock(dummy, dataKey, second, PP.data(), out + offset);
+    }
+
+    return true;
+}
+
+// one data unit
+template <typename T, typename U>
+std::vector<U> XTS(T dummy,
+                   const typename T::KeyContext& dataKey,
+                   const typename T::KeyContext& tweakKey,
+                   const std::uint64_t sectorNumber,
+                   const std::vector<U>& inText)
+{
+    std::vector<U> outText(inText.size());
+
+    if (! XTS(dummy, dataKey, tweakKey, sectorNumber,
+              inText.data(), inText.size(), outText.data()))
+        outText.clear();
+
+    return outText;
+}
+
+// consecutive data units of sectorOctets, starting at firstSector
+// the final data unit may be shorter, sectors are processed in parallel
+template <typename T, typename U>
+std::vector<U> XTS(T dummy,
+                   const typename T::KeyContext& dataKey,
+                   const typename T::KeyContext& tweakKey,
+                   const std::uint64_t firstSector,
+                   const std::size_t sectorOctets,
+                   const std::vector<U>& inText,
+                   ThreadPool& pool)
+{
+    std::vector<U> outText(inText.size());
+    if (0 == sectorOctets) return outText;
+
+    const std::size_t numSectors =
+        (inText.size() + sectorOctets - 1) / sectorOctets;
+
+    std::atomic<bool> ok(true);
+
+    pool.run(
+        numSectors,
+        [&] (const std::size_t i) {
+            const std::size_t
+                offset = i * sectorOctets,
+                len = offset + sectorOctets < inText.size()
+                    ? sectorOctets
+                    : inText.size() - offset;
+
+            // only the final data unit can be too short
+            if (! XTS(dummy, dataKey, tweakKey, firstSector + i,
+                      inText.data() + offset, len, outText.data() + offset))
+                ok = false;
+        });
+
+    if (! ok) outText.clear();
+
+    return outText;
+}
+
+} // namespace cryptl
+
+#endif